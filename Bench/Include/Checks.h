@@ -0,0 +1,148 @@
+#pragma once
+
+#include "Mathematics.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cwchar>
+#include <random>
+#include <vector>
+
+// Shared by the files under Source/Checks, each of which times and checks one feature of the header-only libraries.
+// Bench::Kernels runs them in the order of its table.
+
+namespace Dance::Bench::Checks
+{
+    using namespace Dance::Three::Math;
+
+    /// Number of distinct inputs cycled through so that the kernels can't be hoisted out of the timing loop.
+    constexpr size_t INPUTS = 256;
+
+    /// Vectors per call in the batched transform benchmarks.
+    constexpr size_t BATCH = 1024;
+
+    /// Objects per call in the scene transform benchmarks.
+    constexpr size_t OBJECTS = 10000;
+
+    /// What every check is handed.
+    struct Context
+    {
+        /// Number of calls timed for each kernel.
+        size_t Iterations;
+
+        /// INPUTS matrices with random elements between -1 and 1.
+        std::vector<Matrix4F> Matrices;
+    };
+
+    /// Results are folded into this so the compiler can't discard the work.
+    inline volatile float sink = 0.0f;
+
+    /// Fold every element of a matrix into the sink. Reading a single element would let the compiler skip computing
+    /// the rest of a scalar result, which flatters the scalar path.
+    inline void Consume(const Matrix4F& matrix)
+    {
+        float sum = 0.0f;
+        for (const auto& row : matrix.value)
+        {
+            for (float element : row)
+            {
+                sum += element;
+            }
+        }
+        sink += sum;
+    }
+
+    /// Nanoseconds per call of a kernel.
+    template<typename F>
+    inline double Measure(size_t iterations, F&& kernel)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            kernel(i);
+        }
+        const auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+    }
+
+    /// Print the largest difference between a kernel and the code it mirrors, flagging it if over the bound.
+    inline void Check(const wchar_t* label, double error, double bound = 1e-4)
+    {
+        std::wprintf(L"  %-24ls %10.2e%ls\n", label, error, error < bound ? L"" : L"  MISMATCH");
+    }
+
+    /// Print one row of a comparison table.
+    inline void Row(const wchar_t* label, double baseline, double optimized)
+    {
+        std::wprintf(L"  %-24ls %10.2f %10.2f %8.2fx\n", label, baseline, optimized, baseline / optimized);
+    }
+
+    /// Largest component difference between two vectors.
+    inline float Difference(const Vector3F& a, const Vector3F& b)
+    {
+        return std::max({ std::fabs(a.x - b.x), std::fabs(a.y - b.y), std::fabs(a.z - b.z) });
+    }
+
+    /// Largest component difference between two quaternions.
+    inline float Difference(const QuaternionF& a, const QuaternionF& b)
+    {
+        return std::max({ std::fabs(a.x - b.x), std::fabs(a.y - b.y), std::fabs(a.z - b.z), std::fabs(a.w - b.w) });
+    }
+
+    /// Largest element difference between two matrices, relative to the expected element where that's over one.
+    inline float Difference(const Matrix4F& actual, const Matrix4F& expected)
+    {
+        float error = 0.0f;
+        for (int row = 0; row < 4; ++row)
+        {
+            for (int column = 0; column < 4; ++column)
+            {
+                const float scale = std::max(1.0f, std::fabs(expected.value[row][column]));
+                error = std::max(error, std::fabs(actual.value[row][column] - expected.value[row][column]) / scale);
+            }
+        }
+        return error;
+    }
+
+    /// The cube visualizer's camera, which sees roughly half of what Scatter places around it.
+    inline FrustumF View()
+    {
+        return FrustumF(Matrix4F::Translation(500.0f, 0.0f, 0.0f)
+            * Matrix4F::YRotation(-PiOver2)
+            * Matrix4F::ZRotation(-PiOver2)
+            * Matrix4F::Perspective(ToRadians(70.0f), 1920.0f, 1080.0f, 25.0f, 10000.0f));
+    }
+
+    /// Boxes scattered around the camera of View, the same ones every call.
+    inline std::vector<AABBF> Scatter()
+    {
+        std::mt19937 random(0);
+        std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+        std::vector<AABBF> boxes(OBJECTS);
+        for (AABBF& box : boxes)
+        {
+            const Vector3F center(4000.0f * uniform(random), 4000.0f * uniform(random), 4000.0f * uniform(random));
+            const Vector3F extent(50.0f + 50.0f * uniform(random), 50.0f + 50.0f * uniform(random), 50.0f + 50.0f * uniform(random));
+            box = AABBF::FromCenter(center, extent);
+        }
+        return boxes;
+    }
+
+    void Matrix(Context& context);
+    void Batch(Context& context);
+    void FastMath(Context& context);
+    void Bounds(Context& context);
+    void Instancing(Context& context);
+    void Packing(Context& context);
+    void UploadRing(Context& context);
+    void Commands(Context& context);
+    void MeshOptimizer(Context& context);
+    void Procedural(Context& context);
+    void Rasterizer(Context& context);
+    void Canvas(Context& context);
+    void Hierarchy(Context& context);
+    void Noise(Context& context);
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Dance::Bench
+{
+    /// Time the vectorized math kernels against the scalar implementations they replace and print a table of
+    /// nanoseconds per call. Only uses the standard library and the header-only math, so it doesn't need a device.
+    ///
+    /// @param iterations is the number of calls timed for each kernel.
+    void Kernels(size_t iterations);
+}
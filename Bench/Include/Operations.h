@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Dance::Bench
+{
+    /// Time the everyday operations of the header-only math types over arrays, once small enough to stay in cache and
+    /// once large enough that every pass streams from memory, and print nanoseconds per element for each. Like
+    /// Kernels, this only uses the standard library and the math headers, so it builds with GCC and Clang too.
+    ///
+    /// @param budget is roughly the number of elements processed per measurement.
+    void Operations(size_t budget);
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace Dance::Bench
+{
+    /// Per-frame measurements for a single visualizer.
+    struct Sample
+    {
+        /// Seconds spent in Visualizer::Update.
+        double Update;
+
+        /// Seconds spent in Visualizer::Render, including the present.
+        double Render;
+
+        /// Heap allocations made from the CRT heap during the frame, by the plugin as well as the runtime.
+        uint64_t Allocations;
+
+        /// Bytes requested by those allocations.
+        uint64_t Bytes;
+    };
+
+    /// Collects frame samples and summarizes them as percentiles.
+    class Report
+    {
+    public:
+        /// Preallocate room for the frames we'll record so that recording doesn't show up in the allocation counts.
+        ///
+        /// @param frames is the number of frames that will be recorded.
+        explicit Report(size_t frames)
+        {
+            this->samples.reserve(frames);
+        }
+
+        /// Record the measurements for a frame.
+        ///
+        /// @param sample contains the frame's timings and allocations.
+        void Record(const Sample& sample)
+        {
+            this->samples.push_back(sample);
+        }
+
+        /// Print a summary table row for each of update, render, and the total frame time in milliseconds, followed by
+        /// the allocation counts.
+        ///
+        /// @param name is the name of the visualizer.
+        void Print(const std::wstring& name) const
+        {
+            std::vector<double> update, render, total;
+            uint64_t allocations = 0;
+            uint64_t bytes = 0;
+            for (const Sample& sample : this->samples)
+            {
+                update.push_back(sample.Update * 1000.0);
+                render.push_back(sample.Render * 1000.0);
+                total.push_back((sample.Update + sample.Render) * 1000.0);
+                allocations += sample.Allocations;
+                bytes += sample.Bytes;
+            }
+
+            std::wprintf(L"%ls (%zu frames)\n", name.c_str(), this->samples.size());
+            std::wprintf(L"  %-8ls %9ls %9ls %9ls %9ls %9ls\n", L"ms", L"mean", L"p50", L"p90", L"p99", L"max");
+            Report::Row(L"update", update);
+            Report::Row(L"render", render);
+            Report::Row(L"frame", total);
+
+            if (!this->samples.empty())
+            {
+                std::wprintf(
+                    L"  allocations: %llu (%.2f per frame, %.0f bytes per frame)\n",
+                    static_cast<unsigned long long>(allocations),
+                    static_cast<double>(allocations) / this->samples.size(),
+                    static_cast<double>(bytes) / this->samples.size());
+            }
+        }
+
+    private:
+        std::vector<Sample> samples;
+
+        /// Nearest-rank percentile of sorted values.
+        static double Percentile(const std::vector<double>& sorted, double p)
+        {
+            if (sorted.empty())
+            {
+                return 0.0;
+            }
+
+            const size_t rank = static_cast<size_t>(p * sorted.size());
+            return sorted[std::min(rank, sorted.size() - 1)];
+        }
+
+        /// Print one row of the summary table.
+        static void Row(const wchar_t* label, std::vector<double> values)
+        {
+            std::sort(values.begin(), values.end());
+            double sum = 0.0;
+            for (double value : values)
+            {
+                sum += value;
+            }
+
+            std::wprintf(
+                L"  %-8ls %9.3f %9.3f %9.3f %9.3f %9.3f\n",
+                label,
+                values.empty() ? 0.0 : sum / values.size(),
+                Report::Percentile(values, 0.5),
+                Report::Percentile(values, 0.9),
+                Report::Percentile(values, 0.99),
+                values.empty() ? 0.0 : values.back());
+        }
+    };
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace Dance::Bench
+{
+    /// A looping source of interleaved stereo float audio that stands in for loopback capture. The whole loop is
+    /// prepared up front so that reading from it during a benchmark never allocates.
+    class Signal
+    {
+    public:
+        /// Synthesize a few seconds of audio with some structure for the visualizers to respond to: a bass tone pulsing
+        /// at 120 BPM, a sine sweep across the audible range, and a little noise.
+        ///
+        /// @param sampleRate is the number of frames per second to synthesize.
+        explicit Signal(uint32_t sampleRate);
+
+        /// Load a recording from a WAV file. Supports 16-bit PCM and 32-bit float, mono or stereo.
+        ///
+        /// @param recording is the path of the WAV file.
+        /// @throws std::runtime_error if the file can't be read or its format isn't supported.
+        explicit Signal(const std::filesystem::path& recording);
+
+        /// Get the sample rate of the signal.
+        ///
+        /// @returns the number of frames per second.
+        uint32_t SampleRate() const;
+
+        /// Advance the signal, wrapping around at the end of the loop.
+        ///
+        /// @param frames is pointed at the next count contiguous stereo frames, valid until the next call.
+        /// @param count is the number of frames to read, which should not exceed what was reserved.
+        /// @returns the number of frames read.
+        size_t Read(const float*& frames, size_t count);
+
+        /// Reserve room so that reads of up to count frames don't allocate.
+        ///
+        /// @param count is the largest number of frames that will be read at once.
+        void Reserve(size_t count);
+
+    private:
+        /// Frames per second.
+        uint32_t sampleRate;
+
+        /// The whole loop as interleaved stereo samples.
+        std::vector<float> samples;
+
+        /// Contiguous output for reads that wrap around the end of the loop.
+        std::vector<float> scratch;
+
+        /// Index of the next frame to read.
+        size_t position{ 0 };
+    };
+}
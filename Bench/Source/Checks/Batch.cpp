@@ -0,0 +1,133 @@
+#include "Checks.h"
+#include "Batch.h"
+
+#include <random>
+
+namespace Dance::Bench::Checks
+{
+	/// The structure-of-arrays kernels against the same operation on each element, and against it in time.
+	void Batch(Context& context)
+	{
+		const size_t iterations = context.Iterations;
+		const std::vector<Matrix4F>& matrices = context.Matrices;
+		std::mt19937 random(0);
+		std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+
+		// Structure-of-arrays batches; an odd count exercises every lane width and the scalar tail
+		const size_t count = BATCH + 3;
+		Vector3ArrayF soaPoints(count);
+		Vector3ArrayF soaOthers(count);
+		QuaternionArrayF soaFrom(count);
+		QuaternionArrayF soaTo(count);
+		std::vector<Vector3F> aosPoints(count);
+		std::vector<QuaternionF> aosFrom(count);
+		std::vector<QuaternionF> aosTo(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			aosPoints[i] = Vector3F(uniform(random), uniform(random), uniform(random));
+			aosFrom[i] = QuaternionF(Vector3F(uniform(random), uniform(random), uniform(random)).Normalized(), uniform(random) * Pi);
+			aosTo[i] = QuaternionF(Vector3F(uniform(random), uniform(random), uniform(random)).Normalized(), uniform(random) * Pi);
+			soaPoints.Set(i, aosPoints[i]);
+			soaOthers.Set(i, Vector3F(uniform(random), uniform(random), uniform(random)));
+			soaFrom.Set(i, aosFrom[i]);
+			soaTo.Set(i, aosTo[i]);
+		}
+
+		Vector3ArrayF soaResult;
+		QuaternionArrayF soaBlend;
+		float error = 0.0f;
+
+		std::wprintf(L"  %-24ls %10ls\n", L"batch vs scalar", L"max error");
+		Transform(matrices[0], soaPoints, soaResult);
+		for (size_t i = 0; i < count; ++i)
+		{
+			error = std::max(error, Difference(soaResult.Get(i), Transform(matrices[0], aosPoints[i])));
+		}
+		Check(L"Transform", error);
+
+		error = 0.0f;
+		soaResult = soaPoints;
+		Normalize(soaResult);
+		for (size_t i = 0; i < count; ++i)
+		{
+			error = std::max(error, Difference(soaResult.Get(i), aosPoints[i].Normalized()));
+		}
+		Check(L"Normalize", error);
+
+		error = 0.0f;
+		Cross(soaPoints, soaOthers, soaResult);
+		for (size_t i = 0; i < count; ++i)
+		{
+			error = std::max(error, Difference(soaResult.Get(i), Cross(soaPoints.Get(i), soaOthers.Get(i))));
+		}
+		Check(L"Cross", error);
+
+		error = 0.0f;
+		Rotate(soaFrom, soaPoints, soaResult);
+		for (size_t i = 0; i < count; ++i)
+		{
+			error = std::max(error, Difference(soaResult.Get(i), Transform(Matrix4F::From(aosFrom[i]), aosPoints[i])));
+		}
+		Check(L"Rotate", error);
+
+		error = 0.0f;
+		Slerp(soaFrom, soaTo, 0.3f, soaBlend);
+		for (size_t i = 0; i < count; ++i)
+		{
+			error = std::max(error, Difference(soaBlend.Get(i), Slerp(aosFrom[i], aosTo[i], 0.3f)));
+		}
+		Check(L"Slerp", error);
+
+		error = 0.0f;
+		Nlerp(soaFrom, soaTo, 0.3f, soaBlend);
+		for (size_t i = 0; i < count; ++i)
+		{
+			const QuaternionF& a = aosFrom[i];
+			const QuaternionF& b = Dot(a, aosTo[i]) < 0.0f
+				? QuaternionF(-aosTo[i].x, -aosTo[i].y, -aosTo[i].z, -aosTo[i].w)
+				: aosTo[i];
+			const QuaternionF expected = QuaternionF(
+				a.x + 0.3f * (b.x - a.x),
+				a.y + 0.3f * (b.y - a.y),
+				a.z + 0.3f * (b.z - a.z),
+				a.w + 0.3f * (b.w - a.w)).Normalized();
+			error = std::max(error, Difference(soaBlend.Get(i), expected));
+		}
+		Check(L"Nlerp", error);
+
+		const size_t sweeps = iterations / count + 1;
+		std::vector<Vector3F> moved(BATCH);
+		Row(
+			L"Transform AoS vs SoA",
+			Measure(sweeps, [&](size_t i)
+			{
+				const Matrix4F& matrix = matrices[i % INPUTS];
+				for (size_t j = 0; j < count; ++j)
+				{
+					moved[j % BATCH] = Transform(matrix, aosPoints[j]);
+				}
+				sink += moved[0].x;
+			}),
+			Measure(sweeps, [&](size_t i)
+			{
+				Transform(matrices[i % INPUTS], soaPoints, soaResult);
+				sink += soaResult.x[0];
+			}));
+
+		Row(
+			L"Rotate AoS vs SoA",
+			Measure(sweeps, [&](size_t)
+			{
+				for (size_t j = 0; j < count; ++j)
+				{
+					moved[j % BATCH] = TransformationF(Vector3F(), aosFrom[j], 1.0f).Rotate(aosPoints[j]);
+				}
+				sink += moved[0].x;
+			}),
+			Measure(sweeps, [&](size_t)
+			{
+				Rotate(soaFrom, soaPoints, soaResult);
+				sink += soaResult.x[0];
+			}));
+	}
+}
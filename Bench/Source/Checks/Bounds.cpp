@@ -0,0 +1,84 @@
+#include "Checks.h"
+#include "Batch.h"
+
+namespace Dance::Bench::Checks
+{
+	/// Culling structure-of-arrays bounds against testing each against the frustum.
+	void Bounds(Context& context)
+	{
+		const size_t scenes = context.Iterations / OBJECTS + 1;
+
+		// Frustum culling of bounds scattered around the cube visualizer's camera, roughly half of them in view
+		const FrustumF frustum = View();
+		const std::vector<AABBF> scattered = Scatter();
+		SphereArrayF spheres(OBJECTS);
+		AABBArrayF boxes(OBJECTS);
+		for (size_t i = 0; i < OBJECTS; ++i)
+		{
+			boxes.Set(i, scattered[i]);
+			spheres.Set(i, SphereF::From(scattered[i]));
+		}
+
+		std::vector<uint32_t> visible;
+		std::vector<uint32_t> expected;
+		std::wprintf(L"  %-24ls %10ls\n", L"cull vs scalar", L"mismatch");
+		for (size_t i = 0; i < OBJECTS; ++i)
+		{
+			if (frustum.Intersects(spheres.Get(i)))
+			{
+				expected.push_back(static_cast<uint32_t>(i));
+			}
+		}
+		Cull(frustum, spheres, visible);
+		Check(L"Cull spheres (indices)", visible == expected ? 0.0 : 1.0);
+
+		expected.clear();
+		for (size_t i = 0; i < OBJECTS; ++i)
+		{
+			if (frustum.Intersects(boxes.Get(i)))
+			{
+				expected.push_back(static_cast<uint32_t>(i));
+			}
+		}
+		Cull(frustum, boxes, visible);
+		Check(L"Cull boxes (indices)", visible == expected ? 0.0 : 1.0);
+
+		Row(
+			L"Cull spheres x10k",
+			Measure(scenes, [&](size_t)
+			{
+				expected.clear();
+				for (size_t i = 0; i < OBJECTS; ++i)
+				{
+					if (frustum.Intersects(spheres.Get(i)))
+					{
+						expected.push_back(static_cast<uint32_t>(i));
+					}
+				}
+				sink += static_cast<float>(expected.size());
+			}),
+			Measure(scenes, [&](size_t)
+			{
+				sink += static_cast<float>(Cull(frustum, spheres, visible));
+			}));
+
+		Row(
+			L"Cull boxes x10k",
+			Measure(scenes, [&](size_t)
+			{
+				expected.clear();
+				for (size_t i = 0; i < OBJECTS; ++i)
+				{
+					if (frustum.Intersects(boxes.Get(i)))
+					{
+						expected.push_back(static_cast<uint32_t>(i));
+					}
+				}
+				sink += static_cast<float>(expected.size());
+			}),
+			Measure(scenes, [&](size_t)
+			{
+				sink += static_cast<float>(Cull(frustum, boxes, visible));
+			}));
+	}
+}
@@ -0,0 +1,135 @@
+#include "Checks.h"
+#include "CpuCanvas.h"
+
+namespace Dance::Bench::Checks
+{
+	/// The CPU implementation of the 2D canvas.
+	void Canvas(Context& context)
+	{
+		const size_t frames = std::max<size_t>(context.Iterations / 1000, 5);
+		constexpr uint32_t WIDTH = 250;
+		constexpr uint32_t HEIGHT = 190;
+
+		// The 2D canvas. Whole pixel rectangles are exact, a disc's coverage adds up to its area, the fill rules differ
+		// only where contours overlap, a gradient lands on every pixel's center, and a stroke covers its overlapping
+		// segments and joins once
+		using Dance::Two::CpuCanvas;
+		using Dance::Two::Figure;
+		using Dance::Two::FillRule;
+		using Dance::Two::Paint;
+		using Dance::Two::Surface;
+		constexpr Dance::Two::Color CLEAR = { 0.0f, 0.0f, 0.0f, 0.0f };
+		constexpr Dance::Two::Color OPAQUE = { 1.0f, 1.0f, 1.0f, 1.0f };
+		Surface surface(WIDTH, HEIGHT);
+		CpuCanvas canvas(surface);
+		const auto alpha = [&]()
+		{
+			double total = 0.0;
+			for (size_t i = 0; i < static_cast<size_t>(WIDTH) * HEIGHT; ++i)
+			{
+				total += (surface.Pixels()[i] >> 24) / 255.0;
+			}
+			return total;
+		};
+
+		canvas.Clear(CLEAR);
+		canvas.FillRectangle({ 10.0f, 20.0f, 40.0f, 60.0f }, Paint::Solid(OPAQUE));
+		bool painted = alpha() == 30.0 * 40.0 && surface.Pixel(10, 20) == 0xFFFFFFFFu && surface.Pixel(39, 59) == 0xFFFFFFFFu;
+
+		const auto circle = [](Figure& figure, float x, float y, float r)
+		{
+			// Four cubic arcs, with control points this far along the tangents, stay within 0.03% of a circle
+			const float k = 0.5522847f * r;
+			figure.MoveTo({ x + r, y })
+				.BezierTo({ x + r, y + k }, { x + k, y + r }, { x, y + r })
+				.BezierTo({ x - k, y + r }, { x - r, y + k }, { x - r, y })
+				.BezierTo({ x - r, y - k }, { x - k, y - r }, { x, y - r })
+				.BezierTo({ x + k, y - r }, { x + r, y - k }, { x + r, y })
+				.Close();
+		};
+		Figure round;
+		circle(round, 125.3f, 95.7f, 50.0f);
+		canvas.Clear(CLEAR);
+		canvas.FillFigure(round, Paint::Solid(OPAQUE));
+		painted = painted && std::fabs(alpha() / (Pi * 50.0 * 50.0) - 1.0) < 0.005;
+
+		Figure evenOdd;
+		Figure nonZero(FillRule::NonZero);
+		for (Figure* figure : { &evenOdd, &nonZero })
+		{
+			circle(*figure, 125.0f, 95.0f, 80.0f);
+			circle(*figure, 125.0f, 95.0f, 40.0f);
+		}
+		canvas.Clear(CLEAR);
+		canvas.FillFigure(evenOdd, Paint::Solid(OPAQUE));
+		painted = painted && surface.Pixel(125, 95) == 0 && surface.Pixel(125, 35) == 0xFFFFFFFFu;
+		canvas.Clear(CLEAR);
+		canvas.FillFigure(nonZero, Paint::Solid(OPAQUE));
+		painted = painted && surface.Pixel(125, 95) == 0xFFFFFFFFu && surface.Pixel(125, 35) == 0xFFFFFFFFu;
+
+		canvas.Clear(CLEAR);
+		canvas.FillRectangle(
+			{ 0.0f, 0.0f, static_cast<float>(WIDTH), static_cast<float>(HEIGHT) },
+			Paint::Linear({ 0.0f, 0.0f }, { static_cast<float>(WIDTH), 0.0f }, { { 1.0f, OPAQUE }, { 0.0f, { 0.0f, 0.0f, 0.0f, 1.0f } } }));
+		for (uint32_t x = 0; x < WIDTH; ++x)
+		{
+			const double expected = (x + 0.5) / WIDTH * 255.0;
+			painted = painted && std::fabs((surface.Pixel(x, HEIGHT / 2) & 0xFF) - expected) <= 1.0 && surface.Pixel(x, 0) == surface.Pixel(x, HEIGHT - 1);
+		}
+
+		Figure zigzag;
+		zigzag.MoveTo({ 10.0f, 40.0f });
+		for (size_t i = 1; i < 12; ++i)
+		{
+			zigzag.LineTo({ 10.0f + 20.0f * i, i % 2 ? 150.0f : 40.0f });
+		}
+		canvas.Clear(CLEAR);
+		canvas.DrawFigure(zigzag, Paint::Solid({ 1.0f, 1.0f, 1.0f, 0.5f }), 6.0f);
+		painted = painted && surface.Pixel(30, 147) == 0x80808080u && surface.Pixel(50, 42) == 0x80808080u
+			&& std::all_of(surface.Pixels(), surface.Pixels() + WIDTH * HEIGHT, [](uint32_t pixel) { return (pixel >> 24) <= 0x80; });
+		Check(L"2D canvas (coverage)", painted ? 0.0 : 1.0);
+
+		// A frame like Bars draws, over a gradient and under the waveform, at a typical window size
+		constexpr uint32_t FRAME_WIDTH = 1280;
+		constexpr uint32_t FRAME_HEIGHT = 720;
+		constexpr size_t BARS = FRAME_WIDTH / 40;
+		Surface window(FRAME_WIDTH, FRAME_HEIGHT);
+		CpuCanvas painter(window);
+		const Paint background = Paint::Linear(
+			{ 0.0f, 0.0f },
+			{ 0.0f, static_cast<float>(FRAME_HEIGHT) },
+			{ { 0.0f, { 0.1f, 0.1f, 0.2f, 1.0f } }, { 1.0f, { 0.0f, 0.0f, 0.0f, 1.0f } } });
+		Figure waveform;
+		for (size_t i = 0; i < 512; ++i)
+		{
+			const float x = static_cast<float>(i) * FRAME_WIDTH / 511.0f;
+			waveform.LineTo({ x, FRAME_HEIGHT * (0.5f + 0.25f * std::sin(x * 0.05f) * std::cos(x * 0.003f)) });
+		}
+		const auto bars = [&](bool gradient, bool line)
+		{
+			painter.Begin();
+			painter.Clear(CLEAR);
+			if (gradient)
+			{
+				painter.FillRectangle({ 0.0f, 0.0f, static_cast<float>(FRAME_WIDTH), static_cast<float>(FRAME_HEIGHT) }, background);
+			}
+			for (size_t i = 0; i < BARS; ++i)
+			{
+				const float level = 0.5f + 0.45f * std::sin(static_cast<float>(i) * 0.7f);
+				const float left = std::round(static_cast<float>(i) * FRAME_WIDTH / BARS);
+				const float right = std::round(static_cast<float>(i + 1) * FRAME_WIDTH / BARS);
+				painter.FillRectangle({ left, FRAME_HEIGHT * (1.0f - level), right, static_cast<float>(FRAME_HEIGHT) }, Paint::Solid({ level, 1.0f - level, 0.5f, 1.0f }));
+			}
+			if (line)
+			{
+				painter.DrawFigure(waveform, Paint::Solid(OPAQUE), 2.0f);
+			}
+			painter.End();
+			sink += static_cast<float>(window.Pixel(FRAME_WIDTH / 2, FRAME_HEIGHT / 2) & 0xFF);
+		};
+
+		std::wprintf(L"  %-24ls %10ls\n", L"us per 2D frame", L"cpu canvas");
+		std::wprintf(L"  %-24ls %10.2f\n", L"Bars", Measure(frames, [&](size_t) { bars(false, false); }) / 1e3);
+		std::wprintf(L"  %-24ls %10.2f\n", L"Bars, gradient, waveform", Measure(frames, [&](size_t) { bars(true, true); }) / 1e3);
+	}
+}
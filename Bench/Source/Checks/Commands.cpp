@@ -0,0 +1,101 @@
+#include "Checks.h"
+#include "Commands.h"
+
+#include <random>
+
+namespace Dance::Bench::Checks
+{
+	/// Stands in for the device context under a command buffer, tracking what's bound and checking every draw against
+	/// the state its packet asked for.
+	struct StateRecorder
+	{
+		uint32_t shader;
+		uint32_t mesh;
+		bool matched;
+		std::vector<uint32_t> drawn;
+
+		void BindShader(uint32_t shader)
+		{
+			this->shader = shader;
+		}
+
+		void BindMesh(uint32_t mesh)
+		{
+			this->mesh = mesh;
+		}
+
+		void Draw(const Dance::Three::Graphics::DrawPacket& packet)
+		{
+			this->matched = this->matched && packet.Shader == this->shader && packet.Mesh == this->mesh;
+			this->drawn.push_back(packet.Object);
+		}
+	};
+
+	/// Sorting and submitting a command buffer against a stable sort of its packets.
+	void Commands(Context& context)
+	{
+		const size_t scenes = context.Iterations / OBJECTS + 1;
+		std::mt19937 random(0);
+		std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+
+		// A frame's draws spread over 8 shaders and 64 meshes at random depths, recorded out of order. Sorted, they
+		// should come out in the same order as a stable sort by key, and submitted, every draw should see the state it
+		// asked for with no more binds than there are runs of each
+		using Dance::Three::Graphics::DrawPacket;
+		Dance::Three::Graphics::CommandBuffer commands;
+		commands.Reserve(OBJECTS);
+		std::vector<DrawPacket> packets(OBJECTS);
+		for (uint32_t i = 0; i < OBJECTS; ++i)
+		{
+			const uint32_t shader = static_cast<uint32_t>(random() % 8);
+			const uint32_t mesh = static_cast<uint32_t>(random() % 64);
+			const float depth = 25.0f + 10000.0f * std::fabs(uniform(random));
+			packets[i] = DrawPacket{ Dance::Three::Graphics::SortKey::Make(shader, mesh, depth), shader, mesh, i };
+			commands.Add(packets[i]);
+		}
+
+		std::vector<DrawPacket> ordered(packets);
+		std::stable_sort(ordered.begin(), ordered.end(), [](const DrawPacket& a, const DrawPacket& b)
+		{
+			return a.Key < b.Key;
+		});
+		commands.Sort();
+		StateRecorder state{ 0, 0, true, {} };
+		const auto submitted = commands.Submit(state);
+
+		size_t runs = 0;
+		for (size_t i = 0; i < ordered.size(); ++i)
+		{
+			runs += i == 0 || ordered[i].Shader != ordered[i - 1].Shader || ordered[i].Mesh != ordered[i - 1].Mesh;
+		}
+		bool sorted = state.matched && submitted.Draws == OBJECTS && submitted.MeshBinds == runs && submitted.ShaderBinds == 8
+			&& submitted.Elided == 2 * OBJECTS - submitted.ShaderBinds - submitted.MeshBinds;
+		for (size_t i = 0; sorted && i < OBJECTS; ++i)
+		{
+			sorted = state.drawn[i] == ordered[i].Object;
+		}
+		Check(L"Commands (order, binds)", sorted ? 0.0 : 1.0);
+
+		Row(
+			L"Sort packets x10k",
+			Measure(scenes, [&](size_t)
+			{
+				ordered = packets;
+				std::sort(ordered.begin(), ordered.end(), [](const DrawPacket& a, const DrawPacket& b)
+				{
+					return a.Key < b.Key;
+				});
+				sink += static_cast<float>(ordered[0].Object);
+			}),
+			Measure(scenes, [&](size_t)
+			{
+				commands.Clear();
+				for (const DrawPacket& packet : packets)
+				{
+					commands.Add(packet);
+				}
+				commands.Sort();
+				sink += static_cast<float>(commands.Packets()[0].Object);
+			}));
+	}
+}
@@ -0,0 +1,151 @@
+#include "Checks.h"
+#include "FastMath.h"
+
+#include <random>
+
+namespace Dance::Bench::Checks
+{
+	/// Run a lane function over every element of an array, as wide as the build allows.
+	template<typename F>
+	static void Apply(const std::vector<float>& in, std::vector<float>& out, F&& function)
+	{
+		Simd::Sweep(in.size(), [&](auto lane, size_t i)
+		{
+			using L = decltype(lane);
+			function(L::Load(&in[i])).Store(&out[i]);
+		});
+	}
+
+	/// Largest difference between an approximation evaluated in lanes and the double precision reference, relative
+	/// to the reference where that is larger than floor.
+	template<typename F, typename R>
+	static double Error(const std::vector<float>& in, F&& function, R&& reference, double floor)
+	{
+		std::vector<float> out(in.size());
+		Apply(in, out, function);
+
+		double error = 0.0;
+		for (size_t i = 0; i < in.size(); ++i)
+		{
+			const double expected = reference(static_cast<double>(in[i]));
+			error = std::max(error, std::fabs(out[i] - expected) / std::max(std::fabs(expected), floor));
+		}
+		return error;
+	}
+
+	/// The approximations in FastMath.h against the standard library.
+	void FastMath(Context& context)
+	{
+		const size_t iterations = context.Iterations;
+		const size_t batches = iterations / BATCH + 1;
+
+		// Fast math against the standard library evaluated in double. The sweeps cover every lane width since the
+		// counts are odd; angles span the range the rotations see, the logarithm covers most of the normal range
+		const size_t samples = 100003;
+		std::vector<float> angleSamples(samples);
+		std::vector<float> exponentSamples(samples);
+		std::vector<float> logarithmSamples(samples);
+		for (size_t i = 0; i < samples; ++i)
+		{
+			const float t = static_cast<float>(i) / (samples - 1);
+			angleSamples[i] = -100.0f + 200.0f * t;
+			exponentSamples[i] = -87.0f + 175.0f * t;
+			logarithmSamples[i] = std::exp2(-120.0f + 240.0f * t);
+		}
+
+		std::wprintf(L"  %-24ls %10ls\n", L"fast vs std", L"max error");
+		Check(
+			L"Sin (absolute)",
+			Error(angleSamples, [](auto x) { return Fast::Sin(x); }, [](double x) { return std::sin(x); }, 1.0),
+			1e-6);
+		Check(
+			L"Cos (absolute)",
+			Error(angleSamples, [](auto x) { return Fast::Cos(x); }, [](double x) { return std::cos(x); }, 1.0),
+			1e-6);
+
+		float error = 0.0f;
+		for (float angle : angleSamples)
+		{
+			float sine, cosine;
+			Fast::SinCos(angle, sine, cosine);
+			error = std::max(error, static_cast<float>(std::fabs(sine - std::sin(static_cast<double>(angle)))));
+			error = std::max(error, static_cast<float>(std::fabs(cosine - std::cos(static_cast<double>(angle)))));
+		}
+		Check(L"SinCos scalar (absolute)", error, 1e-6);
+		Check(
+			L"Exp (relative)",
+			Error(exponentSamples, [](auto x) { return Fast::Exp(x); }, [](double x) { return std::exp(x); }, 0.0),
+			1e-6);
+		Check(
+			L"Log (relative)",
+			Error(logarithmSamples, [](auto x) { return Fast::Log(x); }, [](double x) { return std::log(x); }, 1.0),
+			1e-6);
+
+		std::vector<float> results(BATCH);
+		const std::vector<float> angleBatch(angleSamples.begin(), angleSamples.begin() + BATCH);
+		const std::vector<float> logarithmBatch(logarithmSamples.begin(), logarithmSamples.begin() + BATCH);
+		Row(
+			L"Sin std vs fast x1024",
+			Measure(batches, [&](size_t)
+			{
+				for (size_t j = 0; j < BATCH; ++j)
+				{
+					results[j] = std::sin(angleBatch[j]);
+				}
+				sink += results[BATCH - 1];
+			}),
+			Measure(batches, [&](size_t)
+			{
+				Apply(angleBatch, results, [](auto x) { return Fast::Sin(x); });
+				sink += results[BATCH - 1];
+			}));
+
+		Row(
+			L"Exp std vs fast x1024",
+			Measure(batches, [&](size_t)
+			{
+				for (size_t j = 0; j < BATCH; ++j)
+				{
+					results[j] = std::exp(angleBatch[j]);
+				}
+				sink += results[BATCH - 1];
+			}),
+			Measure(batches, [&](size_t)
+			{
+				Apply(angleBatch, results, [](auto x) { return Fast::Exp(x); });
+				sink += results[BATCH - 1];
+			}));
+
+		Row(
+			L"Log std vs fast x1024",
+			Measure(batches, [&](size_t)
+			{
+				for (size_t j = 0; j < BATCH; ++j)
+				{
+					results[j] = std::log(logarithmBatch[j]);
+				}
+				sink += results[BATCH - 1];
+			}),
+			Measure(batches, [&](size_t)
+			{
+				Apply(logarithmBatch, results, [](auto x) { return Fast::Log(x); });
+				sink += results[BATCH - 1];
+			}));
+
+		Row(
+			L"ZRotation std vs fast",
+			Measure(iterations, [&](size_t i)
+			{
+				const float theta = angleSamples[i % samples];
+				Consume(Matrix4F(
+					std::cos(theta), std::sin(theta), 0, 0,
+					-std::sin(theta), std::cos(theta), 0, 0,
+					0, 0, 1, 0,
+					0, 0, 0, 1));
+			}),
+			Measure(iterations, [&](size_t i)
+			{
+				Consume(Matrix4F::ZRotation(angleSamples[i % samples]));
+			}));
+	}
+}
@@ -0,0 +1,71 @@
+#include "Checks.h"
+
+#include <random>
+
+namespace Dance::Bench::Checks
+{
+	/// Updating a scene graph against walking up from each node.
+	void Hierarchy(Context& context)
+	{
+		const std::vector<Matrix4F>& matrices = context.Matrices;
+		const size_t scenes = context.Iterations / OBJECTS + 1;
+		std::mt19937 random(0);
+
+		// A scene graph of 10k nodes, each under a random earlier node, where a handful of nodes move every frame
+		HierarchyF hierarchy;
+		hierarchy.Reserve(OBJECTS);
+		for (size_t i = 0; i < OBJECTS; ++i)
+		{
+			const uint32_t parent = i == 0 ? HierarchyF::ROOT : static_cast<uint32_t>(random() % i);
+			hierarchy.Add(parent, matrices[i % INPUTS]);
+		}
+		hierarchy.Update();
+
+		for (size_t i = 0; i < 100; ++i)
+		{
+			hierarchy.SetLocal(static_cast<uint32_t>(random() % OBJECTS), matrices[random() % INPUTS]);
+		}
+		hierarchy.Update();
+
+		// Walking up to the root is what visualizers do by hand without the hierarchy
+		const auto walk = [&](uint32_t node)
+		{
+			Matrix4F result = hierarchy.Local(node);
+			for (uint32_t parent = hierarchy.Parent(node); parent != HierarchyF::ROOT; parent = hierarchy.Parent(parent))
+			{
+				result = result * hierarchy.Local(parent);
+			}
+			return result;
+		};
+
+		float error = 0.0f;
+		for (uint32_t i = 0; i < OBJECTS; ++i)
+		{
+			error = std::max(error, Difference(hierarchy.World(i), walk(i)));
+		}
+		Check(L"Hierarchy vs walk", error);
+
+		std::vector<Matrix4F> full(OBJECTS);
+		Row(
+			L"Scene all vs dirty x10k",
+			Measure(scenes, [&](size_t)
+			{
+				for (uint32_t j = 0; j < OBJECTS; ++j)
+				{
+					const uint32_t parent = hierarchy.Parent(j);
+					full[j] = parent == HierarchyF::ROOT ? hierarchy.Local(j) : hierarchy.Local(j) * full[parent];
+				}
+				Consume(full[OBJECTS - 1]);
+			}),
+			Measure(scenes, [&](size_t i)
+			{
+				for (size_t j = 0; j < 10; ++j)
+				{
+					const uint32_t node = static_cast<uint32_t>((i * 7919 + j * 104729) % OBJECTS);
+					hierarchy.SetLocal(node, matrices[(i + j) % INPUTS]);
+				}
+				hierarchy.Update();
+				Consume(hierarchy.World(OBJECTS - 1));
+			}));
+	}
+}
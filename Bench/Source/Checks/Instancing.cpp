@@ -0,0 +1,75 @@
+#include "Checks.h"
+#include "Instancing.h"
+
+namespace Dance::Bench::Checks
+{
+	/// The shape of InstancedVertex::Instance without pulling in Direct3D.
+	struct Instance
+	{
+		Matrix4F Transform;
+		float Color[4];
+	};
+
+	/// Stands in for the instance buffer and device context, keeping everything it's asked to upload and draw so that
+	/// the packing can be compared against drawing each object on its own.
+	struct Recorder
+	{
+		uint32_t capacity;
+		std::vector<Instance> uploaded;
+		std::vector<uint32_t> uploads;
+		std::vector<uint32_t> draws;
+
+		uint32_t Capacity() const
+		{
+			return this->capacity;
+		}
+
+		void Upload(const Instance* data, uint32_t count)
+		{
+			this->uploaded.insert(this->uploaded.end(), data, data + count);
+			this->uploads.push_back(count);
+		}
+
+		void Draw(uint32_t count)
+		{
+			this->draws.push_back(count);
+		}
+	};
+
+	/// InstanceBatch culling and packing against keeping what each Renderable::Visible would.
+	void Instancing(Context&)
+	{
+		// The boxes the culling check uses as instances of one unit cube, submitted through a recorder that holds 256 at
+		// a time. What it's handed should be exactly the boxes each Renderable::Visible would keep, in order, in as few
+		// draws as fit
+		const FrustumF frustum = View();
+		const std::vector<AABBF> boxes = Scatter();
+		const AABBF cube(Vector3F(-1.0f, -1.0f, -1.0f), Vector3F(1.0f, 1.0f, 1.0f));
+		Dance::Three::Graphics::InstanceBatch<Instance> instances;
+		instances.Reserve(OBJECTS);
+		std::vector<Instance> kept;
+		for (size_t i = 0; i < OBJECTS; ++i)
+		{
+			const AABBF& box = boxes[i];
+			Instance instance{ Matrix4F::Scale(box.Extent()) * Matrix4F::Translation(box.Center()), {} };
+			instance.Color[0] = static_cast<float>(i);
+			instances.Add(instance);
+			if (frustum.Intersects(cube.Transformed(instance.Transform)))
+			{
+				kept.push_back(instance);
+			}
+		}
+
+		Recorder recorder{ 256, {}, {}, {} };
+		const size_t drawn = instances.Submit(recorder, frustum, cube);
+		bool packed = drawn == kept.size()
+			&& recorder.uploads == recorder.draws
+			&& recorder.draws.size() == (kept.size() + recorder.capacity - 1) / recorder.capacity
+			&& recorder.uploaded.size() == kept.size();
+		for (size_t i = 0; packed && i < kept.size(); ++i)
+		{
+			packed = recorder.uploaded[i].Color[0] == kept[i].Color[0];
+		}
+		Check(L"Instances (packing)", packed ? 0.0 : 1.0);
+	}
+}
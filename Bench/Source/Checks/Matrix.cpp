@@ -0,0 +1,141 @@
+#include "Checks.h"
+
+#include <random>
+
+namespace Dance::Bench::Checks
+{
+	/// Matrix4 products, inverses, and batched transforms against their scalar fallbacks, and building a scene's world
+	/// matrices as a chain of products against building them from a rotation and scale.
+	void Matrix(Context& context)
+	{
+		const size_t iterations = context.Iterations;
+		const std::vector<Matrix4F>& matrices = context.Matrices;
+		std::mt19937 random(0);
+		std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+
+		std::vector<Vector4F> vectors(BATCH);
+		for (size_t i = 0; i < BATCH; ++i)
+		{
+			vectors[i] = Vector4F(uniform(random), uniform(random), uniform(random), 1.0f);
+		}
+
+		std::vector<Vector4F> transformed(BATCH);
+		const size_t batches = iterations / BATCH + 1;
+
+		Row(
+			L"Matrix4 multiply",
+			Measure(iterations, [&](size_t i)
+			{
+				Consume(Matrix4F::MultiplyScalar(matrices[i % INPUTS], matrices[(i + 1) % INPUTS]));
+			}),
+			Measure(iterations, [&](size_t i)
+			{
+				Consume(matrices[i % INPUTS] * matrices[(i + 1) % INPUTS]);
+			}));
+
+		Row(
+			L"Matrix4 invert",
+			Measure(iterations, [&](size_t i)
+			{
+				Matrix4F matrix(matrices[i % INPUTS]);
+				matrix.InvertScalar();
+				Consume(matrix);
+			}),
+			Measure(iterations, [&](size_t i)
+			{
+				Matrix4F matrix(matrices[i % INPUTS]);
+				matrix.Invert();
+				Consume(matrix);
+			}));
+
+		// Scale and shear as well as rotation, so that the affine inverse can't take the rigid shortcut
+		std::vector<Matrix4F> affines(matrices);
+		for (Matrix4F& matrix : affines)
+		{
+			matrix.value[0][3] = matrix.value[1][3] = matrix.value[2][3] = 0.0f;
+			matrix.value[3][3] = 1.0f;
+		}
+
+		Row(
+			L"Matrix4 invert affine",
+			Measure(iterations, [&](size_t i)
+			{
+				Matrix4F matrix(affines[i % INPUTS]);
+				matrix.InvertAffineScalar();
+				Consume(matrix);
+			}),
+			Measure(iterations, [&](size_t i)
+			{
+				Matrix4F matrix(affines[i % INPUTS]);
+				matrix.InvertAffine();
+				Consume(matrix);
+			}));
+
+		Row(
+			L"Transform Vector4 x1024",
+			Measure(batches, [&](size_t i)
+			{
+				const Matrix4F& matrix = matrices[i % INPUTS];
+				for (size_t j = 0; j < BATCH; ++j)
+				{
+					transformed[j] = Transform(matrix, vectors[j]);
+				}
+				sink += transformed[BATCH - 1].w;
+			}),
+			Measure(batches, [&](size_t i)
+			{
+				Transform(matrices[i % INPUTS], vectors.data(), transformed.data(), BATCH);
+				sink += transformed[BATCH - 1].w;
+			}));
+
+		// Per-object spin and size as in the cube visualizer, built once as a matrix chain and once as a transformation
+		std::vector<float> angles(OBJECTS);
+		std::vector<float> scales(OBJECTS);
+		for (size_t i = 0; i < OBJECTS; ++i)
+		{
+			angles[i] = uniform(random) * Pi;
+			scales[i] = 100.0f + 100.0f * uniform(random);
+		}
+
+		std::vector<Matrix4F> world(OBJECTS);
+		const size_t scenes = iterations / OBJECTS + 1;
+		Row(
+			L"Scene chain vs TRS x10k",
+			Measure(scenes, [&](size_t)
+			{
+				for (size_t j = 0; j < OBJECTS; ++j)
+				{
+					const float theta = angles[j];
+					world[j] = Matrix4F::Scale(scales[j])
+						* Matrix4F::YRotation(theta)
+						* Matrix4F::XRotation(0.45f * theta)
+						* Matrix4F::ZRotation(0.85f * theta);
+				}
+				Consume(world[OBJECTS - 1]);
+			}),
+			Measure(scenes, [&](size_t)
+			{
+				for (size_t j = 0; j < OBJECTS; ++j)
+				{
+					const float theta = angles[j];
+					const QuaternionF rotation = Concatenate(
+						Concatenate(
+							QuaternionF(Vector3F(0.0f, 1.0f, 0.0f), theta),
+							QuaternionF(Vector3F(1.0f, 0.0f, 0.0f), 0.45f * theta)),
+						QuaternionF(Vector3F(0.0f, 0.0f, 1.0f), 0.85f * theta));
+					world[j] = TransformationF(Vector3F(), rotation, scales[j]).Matrix();
+				}
+				Consume(world[OBJECTS - 1]);
+			}));
+
+		std::wprintf(L"  %-24ls %10ls\n", L"vectorized vs scalar", L"max error");
+		float error = 0.0f;
+		for (const Matrix4F& matrix : affines)
+		{
+			Matrix4F expected(matrix);
+			expected.InvertAffineScalar();
+			error = std::max(error, Difference(matrix.InvertedAffine(), expected));
+		}
+		Check(L"Invert affine", error);
+	}
+}
@@ -0,0 +1,87 @@
+#include "Checks.h"
+#include "MeshOptimizer.h"
+
+#include <array>
+#include <numeric>
+#include <random>
+
+namespace Dance::Bench::Checks
+{
+	/// Reordering a shuffled mesh for the vertex cache.
+	void MeshOptimizer(Context&)
+	{
+		std::mt19937 random(0);
+
+		// A sphere of 16k triangles, the size of the vertices in SimpleVertex, with its triangles and vertices shuffled
+		// the way an exporter might leave them. Optimized, it should keep exactly the same triangles, winding included,
+		// while transforming and fetching each vertex close to once
+		struct MeshVertex
+		{
+			Vector3F Position;
+			uint32_t Id;
+			float Attributes[8];
+		};
+		constexpr uint32_t RINGS = 64;
+		constexpr uint32_t SEGMENTS = 128;
+		std::vector<MeshVertex> vertices;
+		for (uint32_t ring = 0; ring <= RINGS; ++ring)
+		{
+			for (uint32_t segment = 0; segment <= SEGMENTS; ++segment)
+			{
+				const float theta = Pi * ring / RINGS;
+				const float phi = TwoPi * segment / SEGMENTS;
+				const Vector3F position(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+				vertices.push_back(MeshVertex{ position, static_cast<uint32_t>(vertices.size()), {} });
+			}
+		}
+		std::vector<std::array<uint32_t, 3>> triangles;
+		for (uint32_t ring = 0; ring < RINGS; ++ring)
+		{
+			for (uint32_t segment = 0; segment < SEGMENTS; ++segment)
+			{
+				const uint32_t a = ring * (SEGMENTS + 1) + segment;
+				const uint32_t b = a + SEGMENTS + 1;
+				triangles.push_back({ a, a + 1, b });
+				triangles.push_back({ a + 1, b + 1, b });
+			}
+		}
+		std::shuffle(triangles.begin(), triangles.end(), random);
+		std::vector<uint32_t> shuffle(vertices.size());
+		std::iota(shuffle.begin(), shuffle.end(), 0u);
+		std::shuffle(shuffle.begin(), shuffle.end(), random);
+		std::vector<MeshVertex> mesh(vertices.size());
+		std::vector<uint32_t> indices;
+		for (size_t i = 0; i < vertices.size(); ++i)
+		{
+			mesh[shuffle[i]] = vertices[i];
+		}
+		for (const auto& triangle : triangles)
+		{
+			indices.insert(indices.end(), { shuffle[triangle[0]], shuffle[triangle[1]], shuffle[triangle[2]] });
+		}
+
+		// Triangles as original vertex ids, rotated to start at the lowest so that winding is kept but the starting
+		// corner doesn't matter
+		const auto canonical = [](const std::vector<MeshVertex>& vertices, const std::vector<uint32_t>& indices)
+		{
+			std::vector<std::array<uint32_t, 3>> result;
+			for (size_t i = 0; i < indices.size(); i += 3)
+			{
+				std::array<uint32_t, 3> triangle{ vertices[indices[i]].Id, vertices[indices[i + 1]].Id, vertices[indices[i + 2]].Id };
+				std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+				result.push_back(triangle);
+			}
+			std::sort(result.begin(), result.end());
+			return result;
+		};
+		const auto faces = canonical(mesh, indices);
+		const Dance::Three::Graphics::MeshReport report = Dance::Three::Graphics::Optimize(mesh, indices);
+		const bool same = canonical(mesh, indices) == faces && mesh.size() == vertices.size();
+		Check(L"Mesh optimizer (faces)", same && report.After.ACMR < 0.8f && report.After.ATVR < 1.5f && report.After.Overfetch < 2.0f ? 0.0 : 1.0);
+
+		std::wprintf(L"  %-24ls %10ls %10ls %9ls\n", L"mesh optimizer", L"before", L"after", L"ratio");
+		Row(L"ACMR", report.Before.ACMR, report.After.ACMR);
+		Row(L"ATVR", report.Before.ATVR, report.After.ATVR);
+		Row(L"Overfetch", report.Before.Overfetch, report.After.Overfetch);
+	}
+}
@@ -0,0 +1,95 @@
+#include "Checks.h"
+#include "Noise.h"
+
+#include <type_traits>
+
+namespace Dance::Bench::Checks
+{
+	/// A constant of the same type as like, which is a float for the scalar noise overloads and a lane otherwise.
+	template<typename T>
+	static T Splat(T, float value)
+	{
+		if constexpr (std::is_same_v<T, float>)
+		{
+			return value;
+		}
+		else
+		{
+			return T::Broadcast(value);
+		}
+	}
+
+	/// Print one row of the noise table, converting nanoseconds per sample to millions of samples per second.
+	static void Rate(const wchar_t* label, double baseline, double optimized)
+	{
+		std::wprintf(L"  %-24ls %10.1f %10.1f %8.2fx\n", label, 1e3 / baseline, 1e3 / optimized, baseline / optimized);
+	}
+
+	/// Noise::Grid in lanes against the float overloads one point at a time.
+	void Noise(Context& context)
+	{
+		const size_t iterations = context.Iterations;
+
+		// Noise filling a 256 x 256 field, as a procedural visualizer would every frame, one point at a time through
+		// the float overloads against Noise::Grid. Rates are per thread since nothing here is parallel
+		constexpr size_t SIDE = 256;
+		constexpr float STEP = 0.0371f;
+		const float time = 3.7f;
+		std::vector<float> field(SIDE * SIDE);
+		std::vector<float> reference(SIDE * SIDE);
+		const size_t fields = iterations / (SIDE * SIDE) + 1;
+		const auto each = [&](auto&& visit)
+		{
+			visit(L"Simplex 2D", [](auto x, auto y) { return Noise::Simplex(x, y); });
+			visit(L"Simplex 3D", [&](auto x, auto y) { return Noise::Simplex(x, y, Splat(x, time)); });
+			visit(L"Simplex 4D", [&](auto x, auto y) { return Noise::Simplex(x, y, Splat(x, time), Splat(x, -time)); });
+			visit(L"Value 2D", [](auto x, auto y) { return Noise::Value(x, y); });
+			visit(L"Value 3D", [&](auto x, auto y) { return Noise::Value(x, y, Splat(x, time)); });
+			visit(L"Value 4D", [&](auto x, auto y) { return Noise::Value(x, y, Splat(x, time), Splat(x, -time)); });
+			visit(L"Fractal 3D x5", [&](auto x, auto y)
+			{
+				return Noise::Fractal(Noise::Octaves(), [](auto... p) { return Noise::Simplex(p...); }, x, y, Splat(x, time));
+			});
+		};
+		const auto scalar = [&](auto& noise)
+		{
+			for (size_t row = 0; row < SIDE; ++row)
+			{
+				for (size_t column = 0; column < SIDE; ++column)
+				{
+					reference[row * SIDE + column] = noise(column * STEP, row * STEP);
+				}
+			}
+		};
+
+		std::wprintf(L"  %-24ls %10ls\n", L"noise lanes vs scalar", L"max error");
+		each([&](const wchar_t* label, auto&& noise)
+		{
+			scalar(noise);
+			Noise::Grid(field.data(), SIDE, SIDE, 0.0f, 0.0f, STEP, noise);
+			double difference = 0.0;
+			for (size_t i = 0; i < SIDE * SIDE; ++i)
+			{
+				difference = std::max(difference, static_cast<double>(std::fabs(field[i] - reference[i])));
+			}
+			Check(label, difference);
+		});
+
+		std::wprintf(L"  %-24ls %10ls %10ls %9ls\n", L"Msamples/s per thread", L"scalar", L"lanes", L"speedup");
+		each([&](const wchar_t* label, auto&& noise)
+		{
+			Rate(
+				label,
+				Measure(fields, [&](size_t)
+				{
+					scalar(noise);
+					sink += reference[SIDE * SIDE - 1];
+				}) / (SIDE * SIDE),
+				Measure(fields, [&](size_t)
+				{
+					Noise::Grid(field.data(), SIDE, SIDE, 0.0f, 0.0f, STEP, noise);
+					sink += field[SIDE * SIDE - 1];
+				}) / (SIDE * SIDE));
+		});
+	}
+}
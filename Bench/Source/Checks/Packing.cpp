@@ -0,0 +1,58 @@
+#include "Checks.h"
+#include "Packing.h"
+
+#include <random>
+
+namespace Dance::Bench::Checks
+{
+	/// The compact vertex encodings round tripped.
+	void Packing(Context&)
+	{
+		std::mt19937 random(0);
+		std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+
+		// Compact vertex encodings against what the input assembler decodes. Every finite half comes back bit for bit,
+		// normal range floats within half a half ulp, normals within a hundredth of a degree and colors within half a
+		// step
+		std::wprintf(L"  %-24ls %10ls\n", L"packing round trip", L"max error");
+		bool exact = true;
+		for (uint32_t bits = 0; bits < 0x10000; ++bits)
+		{
+			const uint16_t half = static_cast<uint16_t>(bits);
+			exact = exact && ((half & 0x7C00) == 0x7C00 || ToHalf(FromHalf(half)) == half);
+		}
+		Check(L"Half (every value)", exact ? 0.0 : 1.0);
+
+		double relative = 0.0;
+		for (size_t i = 0; i < 100000; ++i)
+		{
+			const float value = std::copysign(std::ldexp(1.0f + std::fabs(uniform(random)), static_cast<int>(random() % 29) - 14), uniform(random));
+			relative = std::max(relative, static_cast<double>(std::fabs(FromHalf(ToHalf(value)) - value) / std::fabs(value)));
+		}
+		Check(L"Half (relative)", relative, 1.0 / 2048.0);
+
+		double angle = 0.0;
+		for (size_t i = 0; i < 100000; ++i)
+		{
+			const Vector3F normal = Vector3F(uniform(random), uniform(random), uniform(random)).Normalized();
+			const Vector3F decoded = FromOctahedral(ToOctahedral(normal));
+			angle = std::max(angle, static_cast<double>(std::atan2(Cross(normal, decoded).Length(), Dot(normal, decoded))));
+		}
+		for (const Vector3F& axis : { Vector3F(1, 0, 0), Vector3F(0, -1, 0), Vector3F(0, 0, 1), Vector3F(0, 0, -1) })
+		{
+			angle = std::max(angle, static_cast<double>(Difference(axis, FromOctahedral(ToOctahedral(axis)))));
+		}
+		Check(L"Octahedral (radians)", angle, ToRadians(0.01f));
+
+		double channel = 0.0;
+		for (size_t i = 0; i < 100000; ++i)
+		{
+			const Vector4F color(std::fabs(uniform(random)), std::fabs(uniform(random)), std::fabs(uniform(random)), 1.0f);
+			const Vector4F decoded = FromUnorm8(ToUnorm8(color));
+			channel = std::max({ channel, static_cast<double>(std::fabs(decoded.x - color.x)),
+				static_cast<double>(std::fabs(decoded.y - color.y)), static_cast<double>(std::fabs(decoded.z - color.z)),
+				static_cast<double>(std::fabs(decoded.w - color.w)) });
+		}
+		Check(L"Unorm8 (absolute)", channel, 0.5 / 255.0 + 1e-6);
+	}
+}
@@ -0,0 +1,82 @@
+#include "Checks.h"
+#include "Procedural.h"
+
+namespace Dance::Bench::Checks
+{
+	/// The procedural mesh generators.
+	void Procedural(Context&)
+	{
+		// Every runtime generator, wound outward and in range, with the index type following the vertex count: the
+		// tunnel and terrain fit 16-bit indices, the larger terrain doesn't
+		using Dance::Three::Graphics::MeshSize;
+		struct ProceduralVertex
+		{
+			Vector3F Position;
+			Vector3F Normal;
+			float Color[4];
+			float UV[2];
+		};
+		const auto valid = [](const std::vector<ProceduralVertex>& vertices, const auto& indices, const MeshSize& size)
+		{
+			return size.Vertices == vertices.size() && size.Indices == indices.size()
+				&& Dance::Three::Graphics::IndicesInRange(indices.data(), indices.size(), vertices.size())
+				&& Dance::Three::Graphics::FacesOutward(vertices.data(), indices.data(), indices.size());
+		};
+		const auto on = [](const std::vector<ProceduralVertex>& vertices, auto&& distance)
+		{
+			return std::all_of(vertices.begin(), vertices.end(), [&](const ProceduralVertex& vertex)
+			{
+				return std::fabs(distance(vertex.Position)) < 1e-4f;
+			});
+		};
+
+		std::vector<ProceduralVertex> generated(Dance::Three::Graphics::IcosphereSize(8).Vertices);
+		std::vector<uint16_t> narrow(Dance::Three::Graphics::IcosphereSize(8).Indices);
+		bool procedural = valid(generated, narrow, Dance::Three::Graphics::Icosphere(generated.data(), narrow.data(), 8, 2.0f))
+			&& on(generated, [](const Vector3F& position) { return position.Length() - 2.0f; });
+
+		generated.resize(Dance::Three::Graphics::UVSphereSize(16, 32).Vertices);
+		narrow.resize(Dance::Three::Graphics::UVSphereSize(16, 32).Indices);
+		procedural = procedural && valid(generated, narrow, Dance::Three::Graphics::UVSphere(generated.data(), narrow.data(), 16, 32, 2.0f))
+			&& on(generated, [](const Vector3F& position) { return position.Length() - 2.0f; });
+
+		generated.resize(Dance::Three::Graphics::TorusSize(48, 24).Vertices);
+		narrow.resize(Dance::Three::Graphics::TorusSize(48, 24).Indices);
+		procedural = procedural && valid(generated, narrow, Dance::Three::Graphics::Torus(generated.data(), narrow.data(), 48, 24, 2.0f, 0.5f))
+			&& on(generated, [](const Vector3F& position)
+			{
+				return std::hypot(std::hypot(position.x, position.z) - 2.0f, position.y) - 0.5f;
+			});
+
+		const Vector3F path[] = { Vector3F(0, 0, 0), Vector3F(0, 0, 10), Vector3F(5, 2, 20), Vector3F(5, 8, 25), Vector3F(-5, 8, 30) };
+		for (const bool inside : { false, true })
+		{
+			const MeshSize size = Dance::Three::Graphics::TubeSize(5, 16, 12);
+			generated.resize(size.Vertices);
+			narrow.resize(size.Indices);
+			procedural = procedural && valid(generated, narrow, Dance::Three::Graphics::Tube(generated.data(), narrow.data(), path, 5, 16, 12, 1.0f, inside))
+				&& Dance::Three::Graphics::WithIndexType(size, [](auto index) { return sizeof(index) == 2; });
+		}
+
+		const auto terrain = [](float s, float t) { return std::sin(s * 20.0f) * std::cos(t * 13.0f); };
+		for (const size_t cells : { 64u, 300u })
+		{
+			const MeshSize size = Dance::Three::Graphics::HeightfieldSize(cells, cells);
+			procedural = procedural && Dance::Three::Graphics::WithIndexType(size, [&](auto index)
+			{
+				generated.resize(size.Vertices);
+				std::vector<decltype(index)> indices(size.Indices);
+				return sizeof(index) == (cells < 255 ? 2u : 4u)
+					&& valid(generated, indices, Dance::Three::Graphics::Heightfield(generated.data(), indices.data(), cells, cells, 8.0f, 8.0f, terrain))
+					&& std::all_of(generated.begin(), generated.end(), [&](const ProceduralVertex& vertex)
+					{
+						return vertex.Position.y == terrain(vertex.UV[0], vertex.UV[1]) && std::fabs(vertex.Normal.Length() - 1.0f) < 1e-5f;
+					});
+			});
+		}
+
+		// A 16-bit buffer can't hold the larger terrain, so nothing is written
+		procedural = procedural && Dance::Three::Graphics::Heightfield(generated.data(), narrow.data(), 300, 300, 8.0f, 8.0f, terrain).Vertices == 0;
+		Check(L"Procedural meshes", procedural ? 0.0 : 1.0);
+	}
+}
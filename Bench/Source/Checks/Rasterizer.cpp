@@ -0,0 +1,129 @@
+#include "Checks.h"
+#include "Procedural.h"
+#include "Rasterizer.h"
+
+#include <array>
+#include <numeric>
+#include <random>
+
+namespace Dance::Bench::Checks
+{
+	/// The software rasterizer.
+	void Rasterizer(Context& context)
+	{
+		const size_t frames = std::max<size_t>(context.Iterations / 1000, 5);
+		std::mt19937 random(0);
+		std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+
+		// Laid out as the procedural generators expect, which the sphere and tunnel below come from
+		struct ProceduralVertex
+		{
+			Vector3F Position;
+			Vector3F Normal;
+			float Color[4];
+			float UV[2];
+		};
+		std::vector<ProceduralVertex> generated;
+		std::vector<uint16_t> narrow;
+
+		// The software rasterizer. A jittered grid filling the screen, each triangle nearer than the last so that a pixel
+		// covered twice is shaded twice, should shade every pixel exactly once. Corners sit on half pixels, so at a
+		// power of two size many edges pass exactly through pixel centers and the top-left rule decides; the other size
+		// isn't a whole number of tiles or lanes
+		using Dance::Three::Graphics::Framebuffer;
+		using Dance::Three::Graphics::RasterVertex;
+		using Dance::Three::Graphics::Rasterizer;
+		constexpr uint32_t WIDTH = 250;
+		constexpr uint32_t HEIGHT = 190;
+		constexpr size_t CELLS = 32;
+		Rasterizer rasterizer(4);
+		const auto flat = [](const Vector3F& position) { return RasterVertex<1>{ Vector4F(position.x, position.y, position.z, 1.0f), { 1.0f } }; };
+		const auto white = [](const std::array<float, 1>& value) { return Vector4F(value[0], value[0], value[0], 1.0f); };
+		const auto watertight = [&](uint32_t width, uint32_t height)
+		{
+			std::vector<Vector3F> lattice((CELLS + 1) * (CELLS + 1));
+			for (size_t i = 0; i <= CELLS; ++i)
+			{
+				for (size_t j = 0; j <= CELLS; ++j)
+				{
+					const bool edge = i == 0 || j == 0 || i == CELLS || j == CELLS;
+					const float jitter = edge ? 0.0f : 0.3f;
+					const float x = std::round((static_cast<float>(i * width) / CELLS + jitter * uniform(random) * width / CELLS) * 2.0f) / 2.0f;
+					const float y = std::round((static_cast<float>(j * height) / CELLS + jitter * uniform(random) * height / CELLS) * 2.0f) / 2.0f;
+					lattice[i * (CELLS + 1) + j] = Vector3F(x / (width * 0.5f) - 1.0f, y / (height * 0.5f) - 1.0f, 0.0f);
+				}
+			}
+
+			std::vector<Vector3F> corners;
+			for (size_t i = 0; i < CELLS; ++i)
+			{
+				for (size_t j = 0; j < CELLS; ++j)
+				{
+					const size_t a = i * (CELLS + 1) + j;
+					for (const size_t corner : { a, a + 1, a + CELLS + 1, a + 1, a + CELLS + 2, a + CELLS + 1 })
+					{
+						corners.push_back(lattice[corner]);
+						corners.back().z = 0.9f - 0.8f * (corners.size() / 3) / (CELLS * CELLS * 2);
+					}
+				}
+			}
+			std::vector<uint32_t> sequence(corners.size());
+			std::iota(sequence.begin(), sequence.end(), 0u);
+
+			Framebuffer target(width, height);
+			const auto grid = rasterizer.Draw<1>(target, corners.data(), corners.size(), sequence.data(), sequence.size(), flat, white);
+			return grid.Pixels == width * height && grid.Culled == 0
+				&& std::all_of(target.Colors(), target.Colors() + width * height, [](uint32_t color) { return color == 0xFFFFFFFFu; });
+		};
+		bool rasterized = watertight(256, 256) && watertight(WIDTH, HEIGHT);
+		Framebuffer frame(WIDTH, HEIGHT);
+
+		// A sphere in perspective covers the disc its silhouette projects to, whatever the thread count, and a camera
+		// inside a tunnel sees walls everywhere but the far opening, with the walls behind it clipped away
+		const Matrix4F projection = Matrix4F::Perspective(PiOver2, static_cast<float>(WIDTH), static_cast<float>(HEIGHT), 0.1f, 100.0f);
+		const auto lit = [](const std::array<float, 3>& normal)
+		{
+			return Vector4F(normal[0] * 0.5f + 0.5f, normal[1] * 0.5f + 0.5f, normal[2] * 0.5f + 0.5f, 1.0f);
+		};
+		const auto scene = [&](Rasterizer& renderer, Framebuffer& target, const Vector3F& offset)
+		{
+			return renderer.Draw<3>(target, generated.data(), generated.size(), narrow.data(), narrow.size(), [&](const ProceduralVertex& vertex)
+			{
+				const Vector3F position = vertex.Position + offset;
+				return RasterVertex<3>{ Transform(projection, Vector4F(position.x, position.y, position.z, 1.0f)), { vertex.Normal.x, vertex.Normal.y, vertex.Normal.z } };
+			}, lit);
+		};
+
+		generated.resize(Dance::Three::Graphics::IcosphereSize(32).Vertices);
+		narrow.resize(Dance::Three::Graphics::IcosphereSize(32).Indices);
+		Dance::Three::Graphics::Icosphere(generated.data(), narrow.data(), 32, 1.0f);
+		const Vector3F away(0.0f, 0.0f, 3.0f);
+		frame.Clear(Vector4F());
+		const auto sphere = scene(rasterizer, frame, away);
+		Rasterizer serial(1);
+		Framebuffer single(WIDTH, HEIGHT);
+		scene(serial, single, away);
+		const double disc = Pi * std::pow(HEIGHT / 2.0 / std::sqrt(away.z * away.z - 1.0), 2.0);
+		rasterized = rasterized && frame.Differences(single) == 0 && frame.Hash() == single.Hash()
+			&& std::fabs(sphere.Pixels / disc - 1.0) < 0.02 && sphere.Culled > 0;
+
+		const Vector3F straight[] = { Vector3F(0, 0, -5), Vector3F(0, 0, 40) };
+		generated.resize(Dance::Three::Graphics::TubeSize(2, 64, 32).Vertices);
+		narrow.resize(Dance::Three::Graphics::TubeSize(2, 64, 32).Indices);
+		Dance::Three::Graphics::Tube(generated.data(), narrow.data(), straight, 2, 64, 32, 1.0f, true);
+		frame.Clear(Vector4F());
+		const auto tunnel = scene(rasterizer, frame, Vector3F());
+		rasterized = rasterized && tunnel.Pixels >= WIDTH * HEIGHT * 99 / 100 && tunnel.Culled > 0;
+		Check(L"Rasterizer (coverage)", rasterized ? 0.0 : 1.0);
+
+		std::wprintf(L"  %-24ls %10ls %10ls %9ls\n", L"us per frame", L"1 thread", L"threads", L"speedup");
+		generated.resize(Dance::Three::Graphics::IcosphereSize(32).Vertices);
+		narrow.resize(Dance::Three::Graphics::IcosphereSize(32).Indices);
+		Dance::Three::Graphics::Icosphere(generated.data(), narrow.data(), 32, 1.0f);
+		Rasterizer cores;
+		Row(
+			L"Rasterize sphere",
+			Measure(frames, [&](size_t) { frame.Clear(Vector4F()); scene(serial, frame, away); }) / 1e3,
+			Measure(frames, [&](size_t) { frame.Clear(Vector4F()); scene(cores, frame, away); }) / 1e3);
+	}
+}
@@ -0,0 +1,65 @@
+#include "Checks.h"
+#include "UploadRing.h"
+
+#include <deque>
+#include <random>
+
+namespace Dance::Bench::Checks
+{
+	/// The upload ring under a GPU that lags behind.
+	void UploadRing(Context&)
+	{
+		std::mt19937 random(0);
+
+		// A frame upload ring fed a few hundred constant writes a frame by a GPU that lags up to three frames behind.
+		// Nothing handed out may overlap a range an unretired frame holds, straddle the end, or break the alignment
+		using Allocation = Dance::Three::Graphics::UploadRing::Allocation;
+		Dance::Three::Graphics::UploadRing ring(64 * 1024);
+		std::deque<std::vector<Allocation>> held;
+		bool fenced = true;
+		size_t stalls = 0;
+		for (uint64_t frame = 1; frame <= 1000; ++frame)
+		{
+			const auto overlaps = [](const Allocation& allocation, const std::vector<Allocation>& others)
+			{
+				return std::any_of(others.begin(), others.end(), [&](const Allocation& other)
+				{
+					return allocation.Offset < other.Offset + other.Size && other.Offset < allocation.Offset + allocation.Size;
+				});
+			};
+
+			std::vector<Allocation> current;
+			const size_t writes = 20 + random() % 60;
+			for (size_t j = 0; j < writes; ++j)
+			{
+				// Stall on the oldest frame whenever the ring is full, as FrameConstantBuffer does
+				Allocation allocation;
+				while (!ring.Allocate(16 + random() % 320, allocation))
+				{
+					ring.Retire(ring.Oldest());
+					held.pop_front();
+					++stalls;
+				}
+
+				fenced = fenced
+					&& allocation.Offset % Dance::Three::Graphics::UploadRing::ALIGNMENT == 0
+					&& allocation.Offset + allocation.Size <= ring.Capacity()
+					&& !overlaps(allocation, current)
+					&& std::none_of(held.begin(), held.end(), [&](const auto& others) { return overlaps(allocation, others); });
+				current.push_back(allocation);
+			}
+
+			ring.Finish(frame);
+			held.push_back(std::move(current));
+			if (frame > 3)
+			{
+				ring.Retire(frame - 3);
+			}
+			while (held.size() > ring.InFlight())
+			{
+				held.pop_front();
+			}
+		}
+		Check(L"Upload ring (overlaps)", fenced && stalls > 0 ? 0.0 : 1.0);
+	}
+}
@@ -0,0 +1,52 @@
+#include "Kernels.h"
+#include "Checks.h"
+
+#include <random>
+
+using namespace Dance::Three::Math;
+
+namespace Dance::Bench
+{
+	/// Every feature under Source/Checks, in the order they're printed.
+	static void (*const CHECKS[])(Checks::Context&) = {
+		Checks::Matrix,
+		Checks::Batch,
+		Checks::FastMath,
+		Checks::Bounds,
+		Checks::Instancing,
+		Checks::Packing,
+		Checks::UploadRing,
+		Checks::Commands,
+		Checks::MeshOptimizer,
+		Checks::Procedural,
+		Checks::Rasterizer,
+		Checks::Canvas,
+		Checks::Hierarchy,
+		Checks::Noise,
+	};
+
+	void Kernels(size_t iterations)
+	{
+		std::mt19937 random(0);
+		std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+
+		Checks::Context context{ iterations, std::vector<Matrix4F>(Checks::INPUTS) };
+		for (Matrix4F& matrix : context.Matrices)
+		{
+			for (auto& row : matrix.value)
+			{
+				for (float& element : row)
+				{
+					element = uniform(random);
+				}
+			}
+		}
+
+		std::wprintf(L"math kernels (%ls)\n", DANCE_AVX ? L"avx" : DANCE_SSE ? L"sse" : L"scalar only");
+		std::wprintf(L"  %-24ls %10ls %10ls %9ls\n", L"ns per call", L"baseline", L"optimized", L"speedup");
+		for (const auto check : CHECKS)
+		{
+			check(context);
+		}
+	}
+}
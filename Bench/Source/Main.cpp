@@ -0,0 +1,518 @@
+#include "Offscreen.h"
+#include "Signal.h"
+#include "Report.h"
+#include "Kernels.h"
+#include "Operations.h"
+#include "Plugin.h"
+#include "Sandbox.h"
+#include "Library.h"
+#include "Path.h"
+#include "Features.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cwchar>
+#include <cstring>
+#include <malloc.h>
+#include <string>
+#include <vector>
+#include <optional>
+
+using Dance::Application::Plugin;
+using Dance::Application::Plugins;
+
+/// Command line configuration of a benchmark run.
+struct Arguments
+{
+	size_t Frames{ 600 };
+	size_t Warmup{ 60 };
+	double Rate{ 60.0 };
+	UINT Width{ 1280 };
+	UINT Height{ 720 };
+	bool Hardware{ false };
+	bool Math{ false };
+	bool Reload{ false };
+	std::optional<std::filesystem::path> Recording;
+	std::vector<std::filesystem::path> Plugins;
+};
+
+/// Heap allocations made since the last reset, by the plugins as well as by us. Every module built against the
+/// dynamic CRT, the default for ours and the plugins', allocates from the one UCRT heap through the malloc family it
+/// imports, and operator new comes down to those too. Each module links its own operator new, so we count at the
+/// imports instead, redirecting them in our own module and in each plugin as it's loaded.
+static std::atomic<uint64_t> allocations{ 0 };
+static std::atomic<uint64_t> allocated{ 0 };
+
+static void Count(size_t size)
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	allocated.fetch_add(size, std::memory_order_relaxed);
+}
+
+/// The CRT's own allocation functions, taken from the first import of each that's redirected.
+static decltype(&std::malloc) Malloc = nullptr;
+static decltype(&std::calloc) Calloc = nullptr;
+static decltype(&std::realloc) Realloc = nullptr;
+static decltype(&::_aligned_malloc) AlignedMalloc = nullptr;
+
+static void* __cdecl CountedMalloc(size_t size)
+{
+	Count(size);
+	return Malloc(size);
+}
+
+static void* __cdecl CountedCalloc(size_t count, size_t size)
+{
+	Count(count * size);
+	return Calloc(count, size);
+}
+
+static void* __cdecl CountedRealloc(void* pointer, size_t size)
+{
+	Count(size);
+	return Realloc(pointer, size);
+}
+
+static void* __cdecl CountedAlignedMalloc(size_t size, size_t alignment)
+{
+	Count(size);
+	return AlignedMalloc(size, alignment);
+}
+
+/// Point a module's imports of the CRT allocation functions at the counting ones above. An import that resolves to a
+/// different CRT than the first one seen, e.g. a debug plugin in a release bench, is left alone and goes uncounted.
+static void Redirect(HMODULE module)
+{
+	struct Hook
+	{
+		const char* Name;
+		void** Original;
+		void* Counted;
+	};
+
+	const Hook hooks[] = {
+		{ "malloc", reinterpret_cast<void**>(&Malloc), reinterpret_cast<void*>(&CountedMalloc) },
+		{ "calloc", reinterpret_cast<void**>(&Calloc), reinterpret_cast<void*>(&CountedCalloc) },
+		{ "realloc", reinterpret_cast<void**>(&Realloc), reinterpret_cast<void*>(&CountedRealloc) },
+		{ "_aligned_malloc", reinterpret_cast<void**>(&AlignedMalloc), reinterpret_cast<void*>(&CountedAlignedMalloc) },
+	};
+
+	uint8_t* base = reinterpret_cast<uint8_t*>(module);
+	const IMAGE_DOS_HEADER* dos = reinterpret_cast<const IMAGE_DOS_HEADER*>(base);
+	const IMAGE_NT_HEADERS* nt = reinterpret_cast<const IMAGE_NT_HEADERS*>(base + dos->e_lfanew);
+	const IMAGE_DATA_DIRECTORY& directory = nt->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_IMPORT];
+	if (directory.VirtualAddress == 0)
+	{
+		return;
+	}
+
+	const IMAGE_IMPORT_DESCRIPTOR* import = reinterpret_cast<const IMAGE_IMPORT_DESCRIPTOR*>(base + directory.VirtualAddress);
+	for (; import->Name != 0; ++import)
+	{
+		// The names are only kept alongside the bound addresses if the linker wrote a lookup table
+		if (import->OriginalFirstThunk == 0)
+		{
+			continue;
+		}
+
+		const IMAGE_THUNK_DATA* names = reinterpret_cast<const IMAGE_THUNK_DATA*>(base + import->OriginalFirstThunk);
+		IMAGE_THUNK_DATA* addresses = reinterpret_cast<IMAGE_THUNK_DATA*>(base + import->FirstThunk);
+		for (; names->u1.AddressOfData != 0; ++names, ++addresses)
+		{
+			if (IMAGE_SNAP_BY_ORDINAL(names->u1.Ordinal))
+			{
+				continue;
+			}
+
+			const char* name = reinterpret_cast<const IMAGE_IMPORT_BY_NAME*>(base + names->u1.AddressOfData)->Name;
+			for (const Hook& hook : hooks)
+			{
+				void** slot = reinterpret_cast<void**>(&addresses->u1.Function);
+				if (std::strcmp(name, hook.Name) != 0 || *slot == hook.Counted)
+				{
+					continue;
+				}
+
+				if (*hook.Original == nullptr)
+				{
+					*hook.Original = *slot;
+				}
+
+				DWORD protection;
+				if (*slot == *hook.Original && ::VirtualProtect(slot, sizeof(void*), PAGE_READWRITE, &protection))
+				{
+					*slot = hook.Counted;
+					::VirtualProtect(slot, sizeof(void*), protection, &protection);
+				}
+			}
+		}
+	}
+}
+
+static void Usage()
+{
+	std::fwprintf(
+		stderr,
+		L"usage: Bench [--frames N] [--warmup N] [--rate FPS] [--size WxH] [--wav PATH] [--hardware] [PLUGIN...]\n"
+		L"       Bench --math\n"
+		L"       Bench --reload [PLUGIN...]\n"
+		L"  Runs each visualizer plugin offscreen against a recorded or synthesized signal and reports per-frame\n"
+		L"  update and render times. Without any plugins, every DLL in the adjacent Visualizers directory is run.\n"
+		L"  With --math, times the vectorized math kernels against their scalar fallbacks and the math types'\n"
+		L"  operations over cache-hot and cache-cold arrays instead. With --reload, checks that each plugin's state\n"
+		L"  survives the trip through a sandbox process that a hot reload makes, and that a rebuild registering\n"
+		L"  nothing leaves the first plugin's previous module in place while other modules are loaded.\n");
+}
+
+static bool Parse(int argc, wchar_t* argv[], Arguments& arguments)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::wstring argument = argv[i];
+		const bool hasValue = i + 1 < argc;
+		if (argument == L"--frames" && hasValue)
+		{
+			arguments.Frames = std::wcstoull(argv[++i], nullptr, 10);
+		}
+		else if (argument == L"--warmup" && hasValue)
+		{
+			arguments.Warmup = std::wcstoull(argv[++i], nullptr, 10);
+		}
+		else if (argument == L"--rate" && hasValue)
+		{
+			arguments.Rate = std::wcstod(argv[++i], nullptr);
+		}
+		else if (argument == L"--size" && hasValue)
+		{
+			if (std::swscanf(argv[++i], L"%ux%u", &arguments.Width, &arguments.Height) != 2)
+			{
+				return false;
+			}
+		}
+		else if (argument == L"--wav" && hasValue)
+		{
+			arguments.Recording = argv[++i];
+		}
+		else if (argument == L"--hardware")
+		{
+			arguments.Hardware = true;
+		}
+		else if (argument == L"--math")
+		{
+			arguments.Math = true;
+		}
+		else if (argument == L"--reload")
+		{
+			arguments.Reload = true;
+		}
+		else if (argument.rfind(L"--", 0) == 0)
+		{
+			return false;
+		}
+		else
+		{
+			arguments.Plugins.push_back(argument);
+		}
+	}
+
+	return arguments.Frames > 0 && arguments.Rate > 0.0 && arguments.Width > 0 && arguments.Height > 0;
+}
+
+/// Seconds between two QueryPerformanceCounter readings.
+static double Elapsed(const LARGE_INTEGER& start, const LARGE_INTEGER& end, const LARGE_INTEGER& frequency)
+{
+	return static_cast<double>(end.QuadPart - start.QuadPart) / frequency.QuadPart;
+}
+
+/// Drive a single visualizer through the warmup and measured frames.
+static void Run(const Plugin& plugin, const Dance::Application::Offscreen& host, const Arguments& arguments)
+{
+	Dance::Bench::Signal signal = arguments.Recording
+		? Dance::Bench::Signal(*arguments.Recording)
+		: Dance::Bench::Signal(48000);
+
+	// Each frame pulls exactly the audio that would have arrived since the last one
+	const double delta = 1.0 / arguments.Rate;
+	const size_t perFrame = static_cast<size_t>(signal.SampleRate() / arguments.Rate);
+	signal.Reserve(perFrame);
+
+	Dance::API::Visualizer::Dependencies dependencies = host.Dependencies();
+	dependencies.AudioSampleRate = signal.SampleRate();
+	dependencies.AudioSource = [&signal, perFrame](const float*& frames)
+	{
+		return signal.Read(frames, perFrame);
+	};
+
+	// Plugins on the C ABI read the host's analysis instead, which is runtime work and so isn't timed
+	Dance::Audio::Features features(signal.SampleRate(), ONE_SECOND / 20);
+	dependencies.Features = features.Block();
+	auto analyze = [&]()
+	{
+		if (plugin.Shared)
+		{
+			const float* frames = nullptr;
+			const size_t count = signal.Read(frames, perFrame);
+			features.Handle(frames, count);
+		}
+	};
+
+	Dance::API::Visualizer* visualizer = plugin.Constructor(dependencies);
+	for (size_t i = 0; i < arguments.Warmup; ++i)
+	{
+		analyze();
+		visualizer->Update(delta);
+		visualizer->Render();
+	}
+
+	LARGE_INTEGER frequency;
+	::QueryPerformanceFrequency(&frequency);
+
+	Dance::Bench::Report report(arguments.Frames);
+	for (size_t i = 0; i < arguments.Frames; ++i)
+	{
+		LARGE_INTEGER start, updated, rendered;
+		analyze();
+		allocations = 0;
+		allocated = 0;
+
+		::QueryPerformanceCounter(&start);
+		visualizer->Update(delta);
+		::QueryPerformanceCounter(&updated);
+		visualizer->Render();
+		::QueryPerformanceCounter(&rendered);
+
+		report.Record({
+			Elapsed(start, updated, frequency),
+			Elapsed(updated, rendered, frequency),
+			allocations.load(std::memory_order_relaxed),
+			allocated.load(std::memory_order_relaxed),
+		});
+	}
+
+	plugin.Destructor(visualizer);
+	report.Print(plugin.Name);
+}
+
+/// Check that a plugin's state survives a hot reload while it's sandboxed. VisualizerWindow::Reload serializes the
+/// outgoing visualizer and restores the state into its replacement; sandboxed, that means the next sandbox restores it
+/// as it launches, and the state only comes back out if that sandbox writes it again as it quits.
+static bool Handoff(const Plugin& plugin, const Dance::Application::Offscreen& host, const Arguments& arguments)
+{
+	Dance::Bench::Signal signal(48000);
+	const double delta = 1.0 / arguments.Rate;
+	const size_t perFrame = static_cast<size_t>(signal.SampleRate() / arguments.Rate);
+
+	Dance::API::Visualizer::Dependencies dependencies = host.Dependencies();
+	dependencies.AudioSampleRate = signal.SampleRate();
+	dependencies.AudioSource = [&signal, perFrame](const float*& frames)
+	{
+		return signal.Read(frames, perFrame);
+	};
+
+	Dance::Audio::Features features(signal.SampleRate(), ONE_SECOND / 20);
+	dependencies.Features = features.Block();
+
+	// Run the plugin inline for a moment so that it has state worth keeping
+	Dance::API::Visualizer* visualizer = plugin.Constructor(dependencies);
+	for (size_t i = 0; i < arguments.Warmup; ++i)
+	{
+		if (plugin.Shared)
+		{
+			const float* frames = nullptr;
+			const size_t count = signal.Read(frames, perFrame);
+			features.Handle(frames, count);
+		}
+
+		visualizer->Update(delta);
+		visualizer->Render();
+	}
+
+	const std::vector<uint8_t> state = visualizer->Serialize();
+	plugin.Destructor(visualizer);
+	if (state.empty())
+	{
+		std::wprintf(L"%ls: no state to hand off\n", plugin.Name.c_str());
+		return true;
+	}
+
+	// A frame without time passing launches the sandbox without changing the state
+	std::vector<uint8_t> returned;
+	{
+		Dance::Application::SandboxVisualizer sandbox(plugin, dependencies);
+		sandbox.Restore(state);
+		sandbox.Update(0.0);
+		returned = sandbox.Serialize();
+	}
+
+	const bool kept = returned == state;
+	std::wprintf(L"%ls: %zu bytes of state %ls\n", plugin.Name.c_str(), state.size(), kept ? L"kept" : L"LOST");
+	return kept;
+}
+
+/// Check that a rebuild of one module that registers nothing leaves that module in place while another module's
+/// plugins are registered. A copy of the plugin is loaded as a second module, which is then overwritten with a system
+/// DLL standing in for the broken rebuild and reloaded, then restored and reloaded again. The plugin's own DLL isn't
+/// touched.
+static bool Survives(const std::filesystem::path& path)
+{
+	std::error_code error;
+	const std::filesystem::path directory = std::filesystem::temp_directory_path(error) / L"DanceReload";
+	const std::filesystem::path source = directory / path.filename();
+	std::filesystem::create_directories(directory, error);
+	if (!std::filesystem::copy_file(path, source, std::filesystem::copy_options::overwrite_existing, error)
+		|| !Plugins::Load(source))
+	{
+		std::fwprintf(stderr, L"failed to load a copy of %ls\n", path.c_str());
+		return false;
+	}
+
+	// Every plugin the original module registered is still available, which used to let the empty copy through
+	std::vector<size_t> entries;
+	for (const Plugin& plugin : Plugins::Get())
+	{
+		if (plugin.Source == source)
+		{
+			entries.push_back(plugin.Index);
+		}
+	}
+
+	const auto available = [&entries]()
+	{
+		return std::all_of(entries.begin(), entries.end(), [](size_t index) { return Plugins::Get()[index].Available; });
+	};
+
+	wchar_t system[MAX_PATH];
+	const UINT length = ::GetSystemDirectoryW(system, MAX_PATH);
+	const std::filesystem::path empty = std::filesystem::path(std::wstring(system, length)) / L"version.dll";
+	std::filesystem::copy_file(empty, source, std::filesystem::copy_options::overwrite_existing, error);
+	const bool kept = !error && !entries.empty() && Plugins::Reload(source) == nullptr && available();
+
+	std::filesystem::copy_file(path, source, std::filesystem::copy_options::overwrite_existing, error);
+	const bool reloaded = !error && Plugins::Reload(source) != nullptr && available();
+
+	std::wprintf(
+		L"%ls: previous module %ls an empty rebuild, %ls the real one\n",
+		path.filename().c_str(),
+		kept ? L"kept across" : L"LOST to",
+		reloaded ? L"replaced by" : L"NOT REPLACED by");
+	return kept && reloaded;
+}
+
+int wmain(int argc, wchar_t* argv[])
+{
+	// The sandboxes launched by --reload run the plugin in another instance of us
+	if (argc == 3 && std::wstring(argv[1]) == L"--sandbox")
+	{
+		GUARD(::CoInitializeEx(nullptr, COINITBASE_MULTITHREADED), result) {
+			return 1;
+		}
+
+		int status = 1;
+		try
+		{
+			status = Dance::Application::Sandbox::Run(argv[2]);
+		}
+		catch (const std::exception& error)
+		{
+			std::fwprintf(stderr, L"sandbox failed: %hs\n", error.what());
+		}
+
+		::CoUninitialize();
+		return status;
+	}
+
+	Arguments arguments;
+	if (!Parse(argc, argv, arguments))
+	{
+		Usage();
+		return 1;
+	}
+
+	if (arguments.Math)
+	{
+		Dance::Bench::Kernels(1000000);
+		std::wprintf(L"\n");
+		Dance::Bench::Operations(1000000);
+		return 0;
+	}
+
+	if (arguments.Plugins.empty())
+	{
+		const std::filesystem::path directory = GetModulePath().parent_path() / L"Visualizers";
+		std::error_code error;
+		for (const auto& entry : std::filesystem::recursive_directory_iterator(directory, error))
+		{
+			if (entry.is_regular_file() && entry.path().extension() == L".dll")
+			{
+				arguments.Plugins.push_back(entry.path());
+			}
+		}
+	}
+
+	// Count our own allocations from here on; each plugin is redirected as it's loaded
+	Redirect(::GetModuleHandleW(nullptr));
+
+	GUARD(::CoInitializeEx(nullptr, COINITBASE_MULTITHREADED), result) {
+		std::fwprintf(stderr, L"failed to initialize threading model: 0x%08lx\n", result);
+		return 1;
+	}
+
+	int status = 0;
+	try
+	{
+		Dance::Application::Offscreen host(arguments.Width, arguments.Height, !arguments.Hardware);
+		for (const std::filesystem::path& path : arguments.Plugins)
+		{
+			// Plugins register themselves with our _Register export when loaded, so note which ones are new. The
+			// libraries are never closed since the registry holds onto functions that live in them.
+			const size_t before = Plugins::Get().size();
+			if (arguments.Reload)
+			{
+				// Sandboxes load the plugin again from the source it registered from, which only Plugins::Load records
+				if (!Plugins::Load(path))
+				{
+					std::fwprintf(stderr, L"failed to load %ls\n", path.c_str());
+					status = 1;
+					continue;
+				}
+			}
+			else if (Dance::Library::Handle library = Dance::Library::Open(path); library == nullptr)
+			{
+				std::fwprintf(stderr, L"failed to load %ls: %hs\n", path.c_str(), Dance::Library::Error().c_str());
+				status = 1;
+				continue;
+			}
+			else
+			{
+				Redirect(library);
+			}
+
+			for (size_t i = before; i < Plugins::Get().size(); ++i)
+			{
+				if (!arguments.Reload)
+				{
+					Run(Plugins::Get()[i], host, arguments);
+				}
+				else if (!Handoff(Plugins::Get()[i], host, arguments))
+				{
+					status = 1;
+				}
+			}
+		}
+
+		if (arguments.Reload && !arguments.Plugins.empty() && !Survives(arguments.Plugins.front()))
+		{
+			status = 1;
+		}
+	}
+	catch (const std::exception& error)
+	{
+		std::fwprintf(stderr, L"%hs\n", error.what());
+		status = 1;
+	}
+
+	::CoUninitialize();
+	return status;
+}
@@ -0,0 +1,218 @@
+#include "Operations.h"
+#include "Mathematics.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <cwchar>
+#include <limits>
+#include <random>
+#include <tuple>
+#include <vector>
+
+using namespace Dance::Three::Math;
+
+namespace Dance::Bench
+{
+	/// Elements per array in the cache-hot runs. Even the largest operands, three arrays of 4x4 matrices, fit in a
+	/// typical L2 cache.
+	constexpr size_t HOT = 1024;
+
+	/// Total bytes across every array in the cache-cold runs, comfortably more than any last level cache, so each pass
+	/// evicts what the previous one loaded.
+	constexpr size_t COLD = 256 * 1024 * 1024;
+
+	/// Each measurement is repeated and the fastest kept, which discards passes interrupted by the scheduler.
+	constexpr int REPEATS = 3;
+
+	/// Results are folded into this so the compiler can't discard the work.
+	static volatile float sink = 0.0f;
+
+	/// Fold the first component of any of the math types into the sink.
+	template<typename T>
+	static void Consume(const T& value)
+	{
+		float first;
+		std::memcpy(&first, &value, sizeof(first));
+		sink += first;
+	}
+
+	/// Random operands shaped like real data: unit-range vectors, unit quaternions, and matrices built from rotations,
+	/// translations and positive scales so that they can be inverted.
+	template<typename T>
+	static T Random(std::mt19937& random);
+
+	static float Uniform(std::mt19937& random)
+	{
+		return std::uniform_real_distribution<float>(-1.0f, 1.0f)(random);
+	}
+
+	template<>
+	Vector2F Random(std::mt19937& random)
+	{
+		return Vector2F(Uniform(random), Uniform(random));
+	}
+
+	template<>
+	Vector3F Random(std::mt19937& random)
+	{
+		return Vector3F(Uniform(random), Uniform(random), Uniform(random));
+	}
+
+	template<>
+	Vector4F Random(std::mt19937& random)
+	{
+		return Vector4F(Uniform(random), Uniform(random), Uniform(random), 1.0f);
+	}
+
+	template<>
+	QuaternionF Random(std::mt19937& random)
+	{
+		return QuaternionF(Random<Vector3F>(random).Normalized(), Pi * Uniform(random));
+	}
+
+	template<>
+	Matrix3F Random(std::mt19937& random)
+	{
+		return Matrix3F::Scale(1.5f + Uniform(random), 1.5f + Uniform(random))
+			* Matrix3F::Rotation(Pi * Uniform(random))
+			* Matrix3F::Translation(Random<Vector2F>(random));
+	}
+
+	template<>
+	Matrix4F Random(std::mt19937& random)
+	{
+		return TransformationF(Random<Vector3F>(random), Random<QuaternionF>(random), 1.5f + Uniform(random)).Matrix();
+	}
+
+	/// An array of count random operands.
+	template<typename T>
+	static std::vector<T> Fill(std::mt19937& random, size_t count)
+	{
+		std::vector<T> values(count);
+		for (T& value : values)
+		{
+			value = Random<T>(random);
+		}
+		return values;
+	}
+
+	/// Nanoseconds per element of an operation mapped over count elements, passing over the same arrays until about
+	/// budget elements have been processed.
+	template<typename R, typename... A, typename F>
+	static double Pass(size_t count, size_t budget, F& operation)
+	{
+		std::mt19937 random(static_cast<unsigned>(count));
+		const std::tuple<std::vector<A>...> inputs{ Fill<A>(random, count)... };
+		std::vector<R> out(count);
+
+		const size_t passes = std::max<size_t>(1, budget / count);
+		double best = std::numeric_limits<double>::max();
+		for (int repeat = 0; repeat < REPEATS; ++repeat)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			for (size_t pass = 0; pass < passes; ++pass)
+			{
+				std::apply([&](const auto&... in)
+				{
+					for (size_t i = 0; i < count; ++i)
+					{
+						out[i] = operation(in[i]...);
+					}
+				}, inputs);
+			}
+			const auto end = std::chrono::steady_clock::now();
+			best = std::min(best, std::chrono::duration<double, std::nano>(end - start).count() / (passes * count));
+		}
+
+		Consume(out[count / 2]);
+		return best;
+	}
+
+	/// Time an operation taking arguments of types A and returning R, hot and cold, and print a row of the table.
+	template<typename R, typename... A, typename F>
+	static void Row(const wchar_t* label, size_t budget, F&& operation)
+	{
+		const size_t cold = COLD / (sizeof(R) + (sizeof(A) + ...));
+		const double hot = Pass<R, A...>(HOT, budget, operation);
+		const double streamed = Pass<R, A...>(cold, std::max(budget, cold), operation);
+		std::wprintf(L"  %-28ls %9.2f %9.2f %8.2fx\n", label, hot, streamed, streamed / hot);
+	}
+
+	void Operations(size_t budget)
+	{
+		std::wprintf(L"math operations (%zu hot, %zu MiB cold)\n", HOT, COLD / (1024 * 1024));
+		std::wprintf(L"  %-28ls %9ls %9ls %9ls\n", L"ns per element", L"hot", L"cold", L"slowdown");
+
+		Row<Vector2F, Vector2F>(L"Vector2 normalize", budget, [](const Vector2F& v)
+		{
+			return v.Normalized();
+		});
+		Row<Vector2F, Matrix3F, Vector2F>(L"Vector2 transform by Matrix3", budget, [](const Matrix3F& m, const Vector2F& v)
+		{
+			return Transform(m, v, 1.0f);
+		});
+
+		Row<Vector3F, Vector3F, Vector3F>(L"Vector3 cross", budget, [](const Vector3F& a, const Vector3F& b)
+		{
+			return Cross(a, b);
+		});
+		Row<Vector3F, Vector3F>(L"Vector3 normalize", budget, [](const Vector3F& v)
+		{
+			return v.Normalized();
+		});
+		Row<Vector3F, Matrix4F, Vector3F>(L"Vector3 transform by Matrix4", budget, [](const Matrix4F& m, const Vector3F& v)
+		{
+			return Transform(m, v);
+		});
+
+		Row<Vector4F, Vector4F, Vector4F>(L"Vector4 lerp", budget, [](const Vector4F& a, const Vector4F& b)
+		{
+			return Lerp(a, b, 0.3f);
+		});
+		Row<Vector4F, Matrix4F, Vector4F>(L"Vector4 transform by Matrix4", budget, [](const Matrix4F& m, const Vector4F& v)
+		{
+			return Transform(m, v);
+		});
+
+		Row<Matrix3F, Matrix3F, Matrix3F>(L"Matrix3 multiply", budget, [](const Matrix3F& a, const Matrix3F& b)
+		{
+			return a * b;
+		});
+		Row<Matrix3F, Matrix3F>(L"Matrix3 transpose", budget, [](const Matrix3F& m)
+		{
+			return m.Transposed();
+		});
+
+		Row<Matrix4F, Matrix4F, Matrix4F>(L"Matrix4 multiply", budget, [](const Matrix4F& a, const Matrix4F& b)
+		{
+			return a * b;
+		});
+		Row<Matrix4F, Matrix4F>(L"Matrix4 invert", budget, [](const Matrix4F& m)
+		{
+			return m.Inverted();
+		});
+		Row<Matrix4F, Matrix4F>(L"Matrix4 invert affine", budget, [](const Matrix4F& m)
+		{
+			return m.InvertedAffine();
+		});
+		Row<Matrix4F, Matrix4F>(L"Matrix4 transpose", budget, [](const Matrix4F& m)
+		{
+			return m.Transposed();
+		});
+
+		Row<QuaternionF, QuaternionF, QuaternionF>(L"Quaternion concatenate", budget, [](const QuaternionF& a, const QuaternionF& b)
+		{
+			return Concatenate(a, b);
+		});
+		Row<QuaternionF, QuaternionF, QuaternionF>(L"Quaternion slerp", budget, [](const QuaternionF& a, const QuaternionF& b)
+		{
+			return Slerp(a, b, 0.3f);
+		});
+		Row<Vector3F, QuaternionF, Vector3F>(L"Quaternion rotate Vector3", budget, [](const QuaternionF& q, const Vector3F& v)
+		{
+			return Transform(q, v);
+		});
+	}
+}
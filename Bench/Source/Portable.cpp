@@ -0,0 +1,25 @@
+#include "Kernels.h"
+#include "Operations.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cwchar>
+
+// Entry point for the math benchmarks alone, which only need the standard library and the header-only math. It isn't
+// part of Bench.vcxproj, where Bench --math runs the same thing; it exists so that the math headers can be measured
+// with GCC and Clang as well, see the README.
+
+int main(int argc, char* argv[])
+{
+	const size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+	if (iterations == 0)
+	{
+		std::fprintf(stderr, "usage: %s [ITERATIONS]\n", argv[0]);
+		return 1;
+	}
+
+	Dance::Bench::Kernels(iterations);
+	std::wprintf(L"\n");
+	Dance::Bench::Operations(iterations);
+	return 0;
+}
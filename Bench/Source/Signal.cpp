@@ -0,0 +1,166 @@
+#include "Signal.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+
+namespace Dance::Bench
+{
+	/// Length of the synthesized loop.
+	constexpr uint32_t SYNTHESIZED_SECONDS = 8;
+
+	constexpr double PI = 3.14159265358979323846;
+
+	Signal::Signal(uint32_t sampleRate) : sampleRate(sampleRate)
+	{
+		const size_t count = static_cast<size_t>(sampleRate) * SYNTHESIZED_SECONDS;
+		this->samples.resize(count * 2);
+
+		std::mt19937 generator(0);
+		std::uniform_real_distribution<float> noise(-0.02f, 0.02f);
+
+		double sweepPhase = 0.0;
+		for (size_t i = 0; i < count; ++i)
+		{
+			const double t = static_cast<double>(i) / sampleRate;
+
+			// Kick-like 55 Hz tone that decays over each beat
+			const double beat = std::fmod(t, 0.5);
+			const double bass = 0.5 * std::exp(-8.0 * beat) * std::sin(2.0 * PI * 55.0 * t);
+
+			// Exponential sweep from 100 Hz to 10 kHz over the loop, integrated so the phase stays continuous
+			const double frequency = 100.0 * std::pow(100.0, t / SYNTHESIZED_SECONDS);
+			sweepPhase += 2.0 * PI * frequency / sampleRate;
+			const double sweep = 0.2 * std::sin(sweepPhase);
+
+			const float sample = static_cast<float>(bass + sweep) + noise(generator);
+			this->samples[i * 2] = sample;
+			this->samples[i * 2 + 1] = sample;
+		}
+	}
+
+	/// Read a little-endian value out of a byte buffer.
+	template<typename T>
+	static T Little(const std::vector<char>& bytes, size_t offset)
+	{
+		if (offset + sizeof(T) > bytes.size())
+		{
+			throw std::runtime_error("truncated WAV file");
+		}
+
+		T value;
+		std::memcpy(&value, bytes.data() + offset, sizeof(T));
+		return value;
+	}
+
+	Signal::Signal(const std::filesystem::path& recording)
+	{
+		std::ifstream file(recording, std::ios::binary);
+		if (!file)
+		{
+			throw std::runtime_error("failed to open " + recording.string());
+		}
+
+		const std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		if (bytes.size() < 12 || std::memcmp(bytes.data(), "RIFF", 4) != 0 || std::memcmp(bytes.data() + 8, "WAVE", 4) != 0)
+		{
+			throw std::runtime_error("not a WAV file: " + recording.string());
+		}
+
+		// http://soundfile.sapp.org/doc/WaveFormat/
+		uint16_t format = 0;
+		uint16_t channels = 0;
+		uint16_t bitsPerSample = 0;
+		size_t dataOffset = 0;
+		size_t dataSize = 0;
+		for (size_t offset = 12; offset + 8 <= bytes.size();)
+		{
+			const uint32_t chunkSize = Little<uint32_t>(bytes, offset + 4);
+			if (std::memcmp(bytes.data() + offset, "fmt ", 4) == 0)
+			{
+				format = Little<uint16_t>(bytes, offset + 8);
+				channels = Little<uint16_t>(bytes, offset + 10);
+				this->sampleRate = Little<uint32_t>(bytes, offset + 12);
+				bitsPerSample = Little<uint16_t>(bytes, offset + 22);
+
+				// WAVE_FORMAT_EXTENSIBLE keeps the real format tag at the start of the sub-format GUID
+				if (format == 0xFFFE)
+				{
+					format = Little<uint16_t>(bytes, offset + 32);
+				}
+			}
+			else if (std::memcmp(bytes.data() + offset, "data", 4) == 0)
+			{
+				dataOffset = offset + 8;
+				dataSize = std::min<size_t>(chunkSize, bytes.size() - dataOffset);
+			}
+
+			// Chunks are padded to an even size
+			offset += 8 + chunkSize + (chunkSize & 1);
+		}
+
+		const bool pcm16 = format == 1 && bitsPerSample == 16;
+		const bool float32 = format == 3 && bitsPerSample == 32;
+		if (!(pcm16 || float32) || channels < 1 || channels > 2 || this->sampleRate == 0)
+		{
+			throw std::runtime_error("unsupported WAV format: " + recording.string());
+		}
+
+		// Reading loops around the samples, so we need at least one whole frame
+		const size_t count = dataSize / (bitsPerSample / 8) / channels;
+		if (count == 0)
+		{
+			throw std::runtime_error("WAV file has no samples: " + recording.string());
+		}
+
+		this->samples.resize(count * 2);
+		for (size_t i = 0; i < count; ++i)
+		{
+			for (size_t channel = 0; channel < 2; ++channel)
+			{
+				// Duplicate mono into both channels
+				const size_t index = i * channels + std::min<size_t>(channel, channels - 1);
+				this->samples[i * 2 + channel] = pcm16
+					? Little<int16_t>(bytes, dataOffset + index * 2) / 32768.0f
+					: Little<float>(bytes, dataOffset + index * 4);
+			}
+		}
+	}
+
+	uint32_t Signal::SampleRate() const
+	{
+		return this->sampleRate;
+	}
+
+	void Signal::Reserve(size_t count)
+	{
+		this->scratch.reserve(count * 2);
+	}
+
+	size_t Signal::Read(const float*& frames, size_t count)
+	{
+		const size_t length = this->samples.size() / 2;
+
+		// Hand out a pointer straight into the loop unless we'd run off the end
+		if (this->position + count <= length)
+		{
+			frames = this->samples.data() + this->position * 2;
+			this->position = (this->position + count) % length;
+			return count;
+		}
+
+		this->scratch.resize(count * 2);
+		for (size_t i = 0; i < count; ++i)
+		{
+			this->scratch[i * 2] = this->samples[this->position * 2];
+			this->scratch[i * 2 + 1] = this->samples[this->position * 2 + 1];
+			this->position = (this->position + 1) % length;
+		}
+
+		frames = this->scratch.data();
+		return count;
+	}
+}
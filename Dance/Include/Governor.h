@@ -0,0 +1,100 @@
+#pragma once
+
+#include "Framework.h"
+
+#include <endpointvolume.h>
+
+namespace Dance::Application
+{
+    /// Lowers the frame rate while the output device is silent. The peak meter of the default render endpoint is cheap
+    /// enough to read every tick, and unlike our own analysis it's available regardless of which visualizer is active
+    /// or whether it captures audio itself. Once the device has been silent for a while the governor only admits a
+    /// few frames per second, and in between it asks the caller to sleep for at most one full-rate frame so that it
+    /// notices the signal coming back right away.
+    class Governor
+    {
+    public:
+        /// Default seconds of silence before throttling.
+        static constexpr double SILENCE = 30.0;
+
+        /// Default frames per second while throttled.
+        static constexpr double RATE = 5.0;
+
+        /// Running totals reported by the governor.
+        struct Statistics
+        {
+            /// Number of times the governor went idle.
+            uint64_t Idled;
+
+            /// Full-rate frames that weren't updated or rendered.
+            uint64_t Skipped;
+
+            /// Estimated CPU seconds saved by skipping them, in our process and the sandboxes it launched.
+            double Saved;
+        };
+
+        /// Create a governor with the default settings. It admits every frame until Governor::Create succeeds.
+        Governor();
+
+        /// Bind to the peak meter of the default audio output device. Requires COM to be initialized.
+        ///
+        /// @returns an HRESULT indicating success.
+        HRESULT Create();
+
+        /// Change when and how far the frame rate is lowered.
+        ///
+        /// @param silence is the number of seconds without signal before going idle.
+        /// @param rate is the number of frames per second to admit while idle.
+        void Configure(double silence, double rate);
+
+        /// Decide whether the visualizer should update and render this tick.
+        ///
+        /// @returns true unless the governor is idle and it's too soon for the next idle frame.
+        bool Admit();
+
+        /// How long the caller should wait for input before asking again after Governor::Admit returns false.
+        ///
+        /// @returns a timeout in milliseconds.
+        DWORD Wait() const;
+
+        /// Get the running totals.
+        ///
+        /// @returns a reference to the statistics.
+        const Statistics& Report() const;
+
+    private:
+        ComPtr<IAudioMeterInformation> meter;
+
+        /// Seconds of silence before going idle.
+        double silence;
+
+        /// Frames per second while idle.
+        double rate;
+
+        /// Whether we're currently throttling.
+        bool idle{ false };
+
+        /// Counter value when the current silence started, or zero if there's signal.
+        uint64_t quiet{ 0 };
+
+        /// Counter value of the last admitted frame.
+        uint64_t last{ 0 };
+
+        /// Frames admitted and CPU time when the current full-rate period began.
+        uint64_t frames{ 0 };
+        uint64_t framesAtActive{ 0 };
+        double cpuAtActive{ 0.0 };
+
+        /// Average CPU seconds per frame over the last full-rate period.
+        double cost{ 0.0 };
+
+        Statistics statistics{};
+
+        /// Seconds elapsed since a counter value.
+        static double Since(uint64_t then, uint64_t now);
+
+        /// Total user and kernel time of this process and the sandboxes it launched in seconds. Visualizers run in a
+        /// sandbox by default, so that's where most of the time we save is spent.
+        static double Cpu();
+    };
+}
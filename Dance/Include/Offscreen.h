@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Options.h"
+
+#include <windows.h>
+#include <dxgi1_2.h>
+#include <d3d11_4.h>
+#include <d2d1_2.h>
+#pragma comment(lib, "dxgi.lib")
+#pragma comment(lib, "d3d11.lib")
+#pragma comment(lib, "d2d1.lib")
+
+#include "Visualizer.h"
+#include "Macro.h"
+#include "Pointer.h"
+
+namespace Dance::Application
+{
+    using Dance::API::Visualizer;
+
+    /// Offscreen stand-in for the visualizer window, used by the benchmark and by sandboxed plugin processes. Creates
+    /// the same D3D11, DXGI, and D2D objects as the TransparentWindow but never shows anything: the swap chain is 
+    /// created for composition and is never attached to a visual, so presenting it is effectively a null backend.
+    /// Plugins still query their size through the window handle in their dependencies, so we also create a hidden 
+    /// popup window of the requested size.
+    class Offscreen
+    {
+    public:
+        /// Create the device objects and hidden window.
+        ///
+        /// @param width is the pixel width of the offscreen surface.
+        /// @param height is the pixel height of the offscreen surface.
+        /// @param warp selects the WARP software rasterizer instead of a hardware adapter, which works on machines
+        /// without a GPU or display.
+        /// @throws ComError if any of the device objects fail to initialize.
+        Offscreen(UINT width, UINT height, bool warp);
+
+        /// Destroy the hidden window.
+        ~Offscreen();
+
+        /// Resize the hidden window and swap chain buffers. Visualizers must release their size-dependent resources
+        /// beforehand via Visualizer::Unsize.
+        ///
+        /// @param width is the new pixel width.
+        /// @param height is the new pixel height.
+        /// @returns an HRESULT indicating success.
+        HRESULT Resize(UINT width, UINT height);
+
+        /// Provide dependencies to visualizer instantiation, mirroring VisualizerWindow::Dependencies.
+        ///
+        /// @returns a POD containing handles to the offscreen graphical resources.
+        Visualizer::Dependencies Dependencies() const;
+
+    private:
+        /// Hidden window plugins can query their client rectangle from.
+        HWND window;
+
+        ComPtr<ID3D11Device> d3dDevice;
+        ComPtr<IDXGIDevice> dxgiDevice;
+        ComPtr<IDXGIFactory2> dxgiFactory;
+        ComPtr<IDXGISwapChain1> dxgiSwapChain;
+        ComPtr<ID2D1Factory2> d2dFactory;
+        ComPtr<ID2D1Device1> d2dDevice;
+    };
+}
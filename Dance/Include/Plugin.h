@@ -3,11 +3,13 @@
 #include <functional>
 #include <vector>
 #include <filesystem>
+#include <memory>
 #include <utility>
 #include <cstdint>
 
 #include "Visualizer.h"
 #include "Macro.h"
+#include "Pointer.h"
 
 namespace Dance::Application
 {
@@ -28,6 +30,40 @@ namespace Dance::Application
 
         /// A matching destructor for the plugin's visualizer.
         Visualizer::Destructor Destructor;
+
+        /// The DLL in the Visualizers directory that registered the plugin. Used to match the registration back up
+        /// when the DLL is rebuilt and reloaded.
+        std::filesystem::path Source;
+
+        /// Whether the plugin was registered through the C ABI, in which case its visualizers expect the host to
+        /// provide the shared feature block.
+        bool Shared{ false };
+
+        /// Whether the plugin can be instantiated. Cleared when a rebuilt DLL stops registering it, in which case the
+        /// entry keeps its index but no longer holds a constructor or destructor.
+        bool Available{ true };
+    };
+
+    /// A plugin DLL loaded from the Visualizers directory. Windows locks any module that's been passed to 
+    /// ::LoadLibrary, which would prevent a rebuild from overwriting it, so we instead load a shadow copy that lives
+    /// next to the original. The copy is kept in the same directory so that plugins resolving resources relative to
+    /// their own module path, e.g. shaders, keep working.
+    struct Module
+    {
+        /// The original DLL we watch for changes.
+        std::filesystem::path Source;
+
+        /// The copy of the DLL that we actually loaded.
+        std::filesystem::path Shadow;
+
+        /// The last write time of the source when we copied it.
+        std::filesystem::file_time_type Written;
+
+        /// The loaded shadow copy. Released before the shadow file is deleted.
+        LibraryHandle Library;
+
+        /// Free the library and clean up the shadow copy.
+        ~Module();
     };
 
     /// A static singleton for managing plugins loaded at runtime. The private Plugins::Vector method returns a static
@@ -36,15 +72,49 @@ namespace Dance::Application
     class Plugins
     {
     public:
-        /// Execute ::LoadLibrary on all DLL files in the adjacent Visulizers directory.
+        /// Execute ::LoadLibrary on shadow copies of all DLL files in the adjacent Visulizers directory, then start
+        /// watching the directory for changes.
         static void Load();
 
+        /// Load a shadow copy of a single DLL without scanning or watching the Visualizers directory. This is how a
+        /// sandboxed plugin process loads the one plugin it hosts.
+        /// 
+        /// @param source is the path of the DLL in the Visualizers directory.
+        /// @returns whether the DLL was loaded.
+        static bool Load(const std::filesystem::path& source);
+
+        /// Check whether any loaded DLL has been overwritten since we loaded it. This is cheap enough to call every
+        /// tick, as we only stat the DLLs once the directory change notification has been signaled.
+        /// 
+        /// @returns the source paths of the DLLs that have changed.
+        static std::vector<std::filesystem::path> Modified();
+
+        /// Load a fresh shadow copy of a modified DLL. The plugins it registers overwrite the constructors and 
+        /// destructors of the existing entries with the same name, so indices and references remain valid. Entries
+        /// the new copy doesn't register again are marked unavailable and cleared, as they'd otherwise point into the
+        /// previous module once it's freed. The previous module is handed back rather than freed so that the caller
+        /// can destroy any visualizers it constructed before its code is unloaded.
+        /// 
+        /// @param source is the path of the DLL in the Visualizers directory, as returned by Plugins::Modified.
+        /// @returns the retired module, or nullptr if the new copy could not be loaded, e.g. because the build is 
+        /// still writing it, or registered nothing for this source. In that case the previous module remains
+        /// registered.
+        static std::unique_ptr<Module> Reload(const std::filesystem::path& source);
+
         /// Add a new plugin to the static registrar.
         /// 
         /// @param name is the user-facing name of the provided visualizer.
         /// @param constructor constructs a new visualizer and returns a pointer to it.
         /// @param destructor properly deallocates the pointer returned by the constructor.
-        static void Register(const std::wstring& name, const Visualizer::Constructor& constructor, const Visualizer::Destructor& destructor);
+        /// @param shared indicates that the visualizer reads the shared feature block.
+        static void Register(const std::wstring& name, const Visualizer::Constructor& constructor, const Visualizer::Destructor& destructor, bool shared = false);
+
+        /// Add a new plugin registered through the C ABI. The plugin's function table is wrapped in a visualizer
+        /// owned by the runtime, so none of the C++ standard library types in our own API cross the module boundary.
+        /// 
+        /// @param plugin describes the visualizer and the ABI version it was built against.
+        /// @returns whether the plugin is compatible with the runtime and was registered.
+        static bool Register(const DancePlugin& plugin);
 
         /// Get a constant handle to the static vector of registered plugins.
         /// 
@@ -54,7 +124,7 @@ namespace Dance::Application
         /// Get the first available plugin, assumes there is at least one in the vector. This is used for convenient
         /// initialization of the initial reference value.
         /// 
-        /// @returns the first registered plugin.
+        /// @returns the first registered plugin that's still available, or the first registered one if none are.
         static const Plugin& First();
 
     private:
@@ -62,11 +132,27 @@ namespace Dance::Application
         ///
         /// @returns a mutable reference to the plugin vector.
         static std::vector<Plugin>& Vector();
+
+        /// Static container for the modules we've loaded.
+        ///
+        /// @returns a mutable reference to the module vector.
+        static std::vector<std::unique_ptr<Module>>& Modules();
+
+        /// The source path of the DLL currently being loaded, which Plugins::Register attributes registrations to.
+        ///
+        /// @returns a mutable reference to the path, which is empty outside of Plugins::Open.
+        static std::filesystem::path& Loading();
+
+        /// Copy a DLL to a new shadow path and load it.
+        ///
+        /// @param source is the path of the DLL in the Visualizers directory.
+        /// @returns the loaded module, or nullptr if copying or loading failed.
+        static std::unique_ptr<Module> Open(const std::filesystem::path& source);
     };
 
     /// Externally visible info method. Used to identify compatibility between plugin and runtime.
     ///
-    /// @returns a Dance::API::About, which is a version struct.
+    /// @returns a Dance::API::About containing the plugin ABI version implemented by the runtime.
     extern "C" __declspec(dllexport) Dance::API::About _Dance();
 
     /// Externally visible registration method. Shadows Plugins::Register.
@@ -80,4 +166,10 @@ namespace Dance::Application
         const Visualizer::Constructor& constructor,
         const Visualizer::Destructor& destructor
     );
+
+    /// Externally visible C ABI registration method. Shadows Plugins::Register.
+    ///
+    /// @param plugin describes the visualizer and the ABI version it was built against.
+    /// @returns nonzero if the plugin was registered.
+    extern "C" __declspec(dllexport) int32_t _RegisterTable(const DancePlugin* plugin);
 }
@@ -0,0 +1,210 @@
+#pragma once
+
+#include "Framework.h"
+#include "Plugin.h"
+#include "Path.h"
+
+namespace Dance::Application
+{
+    /// One frame of input published by the runtime to a sandboxed visualizer. Slots are written in a ring and guarded
+    /// by a sequence number that is odd while the runtime is writing, so the sandbox can tell if a copy was torn. The
+    /// spectrum and bands follow the struct, sized by SandboxHeader::SpectrumCapacity and BandCapacity.
+    struct SandboxSlot
+    {
+        volatile LONG64 Sequence;
+
+        /// Seconds of runtime updates up to and including this frame, so that deltas survive dropped frames.
+        double Elapsed;
+
+        /// Nonzero if the runtime is publishing features for this plugin.
+        uint32_t Analyzed;
+
+        uint32_t SampleRate;
+        uint32_t SpectrumSize;
+        uint32_t BandCount;
+        uint64_t Frame;
+        float Level;
+        float Peak;
+    };
+
+    /// Control block at the start of the shared memory a sandbox is launched with. Fields under "runtime" are only
+    /// written by the runtime and fields under "sandbox" only by the sandbox. The slot ring follows the header, and
+    /// room for the visualizer's serialized state follows the ring.
+    struct SandboxHeader
+    {
+        // Runtime: written before the sandbox is launched
+        wchar_t Source[DANCE_MAX_PATH];
+        wchar_t Name[128];
+        uint32_t SpectrumCapacity;
+        uint32_t BandCapacity;
+        uint32_t SlotCount;
+        uint32_t SlotSize;
+        uint32_t StateOffset;
+        uint32_t StateCapacity;
+
+        // Runtime: the number of frames published, the latest of which is in slot Published % SlotCount
+        volatile LONG64 Published;
+
+        // Runtime: requested surface size, with Sized incremented on every change
+        volatile LONG Width;
+        volatile LONG Height;
+        volatile LONG Sized;
+
+        // Runtime: set to ask the sandbox to exit
+        volatile LONG Quit;
+
+        // Runtime: a handle to the runtime process, duplicated into each sandbox as it's launched, so that it can exit
+        // if the runtime dies without asking it to. Zero if it couldn't be duplicated.
+        uint64_t Parent;
+
+        // Sandbox: the number of frames rendered, which doubles as a heartbeat
+        volatile LONG64 Rendered;
+
+        // Sandbox: generation of the shared surface, zero until the first one is created
+        volatile LONG Surface;
+
+        // Both: bytes of visualizer state waiting in the state area. The runtime sets this to hand state to the next
+        // sandbox, which restores and clears it as it launches, and the sandbox sets it as it quits.
+        volatile LONG StateSize;
+    };
+
+    /// Runtime-side proxy for a visualizer running in a child process. A slow or crashing plugin can then no longer
+    /// stall or kill the window. Each update publishes the elapsed time and shared features to a ring in shared memory
+    /// and signals the sandbox, without waiting for it, so that the plugin renders while we capture and analyze the
+    /// next frame. The sandbox copies each frame it renders into a shared texture, which we copy into our own swap
+    /// chain on render. A watchdog relaunches the sandbox if it exits or stops making progress; audio capture lives
+    /// in the runtime and carries on uninterrupted. Sandboxes exit with the runtime even when it crashes or is killed.
+    ///
+    /// State is carried across a hot reload through the shared memory: the sandbox serializes its visualizer as it
+    /// quits and restores whatever state is waiting as it launches. The sandbox is launched on the first update rather
+    /// than on construction so that state handed to Restore is there in time.
+    class SandboxVisualizer : public Visualizer
+    {
+    public:
+        /// Create the shared memory. The sandbox is launched by the first update.
+        ///
+        /// @param plugin is the plugin to host. Its DLL is loaded again by the sandbox.
+        /// @param dependencies are the runtime's graphics resources and shared features.
+        /// @throws ComError if the shared memory can't be created.
+        SandboxVisualizer(const Plugin& plugin, const Visualizer::Dependencies& dependencies);
+
+        /// Ask the sandbox to exit, terminating it if it doesn't.
+        virtual ~SandboxVisualizer();
+
+        virtual HRESULT Unsize();
+        virtual HRESULT Resize(const RECT& size);
+        virtual void Render();
+
+        /// Launch the sandbox if it isn't running, then publish a frame.
+        ///
+        /// @throws ComError if the sandbox process can't be created.
+        virtual void Update(double delta);
+
+        /// Ask the sandbox to quit and collect the state it writes on the way out. The watchdog relaunches it on the
+        /// next update, restoring the same state, in case the visualizer is kept after all.
+        ///
+        /// The wait is bounded by the watchdog's interval since this is called on the UI thread. A sandbox that doesn't
+        /// quit in time is terminated and its state given up on.
+        ///
+        /// @returns the visualizer's state, or nothing if the sandbox didn't quit in time.
+        virtual std::vector<uint8_t> Serialize() const;
+
+        /// Leave state for the sandbox to restore the next time it launches, which for a new visualizer is its first
+        /// update. State that doesn't fit in the shared memory is dropped.
+        virtual void Restore(const std::vector<uint8_t>& state);
+
+        /// Total user and kernel time of every sandbox this process has launched, including the ones that have since
+        /// exited, as measured by the job object they're launched into.
+        ///
+        /// @returns the time in seconds.
+        static double Cpu();
+
+    private:
+        Visualizer::Dependencies dependencies;
+        ComPtr<ID3D11Device1> d3dDevice;
+        ComPtr<ID3D11DeviceContext> d3dDeviceContext;
+
+        /// Unique suffix for the names of the shared objects.
+        std::wstring id;
+
+        KernelHandle mapping;
+        MappedView view;
+        SandboxHeader* header;
+
+        /// Auto-reset event signaled for every published frame.
+        KernelHandle frame;
+
+        /// The sandbox process.
+        KernelHandle process;
+
+        /// The sandbox's shared surface as opened on our device.
+        ComPtr<ID3D11Texture2D> surface;
+        ComPtr<IDXGIKeyedMutex> surfaceMutex;
+        LONG surfaceGeneration{ 0 };
+
+        /// The last rendered frame we presented.
+        LONG64 shown{ 0 };
+
+        /// Total seconds of updates, published with every frame.
+        double elapsed{ 0.0 };
+
+        /// Watchdog state: the last rendered count we saw and the counter value when it last changed.
+        LONG64 watched{ 0 };
+        uint64_t progressed{ 0 };
+
+        /// How many times the watchdog has relaunched the sandbox.
+        size_t restarts{ 0 };
+
+        /// Start a new sandbox process against the current shared memory.
+        void Launch();
+
+        /// Relaunch the sandbox if it has exited or hung.
+        void Watch();
+
+        /// Write the next frame of input to the ring and wake the sandbox.
+        ///
+        /// @param delta is the number of seconds since the last update.
+        void Publish(double delta);
+    };
+
+    /// Child-process side of SandboxVisualizer.
+    class Sandbox
+    {
+    public:
+        /// Host the visualizer described by the shared memory with the given ID until asked to quit. Invoked from
+        /// wWinMain when the executable is launched with --sandbox.
+        ///
+        /// @param id is the unique suffix of the shared object names.
+        /// @returns the process exit code.
+        static int Run(const std::wstring& id);
+    };
+
+    /// Get a slot in the shared memory ring.
+    ///
+    /// @param header is the start of the shared memory.
+    /// @param index is the slot index, which wraps around the ring.
+    /// @returns a pointer to the slot.
+    static inline SandboxSlot* GetSandboxSlot(SandboxHeader* header, LONG64 index)
+    {
+        uint8_t* slots = reinterpret_cast<uint8_t*>(header) + sizeof(SandboxHeader);
+        return reinterpret_cast<SandboxSlot*>(slots + (index % header->SlotCount) * header->SlotSize);
+    }
+
+    /// Get the area visualizer state is handed over in.
+    ///
+    /// @param header is the start of the shared memory.
+    /// @returns a pointer to SandboxHeader::StateCapacity bytes.
+    static inline uint8_t* GetSandboxState(SandboxHeader* header)
+    {
+        return reinterpret_cast<uint8_t*>(header) + header->StateOffset;
+    }
+
+    /// Get the spectrum array following a slot; the bands follow the spectrum.
+    ///
+    /// @param slot is a slot in shared memory.
+    /// @returns a pointer to the start of the slot's spectrum.
+    static inline float* GetSandboxSpectrum(SandboxSlot* slot)
+    {
+        return reinterpret_cast<float*>(reinterpret_cast<uint8_t*>(slot) + sizeof(SandboxSlot));
+    }
+}
@@ -5,6 +5,10 @@
 #include "Runtime.h"
 #include "Visualizer.h"
 #include "Plugin.h"
+#include "Features.h"
+#include "Governor.h"
+
+#include <memory>
 
 namespace Dance::Application
 {
@@ -24,6 +28,18 @@ namespace Dance::Application
         /// Destroy the visualizer window, deallocating the current visualizer.
         ~VisualizerWindow();
 
+        /// Choose whether visualizers run in a sandbox process or inline on our own thread. Sandboxing is the default;
+        /// running inline is mostly useful for debugging a plugin. Takes effect the next time a visualizer is created.
+        /// 
+        /// @param isolated is whether to sandbox visualizers.
+        void Isolate(bool isolated);
+
+        /// Configure when the frame rate is lowered because the output device has gone silent.
+        /// 
+        /// @param silence is the number of seconds without signal before throttling.
+        /// @param rate is the number of frames per second to run at while throttled.
+        void Govern(double silence, double rate);
+
         /// Provide dependencies to visualizer instantion.
         /// 
         /// @returns a POD containing handles to relevant graphical resources.
@@ -68,18 +84,49 @@ namespace Dance::Application
         /// Whether we're tracking the mouse's location to test hovering.
         bool isMouseTracking = false;
 
-        /// The current visualizer. Managed by originating plugin.
+        /// The current visualizer. Either a SandboxVisualizer or managed by the originating plugin.
         Visualizer* visualizer;
 
+        /// Matching destructor for the current visualizer.
+        Visualizer::Destructor destructor;
+
+        /// Whether new visualizers are created in a sandbox process.
+        bool isolated{ true };
+
         /// A managed reference the source plugin of our current visualizer.
         std::reference_wrapper<const Plugin> plugin;
 
+        /// Audio analysis shared by every plugin registered through the C ABI. Created the first time such a plugin
+        /// is selected and only capturing while one is active.
+        std::unique_ptr<Dance::Audio::Features> features;
+
+        /// Throttles updates and rendering while the output device is silent.
+        Governor governor;
+
+        /// Whether the governor admitted the last update, in which case the next paint renders.
+        bool admitted{ true };
+
+        /// Seconds of updates withheld by the governor, handed to the visualizer with the next admitted one.
+        double withheld{ 0.0 };
+
+        /// Create a visualizer for a plugin, sandboxed or not, and remember how to destroy it.
+        /// 
+        /// @param plugin is the plugin to instantiate.
+        /// @returns the new visualizer.
+        Visualizer* Construct(const Plugin& plugin);
+
         /// Switch to a different visualizer via its registered plugin.
         /// 
         /// @param plugin should be a constant reference to a plugin from the plugin manager.
         /// @returns an LRESULT to propagate through VisualizerWindow::Command.
         LRESULT Switch(const Plugin& plugin);
 
+        /// Reload any plugin DLLs that have been rebuilt. If the current visualizer came from one of them, it's
+        /// serialized, reconstructed by the new module, and restored. The outgoing visualizer is only destroyed after
+        /// its replacement exists, so audio capture stays open and the FFTW library, along with the wisdom it 
+        /// accumulated planning the previous analyzer, remains loaded for the new one.
+        void Reload();
+
         /// Called on resizing the window. Tells the current visualizer to resize as well.
         /// 
         /// @returns an HRESULT indicating success.
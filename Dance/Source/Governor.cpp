@@ -0,0 +1,138 @@
+#include "Governor.h"
+#include "Runtime.h"
+#include "Sandbox.h"
+#include "Audio.h"
+
+#include <algorithm>
+
+namespace Dance::Application
+{
+	/// Peak amplitude below which we consider the output silent, about -80 dBFS.
+	constexpr float THRESHOLD = 0.0001f;
+
+	/// Longest we'll sleep between checks of the meter, roughly one full-rate frame.
+	constexpr DWORD POLL = 16;
+
+	Governor::Governor()
+		: silence(Governor::SILENCE)
+		, rate(Governor::RATE)
+	{
+
+	}
+
+	HRESULT Governor::Create()
+	{
+		try
+		{
+			ComPtr<IMMDevice> device = Dance::Audio::getDefaultAudioDevice();
+			OK(device->Activate(
+				__uuidof(IAudioMeterInformation),
+				CLSCTX_ALL,
+				nullptr,
+				reinterpret_cast<void**>(this->meter.ReleaseAndGetAddressOf())));
+		}
+		catch (const ComError& error)
+		{
+			TRACE("failed to find an output device to meter: " << error.what());
+			return E_FAIL;
+		}
+
+		this->cpuAtActive = Governor::Cpu();
+		return S_OK;
+	}
+
+	void Governor::Configure(double silence, double rate)
+	{
+		this->silence = std::max(silence, 0.0);
+		this->rate = std::max(rate, 0.1);
+	}
+
+	bool Governor::Admit()
+	{
+		float peak = 1.0f;
+		if (!this->meter || FAILED(this->meter->GetPeakValue(&peak)))
+		{
+			return true;
+		}
+
+		const uint64_t now = Runtime::Counter();
+		if (peak > THRESHOLD)
+		{
+			if (this->idle)
+			{
+				this->idle = false;
+				this->framesAtActive = this->frames;
+				this->cpuAtActive = Governor::Cpu();
+				TRACE("signal returned, skipped " << this->statistics.Skipped << " frames and saved "
+					<< this->statistics.Saved << " s of CPU so far");
+			}
+
+			this->quiet = 0;
+			this->last = now;
+			this->frames += 1;
+			return true;
+		}
+
+		if (this->quiet == 0)
+		{
+			this->quiet = now;
+		}
+
+		if (!this->idle && Governor::Since(this->quiet, now) >= this->silence)
+		{
+			// Price a frame by what the full-rate period we're leaving cost us
+			const uint64_t frames = this->frames - this->framesAtActive;
+			if (frames > 0)
+			{
+				this->cost = (Governor::Cpu() - this->cpuAtActive) / frames;
+			}
+
+			this->idle = true;
+			this->statistics.Idled += 1;
+			TRACE("silent for " << this->silence << " s, throttling to " << this->rate << " FPS");
+		}
+
+		if (!this->idle || Governor::Since(this->last, now) >= 1.0 / this->rate)
+		{
+			this->last = now;
+			this->frames += 1;
+			return true;
+		}
+
+		// Each refusal stands in for about one full-rate frame since we sleep for at most that long in between
+		this->statistics.Skipped += 1;
+		this->statistics.Saved += this->cost;
+		return false;
+	}
+
+	DWORD Governor::Wait() const
+	{
+		const double remaining = 1.0 / this->rate - Governor::Since(this->last, Runtime::Counter());
+		return std::min(POLL, static_cast<DWORD>(std::max(remaining, 0.0) * 1000.0));
+	}
+
+	const Governor::Statistics& Governor::Report() const
+	{
+		return this->statistics;
+	}
+
+	double Governor::Since(uint64_t then, uint64_t now)
+	{
+		return static_cast<double>(now - then) / Runtime::Frequency();
+	}
+
+	double Governor::Cpu()
+	{
+		FILETIME creation, exit, kernel, user;
+		if (!::GetProcessTimes(::GetCurrentProcess(), &creation, &exit, &kernel, &user))
+		{
+			return SandboxVisualizer::Cpu();
+		}
+
+		const auto seconds = [](const FILETIME& time)
+		{
+			return ((static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime) / 1e7;
+		};
+		return seconds(kernel) + seconds(user) + SandboxVisualizer::Cpu();
+	}
+}
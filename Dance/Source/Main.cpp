@@ -1,5 +1,9 @@
 #include "Framework.h"
 #include "VisualizerWindow.h"
+#include "Sandbox.h"
+
+#include <shellapi.h>
+#include <cwchar>
 
 // Indicates to hybrid graphics systems to prefer the discrete part by default
 extern "C"
@@ -19,6 +23,48 @@ int APIENTRY wWinMain(
     UNREFERENCED_PARAMETER(previousInstance);
     UNREFERENCED_PARAMETER(commandLine);
 
+    // Either we're hosting a single visualizer for another instance, or we're the application
+    int argumentCount = 0;
+    std::unique_ptr<LPWSTR, decltype(&::LocalFree)> arguments(::CommandLineToArgvW(::GetCommandLineW(), &argumentCount), &::LocalFree);
+    bool isolated = true;
+    double silence = Dance::Application::Governor::SILENCE;
+    double rate = Dance::Application::Governor::RATE;
+    for (int i = 1; arguments && i < argumentCount; ++i)
+    {
+        const std::wstring argument = arguments.get()[i];
+        if (argument == L"--sandbox" && i + 1 < argumentCount)
+        {
+            GUARD(::CoInitializeEx(nullptr, COINITBASE_MULTITHREADED), result) {
+                return result;
+            }
+
+            int status = 1;
+            try
+            {
+                status = Dance::Application::Sandbox::Run(arguments.get()[i + 1]);
+            }
+            catch (const std::exception& exception)
+            {
+                TRACE("sandbox failed: " << exception.what());
+            }
+
+            ::CoUninitialize();
+            return status;
+        }
+        else if (argument == L"--inline")
+        {
+            isolated = false;
+        }
+        else if (argument == L"--idle" && i + 1 < argumentCount)
+        {
+            silence = std::wcstod(arguments.get()[++i], nullptr);
+        }
+        else if (argument == L"--idle-rate" && i + 1 < argumentCount)
+        {
+            rate = std::wcstod(arguments.get()[++i], nullptr);
+        }
+    }
+
     Dance::Application::Plugins::Load();
     if (Dance::Application::Plugins::Get().size() == 0)
     {
@@ -42,6 +88,8 @@ int APIENTRY wWinMain(
     }
 
     Dance::Application::VisualizerWindow window(instance, L"VisualizerWindow", L"Dance");
+    window.Isolate(isolated);
+    window.Govern(silence, rate);
     OK(window.Create());
     OK(window.Position(100, 100, 480, 480, SWP_FRAMECHANGED));
     OK(window.Prepare(showCommand));
@@ -0,0 +1,102 @@
+#include "Offscreen.h"
+
+namespace Dance::Application
+{
+	/// Same feature levels the application requests.
+	constexpr D3D_FEATURE_LEVEL FEATURE_LEVELS[] =
+	{
+		D3D_FEATURE_LEVEL_11_1,
+		D3D_FEATURE_LEVEL_11_0,
+		D3D_FEATURE_LEVEL_10_1,
+		D3D_FEATURE_LEVEL_10_0,
+		D3D_FEATURE_LEVEL_9_3,
+		D3D_FEATURE_LEVEL_9_2,
+		D3D_FEATURE_LEVEL_9_1,
+	};
+
+	Offscreen::Offscreen(UINT width, UINT height, bool warp)
+	{
+		// The predefined static control class saves us from registering our own, we never pump its messages
+		this->window = ::CreateWindowExW(
+			0,
+			L"STATIC",
+			L"Dance Bench",
+			WS_POPUP,
+			0,
+			0,
+			width,
+			height,
+			nullptr,
+			nullptr,
+			::GetModuleHandle(nullptr),
+			nullptr);
+		BETE(this->window != nullptr);
+
+		OKE(::D3D11CreateDevice(
+			nullptr,
+			warp ? D3D_DRIVER_TYPE_WARP : D3D_DRIVER_TYPE_HARDWARE,
+			nullptr,
+			D3D11_CREATE_DEVICE_BGRA_SUPPORT,
+			FEATURE_LEVELS,
+			static_cast<UINT>(std::size(FEATURE_LEVELS)),
+			D3D11_SDK_VERSION,
+			&this->d3dDevice,
+			nullptr,
+			nullptr));
+
+		OKE(this->d3dDevice.As(&this->dxgiDevice));
+		OKE(::CreateDXGIFactory2(
+			0,
+			__uuidof(this->dxgiFactory),
+			reinterpret_cast<void**>(this->dxgiFactory.ReleaseAndGetAddressOf())));
+
+		// Composition swap chains don't need a window, which is what makes this work without a desktop
+		DXGI_SWAP_CHAIN_DESC1 swapChainDescription{};
+		swapChainDescription.Format = DXGI_FORMAT_B8G8R8A8_UNORM;
+		swapChainDescription.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+		swapChainDescription.SwapEffect = DXGI_SWAP_EFFECT_FLIP_SEQUENTIAL;
+		swapChainDescription.BufferCount = 2;
+		swapChainDescription.SampleDesc.Count = 1;
+		swapChainDescription.AlphaMode = DXGI_ALPHA_MODE_PREMULTIPLIED;
+		swapChainDescription.Width = width;
+		swapChainDescription.Height = height;
+		OKE(this->dxgiFactory->CreateSwapChainForComposition(
+			this->dxgiDevice.Get(),
+			&swapChainDescription,
+			nullptr,
+			this->dxgiSwapChain.ReleaseAndGetAddressOf()));
+
+		const D2D1_FACTORY_OPTIONS options{};
+		OKE(::D2D1CreateFactory(
+			D2D1_FACTORY_TYPE_SINGLE_THREADED,
+			options,
+			this->d2dFactory.ReleaseAndGetAddressOf()));
+		OKE(this->d2dFactory->CreateDevice(
+			this->dxgiDevice.Get(),
+			this->d2dDevice.ReleaseAndGetAddressOf()));
+	}
+
+	Offscreen::~Offscreen()
+	{
+		::DestroyWindow(this->window);
+	}
+
+	HRESULT Offscreen::Resize(UINT width, UINT height)
+	{
+		BET(::SetWindowPos(this->window, nullptr, 0, 0, width, height, SWP_NOMOVE | SWP_NOZORDER | SWP_NOACTIVATE));
+		OK(this->dxgiSwapChain->ResizeBuffers(0, width, height, DXGI_FORMAT_UNKNOWN, 0));
+		return S_OK;
+	}
+
+	Visualizer::Dependencies Offscreen::Dependencies() const
+	{
+		return {
+			::GetModuleHandle(nullptr),
+			this->window,
+			this->d3dDevice,
+			this->dxgiDevice,
+			this->dxgiSwapChain,
+			this->d2dDevice
+		};
+	}
+}
@@ -1,6 +1,9 @@
 #include "Plugin.h"
 #include "Path.h"
 
+#include <algorithm>
+#include <cstring>
+
 namespace Dance::Application
 {
     // https://stackoverflow.com/a/42844629
@@ -9,30 +12,370 @@ namespace Dance::Application
         return str.size() >= suffix.size() && 0 == str.compare(str.size() - suffix.size(), suffix.size(), suffix);
     }
 
+    /// Deletion struct for a directory change notification handle.
+    struct ChangeNotificationDeleter
+    {
+        using pointer = HANDLE;
+
+        void operator()(HANDLE handle) const
+        {
+            ::FindCloseChangeNotification(handle);
+        }
+    };
+
+    /// Signaled by the system whenever a file in the Visualizers directory is written, created, or renamed.
+    static std::unique_ptr<void, ChangeNotificationDeleter> notification;
+
+    /// Incremented for every shadow copy so that a reload never collides with a module that's still loaded.
+    static size_t generation = 0;
+
+    /// Suffix for shadow copies. Not a DLL extension so that Plugins::Load won't pick them up.
+    static const std::wstring SHADOW = L".shadow";
+
+    /// Runtime-side visualizer that forwards to a plugin's C ABI function table.
+    class TableVisualizer : public Visualizer
+    {
+    public:
+        TableVisualizer(const DanceVisualizerTable& table, const Visualizer::Dependencies& dependencies)
+            : table(table)
+            , features(dependencies.Features)
+        {
+            const DanceDependencies converted{
+                sizeof(DanceDependencies),
+                dependencies.Instance,
+                dependencies.Window,
+                dependencies.D3dDevice.Get(),
+                dependencies.DxgiDevice.Get(),
+                dependencies.DxgiSwapChain.Get(),
+                dependencies.D2dDevice.Get(),
+                dependencies.Features
+            };
+
+            this->visualizer = this->table.Create(&converted);
+            if (this->visualizer == nullptr)
+            {
+                throw ComError(E_FAIL, "plugin failed to create visualizer");
+            }
+        }
+
+        virtual ~TableVisualizer()
+        {
+            this->table.Destroy(this->visualizer);
+        }
+
+        virtual HRESULT Unsize()
+        {
+            return this->table.Unsize(this->visualizer);
+        }
+
+        virtual HRESULT Resize(const RECT& size)
+        {
+            return this->table.Resize(this->visualizer, &size);
+        }
+
+        virtual void Render()
+        {
+            this->table.Render(this->visualizer);
+            this->Check();
+        }
+
+        virtual void Update(double delta)
+        {
+            this->table.Update(this->visualizer, delta, this->features);
+            this->Check();
+        }
+
+        virtual std::vector<uint8_t> Serialize() const
+        {
+            if (this->table.Serialize == nullptr)
+            {
+                return {};
+            }
+
+            // A visualizer whose state changed size between the calls, or that failed, hands off nothing
+            std::vector<uint8_t> state(this->table.Serialize(this->visualizer, nullptr, 0));
+            if (this->table.Serialize(this->visualizer, state.data(), state.size()) != state.size())
+            {
+                return {};
+            }
+            return state;
+        }
+
+        virtual void Restore(const std::vector<uint8_t>& state)
+        {
+            if (this->table.Restore != nullptr)
+            {
+                this->table.Restore(this->visualizer, state.data(), state.size());
+                this->Check();
+            }
+        }
+
+    private:
+        /// Our own copy of the table, zero-filled past whatever the plugin was built with.
+        DanceVisualizerTable table;
+
+        /// The shared feature block passed to every update.
+        const DanceFeatures* features;
+
+        /// The plugin's opaque visualizer.
+        void* visualizer;
+
+        /// Rethrow a failure the plugin recorded instead of throwing across the ABI, so that it's handled the same
+        /// way as one thrown by a visualizer registered through the C++ API.
+        void Check()
+        {
+            if (this->table.Failure != nullptr)
+            {
+                GUARD(this->table.Failure(this->visualizer), result)
+                {
+                    throw ComError(result, "plugin visualizer failed");
+                }
+            }
+        }
+    };
+
+    Module::~Module()
+    {
+        // The file can't be deleted until the library is released
+        this->Library.reset();
+        std::error_code ignored;
+        std::filesystem::remove(this->Shadow, ignored);
+    }
+
     void Plugins::Load()
     {
+        // Instantiate the module vector before any plugin registers so that it's destroyed after the plugin vector,
+        // whose constructors and destructors point into the modules' code
+        Plugins::Modules();
+
         std::filesystem::path visualizersDirectory = GetModulePath().parent_path() / "Visualizers";
         if (!std::filesystem::is_directory(visualizersDirectory))
         {
             return;
         }
 
+        // Clean up shadow copies left behind by a previous session that didn't exit cleanly
+        std::error_code ignored;
+        for (const auto& item : std::filesystem::recursive_directory_iterator{ visualizersDirectory })
+        {
+            if (item.path().extension() == SHADOW)
+            {
+                std::filesystem::remove(item.path(), ignored);
+            }
+        }
+
         for (const auto& item : std::filesystem::recursive_directory_iterator{ visualizersDirectory })
         {
             if (EndsWith(item.path().string(), ".dll"))
             {
-                ::LoadLibrary(item.path().wstring().data());
+                if (std::unique_ptr<Module> module = Plugins::Open(item.path()))
+                {
+                    Plugins::Modules().push_back(std::move(module));
+                }
             }
         }
+
+        // https://docs.microsoft.com/en-us/windows/win32/fileio/obtaining-directory-change-notifications
+        HANDLE handle = ::FindFirstChangeNotificationW(
+            visualizersDirectory.wstring().data(),
+            TRUE,
+            FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME);
+        if (handle == INVALID_HANDLE_VALUE)
+        {
+            TRACE("failed to watch visualizers directory: " << ::GetLastError());
+            return;
+        }
+
+        notification.reset(handle);
+    }
+
+    bool Plugins::Load(const std::filesystem::path& source)
+    {
+        Plugins::Modules();
+        if (std::unique_ptr<Module> module = Plugins::Open(source))
+        {
+            Plugins::Modules().push_back(std::move(module));
+            return true;
+        }
+
+        return false;
+    }
+
+    std::vector<std::filesystem::path> Plugins::Modified()
+    {
+        std::vector<std::filesystem::path> modified;
+        if (!notification || ::WaitForSingleObject(notification.get(), 0) != WAIT_OBJECT_0)
+        {
+            return modified;
+        }
+
+        // Rearm before checking so we don't miss a write that lands while we're looking. Our own shadow copies also
+        // signal the notification, but their sources won't have changed so they're filtered out below.
+        ::FindNextChangeNotification(notification.get());
+
+        std::error_code error;
+        for (const std::unique_ptr<Module>& module : Plugins::Modules())
+        {
+            std::filesystem::file_time_type written = std::filesystem::last_write_time(module->Source, error);
+            if (!error && written != module->Written)
+            {
+                modified.push_back(module->Source);
+            }
+        }
+
+        return modified;
+    }
+
+    std::unique_ptr<Module> Plugins::Reload(const std::filesystem::path& source)
+    {
+        std::vector<std::unique_ptr<Module>>& modules = Plugins::Modules();
+        auto current = std::find_if(
+            modules.begin(),
+            modules.end(),
+            [&source](const std::unique_ptr<Module>& module) { return module->Source == source; });
+        if (current == modules.end())
+        {
+            return nullptr;
+        }
+
+        // Withdraw the module's entries so that we can tell which ones the new module registers again
+        std::vector<Plugin>& plugins = Plugins::Vector();
+        std::vector<size_t> withdrawn;
+        for (Plugin& plugin : plugins)
+        {
+            if (plugin.Source == source && plugin.Available)
+            {
+                plugin.Available = false;
+                withdrawn.push_back(plugin.Index);
+            }
+        }
+
+        // Registration happens in the new module's DllMain, which overwrites the existing plugin entries. A copy that
+        // registers nothing for this source is treated like one that failed to load; it's safe to free and the previous
+        // module stays in place. Only this source's entries count, since other modules' plugins are available anyway.
+        std::unique_ptr<Module> module = Plugins::Open(source);
+        const auto registered = [&source](const Plugin& plugin) { return plugin.Source == source && plugin.Available; };
+        if (!module || std::none_of(plugins.begin(), plugins.end(), registered))
+        {
+            for (size_t index : withdrawn)
+            {
+                plugins[index].Available = true;
+            }
+            return nullptr;
+        }
+
+        // Entries left behind would call into the previous module after the caller frees it, so drop them while it's
+        // still loaded; destroying the functions runs their code too
+        for (size_t index : withdrawn)
+        {
+            Plugin& plugin = plugins[index];
+            if (!plugin.Available)
+            {
+                TRACE("withdrew " << plugin.Name << ", which " << source.wstring() << " no longer registers");
+                plugin.Constructor = nullptr;
+                plugin.Destructor = nullptr;
+            }
+        }
+
+        TRACE("reloaded " << source.wstring());
+        std::swap(*current, module);
+        return module;
+    }
+
+    std::unique_ptr<Module> Plugins::Open(const std::filesystem::path& source)
+    {
+        std::unique_ptr<Module> module = std::make_unique<Module>();
+        module->Source = source;
+
+        // Sandboxed plugin processes load the same DLLs, so the process ID keeps our copies apart from theirs
+        module->Shadow = source.parent_path() / (
+            source.stem().wstring()
+            + L"." + std::to_wstring(::GetCurrentProcessId())
+            + L"." + std::to_wstring(generation++)
+            + SHADOW);
+
+        // Read the write time first so that a write racing the copy triggers another reload
+        std::error_code error;
+        module->Written = std::filesystem::last_write_time(source, error);
+        if (error || !std::filesystem::copy_file(source, module->Shadow, std::filesystem::copy_options::overwrite_existing, error))
+        {
+            TRACE("failed to copy " << source.wstring() << ": " << error.value());
+            return nullptr;
+        }
+
+        Plugins::Loading() = source;
+        module->Library.reset(::LoadLibrary(module->Shadow.wstring().data()));
+        Plugins::Loading().clear();
+
+        if (!module->Library)
+        {
+            TRACE("failed to load " << source.wstring() << ": " << ::GetLastError());
+            return nullptr;
+        }
+
+        return module;
     }
 
     void Plugins::Register
     (
         const std::wstring& name,
         const Visualizer::Constructor& constructor,
-        const Visualizer::Destructor& destructor
+        const Visualizer::Destructor& destructor,
+        bool shared
     ) {
-        Plugins::Vector().push_back({ Plugins::Vector().size(), name, constructor, destructor });
+        const std::filesystem::path& source = Plugins::Loading();
+        for (Plugin& plugin : Plugins::Vector())
+        {
+            // A reloaded module replaces its previous registration in place
+            if (!source.empty() && plugin.Source == source && plugin.Name == name)
+            {
+                plugin.Constructor = constructor;
+                plugin.Destructor = destructor;
+                plugin.Shared = shared;
+                plugin.Available = true;
+                return;
+            }
+        }
+
+        Plugins::Vector().push_back({ Plugins::Vector().size(), name, constructor, destructor, source, shared });
+    }
+
+    bool Plugins::Register(const DancePlugin& plugin)
+    {
+        // Same major version, and nothing newer than we know about
+        if (plugin.Size < sizeof(DancePlugin)
+            || plugin.Version.Major != DANCE_ABI_MAJOR
+            || plugin.Version.Minor > DANCE_ABI_MINOR
+            || plugin.Name == nullptr
+            || plugin.Table == nullptr)
+        {
+            TRACE("rejected plugin built against ABI " << plugin.Version.Major << "." << plugin.Version.Minor);
+            return false;
+        }
+
+        // Copy only as much of the table as the plugin says it has
+        DanceVisualizerTable table{};
+        std::memcpy(&table, plugin.Table, std::min<size_t>(plugin.Table->Size, sizeof(DanceVisualizerTable)));
+        if (table.Create == nullptr
+            || table.Destroy == nullptr
+            || table.Unsize == nullptr
+            || table.Resize == nullptr
+            || table.Update == nullptr
+            || table.Render == nullptr)
+        {
+            TRACE("rejected plugin " << plugin.Name << " with incomplete function table");
+            return false;
+        }
+
+        Plugins::Register(
+            plugin.Name,
+            [table](const Visualizer::Dependencies& dependencies) -> Visualizer*
+            {
+                return new TableVisualizer(table, dependencies);
+            },
+            Visualizer::Delete,
+            true);
+        return true;
     }
 
     const std::vector<Plugin>& Plugins::Get()
@@ -42,7 +385,9 @@ namespace Dance::Application
 
     const Plugin& Plugins::First()
     {
-        return Plugins::Vector().front();
+        const std::vector<Plugin>& plugins = Plugins::Vector();
+        auto available = std::find_if(plugins.begin(), plugins.end(), [](const Plugin& plugin) { return plugin.Available; });
+        return available != plugins.end() ? *available : plugins.front();
     }
 
     std::vector<Plugin>& Plugins::Vector()
@@ -51,9 +396,21 @@ namespace Dance::Application
         return plugins;
     }
 
+    std::vector<std::unique_ptr<Module>>& Plugins::Modules()
+    {
+        static std::vector<std::unique_ptr<Module>> modules;
+        return modules;
+    }
+
+    std::filesystem::path& Plugins::Loading()
+    {
+        static std::filesystem::path loading;
+        return loading;
+    }
+
     extern "C" __declspec(dllexport) Dance::API::About _Dance()
     {
-        return { 0, 0, 1 };
+        return { { DANCE_ABI_MAJOR, DANCE_ABI_MINOR, 0 } };
     }
 
     extern "C" __declspec(dllexport) void _Register(
@@ -63,4 +420,9 @@ namespace Dance::Application
     ) {
         Plugins::Register(name, constructor, destructor);
     }
+
+    extern "C" __declspec(dllexport) int32_t _RegisterTable(const DancePlugin* plugin)
+    {
+        return plugin != nullptr && Plugins::Register(*plugin);
+    }
 }
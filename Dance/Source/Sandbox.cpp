@@ -0,0 +1,573 @@
+#include "Sandbox.h"
+#include "Offscreen.h"
+#include "Runtime.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Dance::Application
+{
+	/// Frames of input buffered between the runtime and sandbox.
+	constexpr uint32_t SLOTS = 4;
+
+	/// Seconds without a rendered frame before the watchdog relaunches a running sandbox.
+	constexpr double HUNG = 2.0;
+
+	/// Seconds a sandbox gets to load its plugin and render its first frame.
+	constexpr double STARTING = 10.0;
+
+	/// Seconds to wait for a sandbox to exit when asked.
+	constexpr DWORD QUITTING = 1000;
+
+	/// How long the sandbox waits for a frame before checking whether it should quit.
+	constexpr DWORD POLLING = 100;
+
+	/// Bytes of visualizer state that can be handed across a reload.
+	constexpr uint32_t STATE = 64 * 1024;
+
+	/// Distinguishes the sandboxes launched by this process.
+	static size_t launched = 0;
+
+	static LONG64 Read(volatile LONG64* value)
+	{
+		return ::InterlockedCompareExchange64(value, 0, 0);
+	}
+
+	static LONG Read(volatile LONG* value)
+	{
+		return ::InterlockedCompareExchange(value, 0, 0);
+	}
+
+	static std::wstring Name(const std::wstring& id, const std::wstring& suffix = L"")
+	{
+		return L"Local\\DanceSandbox." + id + suffix;
+	}
+
+	/// Every sandbox is launched into this job, which keeps accounting for the processes in it after they exit. Our
+	/// handle is the only one, so the system closes it when we exit however that happens, and the sandboxes go with it.
+	static HANDLE Job()
+	{
+		static KernelHandle job = []()
+		{
+			KernelHandle job(::CreateJobObjectW(nullptr, nullptr));
+			JOBOBJECT_EXTENDED_LIMIT_INFORMATION limits{};
+			limits.BasicLimitInformation.LimitFlags = JOB_OBJECT_LIMIT_KILL_ON_JOB_CLOSE;
+			if (job && !::SetInformationJobObject(job.get(), JobObjectExtendedLimitInformation, &limits, sizeof(limits)))
+			{
+				TRACE("failed to tie sandboxes to the runtime: " << ::GetLastError());
+			}
+			return job;
+		}();
+		return job.get();
+	}
+
+	SandboxVisualizer::SandboxVisualizer(const Plugin& plugin, const Visualizer::Dependencies& dependencies)
+		: dependencies(dependencies)
+		, id(std::to_wstring(::GetCurrentProcessId()) + L"." + std::to_wstring(launched++))
+	{
+		OKE(this->dependencies.D3dDevice.As(&this->d3dDevice));
+		this->d3dDevice->GetImmediateContext(this->d3dDeviceContext.ReleaseAndGetAddressOf());
+
+		const DanceFeatures* features = plugin.Shared ? dependencies.Features : nullptr;
+		const uint32_t spectrumCapacity = features != nullptr ? features->SpectrumSize : 0;
+		const uint32_t bandCapacity = features != nullptr ? features->BandCount : 0;
+
+		// Keep slots 8-byte aligned for the interlocked sequence numbers
+		const size_t slotSize = (sizeof(SandboxSlot) + (spectrumCapacity + bandCapacity) * sizeof(float) + 7) & ~size_t(7);
+		const size_t stateOffset = sizeof(SandboxHeader) + slotSize * SLOTS;
+		const size_t size = stateOffset + STATE;
+
+		this->mapping.reset(::CreateFileMappingW(
+			INVALID_HANDLE_VALUE,
+			nullptr,
+			PAGE_READWRITE,
+			static_cast<DWORD>(static_cast<uint64_t>(size) >> 32),
+			static_cast<DWORD>(size),
+			Name(this->id).c_str()));
+		BETE(this->mapping != nullptr);
+
+		this->view.reset(::MapViewOfFile(this->mapping.get(), FILE_MAP_ALL_ACCESS, 0, 0, size));
+		BETE(this->view != nullptr);
+
+		// The mapping is zero-filled by the system
+		this->header = static_cast<SandboxHeader*>(this->view.get());
+		::wcsncpy_s(this->header->Source, plugin.Source.wstring().c_str(), _TRUNCATE);
+		::wcsncpy_s(this->header->Name, plugin.Name.c_str(), _TRUNCATE);
+		this->header->SpectrumCapacity = spectrumCapacity;
+		this->header->BandCapacity = bandCapacity;
+		this->header->SlotCount = SLOTS;
+		this->header->SlotSize = static_cast<uint32_t>(slotSize);
+		this->header->StateOffset = static_cast<uint32_t>(stateOffset);
+		this->header->StateCapacity = STATE;
+
+		RECT client;
+		::GetClientRect(dependencies.Window, &client);
+		this->header->Width = std::max(client.right - client.left, 1L);
+		this->header->Height = std::max(client.bottom - client.top, 1L);
+
+		this->frame.reset(::CreateEventW(nullptr, FALSE, FALSE, Name(this->id, L".Frame").c_str()));
+		BETE(this->frame != nullptr);
+	}
+
+	SandboxVisualizer::~SandboxVisualizer()
+	{
+		if (!this->process)
+		{
+			return;
+		}
+
+		::InterlockedExchange(&this->header->Quit, 1);
+		::SetEvent(this->frame.get());
+		if (::WaitForSingleObject(this->process.get(), QUITTING) != WAIT_OBJECT_0)
+		{
+			::TerminateProcess(this->process.get(), 1);
+		}
+	}
+
+	void SandboxVisualizer::Launch()
+	{
+		// Forget the previous sandbox's surface and progress, and take back a request to quit that it answered
+		::InterlockedExchange(&this->header->Quit, 0);
+		::InterlockedExchange(&this->header->Surface, 0);
+		::InterlockedExchange64(&this->header->Rendered, 0);
+		this->surface.Reset();
+		this->surfaceMutex.Reset();
+		this->surfaceGeneration = 0;
+		this->shown = 0;
+		this->watched = 0;
+		this->progressed = Runtime::Counter();
+
+		std::wstring commandLine = L"\"" + GetModulePath().wstring() + L"\" --sandbox " + this->id;
+		STARTUPINFOW startup{};
+		startup.cb = sizeof(startup);
+		PROCESS_INFORMATION information{};
+		BETE(::CreateProcessW(
+			nullptr,
+			commandLine.data(),
+			nullptr,
+			nullptr,
+			FALSE,
+			CREATE_SUSPENDED,
+			nullptr,
+			nullptr,
+			&startup,
+			&information));
+
+		// Join the job before running anything so that all of the sandbox's time is accounted for
+		this->process.reset(information.hProcess);
+		if (Job() == nullptr || !::AssignProcessToJobObject(Job(), information.hProcess))
+		{
+			TRACE("failed to account for sandbox " << this->header->Name << ": " << ::GetLastError());
+		}
+
+		// Give the sandbox a handle to wait on us with, in case the job can't take it down with us
+		HANDLE parent = nullptr;
+		if (!::DuplicateHandle(::GetCurrentProcess(), ::GetCurrentProcess(), information.hProcess, &parent, SYNCHRONIZE, FALSE, 0))
+		{
+			TRACE("failed to hand sandbox " << this->header->Name << " our process: " << ::GetLastError());
+		}
+		this->header->Parent = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(parent));
+		::ResumeThread(information.hThread);
+		::CloseHandle(information.hThread);
+	}
+
+	void SandboxVisualizer::Watch()
+	{
+		if (!this->process)
+		{
+			this->Launch();
+			return;
+		}
+
+		const uint64_t now = Runtime::Counter();
+		const LONG64 rendered = Read(&this->header->Rendered);
+		if (rendered != this->watched)
+		{
+			this->watched = rendered;
+			this->progressed = now;
+			return;
+		}
+
+		const double limit = Read(&this->header->Surface) == 0 ? STARTING : HUNG;
+		const bool hung = static_cast<double>(now - this->progressed) / Runtime::Frequency() > limit;
+		const bool exited = ::WaitForSingleObject(this->process.get(), 0) == WAIT_OBJECT_0;
+		if (hung || exited)
+		{
+			TRACE("relaunching " << (exited ? "exited" : "hung") << " sandbox " << this->header->Name);
+			::TerminateProcess(this->process.get(), 1);
+			::WaitForSingleObject(this->process.get(), QUITTING);
+			this->restarts += 1;
+			this->Launch();
+		}
+	}
+
+	void SandboxVisualizer::Publish(double delta)
+	{
+		this->elapsed += delta;
+
+		const LONG64 published = Read(&this->header->Published) + 1;
+		SandboxSlot* slot = GetSandboxSlot(this->header, published);
+
+		// Odd while writing
+		::InterlockedExchange64(&slot->Sequence, published * 2 - 1);
+		slot->Elapsed = this->elapsed;
+		slot->Analyzed = 0;
+
+		const DanceFeatures* features = this->dependencies.Features;
+		if (features != nullptr && this->header->SpectrumCapacity > 0)
+		{
+			const uint32_t spectrumSize = std::min(features->SpectrumSize, this->header->SpectrumCapacity);
+			const uint32_t bandCount = std::min(features->BandCount, this->header->BandCapacity);
+			float* spectrum = GetSandboxSpectrum(slot);
+			std::memcpy(spectrum, features->Spectrum, spectrumSize * sizeof(float));
+			std::memcpy(spectrum + this->header->SpectrumCapacity, features->Bands, bandCount * sizeof(float));
+
+			slot->Analyzed = 1;
+			slot->SampleRate = features->SampleRate;
+			slot->SpectrumSize = spectrumSize;
+			slot->BandCount = bandCount;
+			slot->Frame = features->Frame;
+			slot->Level = features->Level;
+			slot->Peak = features->Peak;
+		}
+
+		::InterlockedExchange64(&slot->Sequence, published * 2);
+		::InterlockedExchange64(&this->header->Published, published);
+		::SetEvent(this->frame.get());
+	}
+
+	HRESULT SandboxVisualizer::Unsize()
+	{
+		// We only hold onto our back buffer while copying into it
+		return S_OK;
+	}
+
+	HRESULT SandboxVisualizer::Resize(const RECT& size)
+	{
+		::InterlockedExchange(&this->header->Width, std::max(size.right - size.left, 1L));
+		::InterlockedExchange(&this->header->Height, std::max(size.bottom - size.top, 1L));
+		::InterlockedIncrement(&this->header->Sized);
+		return S_OK;
+	}
+
+	void SandboxVisualizer::Update(double delta)
+	{
+		this->Watch();
+		this->Publish(delta);
+	}
+
+	std::vector<uint8_t> SandboxVisualizer::Serialize() const
+	{
+		// State waiting for a sandbox that never launched is still ours to hand on
+		if (this->process)
+		{
+			::InterlockedExchange(&this->header->Quit, 1);
+			::SetEvent(this->frame.get());
+
+			// We're on the UI thread, so a sandbox gets no longer than the watchdog would give it, even one that's still
+			// loading its plugin. Past that the state is given up on and the sandbox ended, so that neither the
+			// destructor nor the watchdog waits on it again
+			if (::WaitForSingleObject(this->process.get(), static_cast<DWORD>(HUNG * 1000)) != WAIT_OBJECT_0)
+			{
+				TRACE("sandbox " << this->header->Name << " didn't quit in time to hand off its state");
+				::TerminateProcess(this->process.get(), 1);
+				return {};
+			}
+
+			// Only a sandbox that ran to the end wrote anything
+			DWORD code = 1;
+			if (!::GetExitCodeProcess(this->process.get(), &code) || code != 0)
+			{
+				TRACE("sandbox " << this->header->Name << " failed before handing off its state");
+				return {};
+			}
+		}
+
+		const LONG size = Read(&this->header->StateSize);
+		const uint8_t* state = GetSandboxState(this->header);
+		return std::vector<uint8_t>(state, state + size);
+	}
+
+	void SandboxVisualizer::Restore(const std::vector<uint8_t>& state)
+	{
+		if (state.size() > this->header->StateCapacity)
+		{
+			TRACE("dropped " << state.size() << " bytes of state too large to hand to sandbox " << this->header->Name);
+			return;
+		}
+
+		std::copy(state.begin(), state.end(), GetSandboxState(this->header));
+		::InterlockedExchange(&this->header->StateSize, static_cast<LONG>(state.size()));
+	}
+
+	double SandboxVisualizer::Cpu()
+	{
+		JOBOBJECT_BASIC_ACCOUNTING_INFORMATION accounting{};
+		if (Job() == nullptr
+			|| !::QueryInformationJobObject(Job(), JobObjectBasicAccountingInformation, &accounting, sizeof(accounting), nullptr))
+		{
+			return 0.0;
+		}
+
+		return (accounting.TotalUserTime.QuadPart + accounting.TotalKernelTime.QuadPart) / 1e7;
+	}
+
+	void SandboxVisualizer::Render()
+	{
+		const LONG generation = Read(&this->header->Surface);
+		if (generation != this->surfaceGeneration)
+		{
+			this->surface.Reset();
+			this->surfaceMutex.Reset();
+			this->surfaceGeneration = generation;
+
+			GUARD(this->d3dDevice->OpenSharedResourceByName(
+				Name(this->id, L".Surface." + std::to_wstring(generation)).c_str(),
+				DXGI_SHARED_RESOURCE_READ | DXGI_SHARED_RESOURCE_WRITE,
+				IID_PPV_ARGS(this->surface.ReleaseAndGetAddressOf())), result)
+			{
+				TRACE("failed to open sandbox surface: " << std::hex << result);
+				return;
+			}
+
+			this->surface.As(&this->surfaceMutex);
+		}
+
+		const LONG64 rendered = Read(&this->header->Rendered);
+		if (!this->surfaceMutex || rendered == this->shown)
+		{
+			return;
+		}
+
+		// Don't wait on the sandbox, we'll pick the frame up next time
+		if (this->surfaceMutex->AcquireSync(0, 0) != S_OK)
+		{
+			return;
+		}
+
+		ComPtr<ID3D11Texture2D> buffer;
+		if (SUCCEEDED(this->dependencies.DxgiSwapChain->GetBuffer(0, IID_PPV_ARGS(buffer.GetAddressOf()))))
+		{
+			D3D11_TEXTURE2D_DESC source, destination;
+			this->surface->GetDesc(&source);
+			buffer->GetDesc(&destination);
+
+			// Sizes disagree for a frame or two while the sandbox catches up with a resize
+			if (source.Width == destination.Width && source.Height == destination.Height)
+			{
+				this->d3dDeviceContext->CopyResource(buffer.Get(), this->surface.Get());
+				this->shown = rendered;
+			}
+		}
+
+		this->surfaceMutex->ReleaseSync(0);
+		this->dependencies.DxgiSwapChain->Present(1, 0);
+	}
+
+	int Sandbox::Run(const std::wstring& id)
+	{
+		KernelHandle mapping(::OpenFileMappingW(FILE_MAP_ALL_ACCESS, FALSE, Name(id).c_str()));
+		KernelHandle frame(::OpenEventW(SYNCHRONIZE | EVENT_MODIFY_STATE, FALSE, Name(id, L".Frame").c_str()));
+		if (!mapping || !frame)
+		{
+			return 1;
+		}
+
+		MappedView view(::MapViewOfFile(mapping.get(), FILE_MAP_ALL_ACCESS, 0, 0, 0));
+		if (!view)
+		{
+			return 1;
+		}
+
+		SandboxHeader* header = static_cast<SandboxHeader*>(view.get());
+		KernelHandle parent(reinterpret_cast<HANDLE>(static_cast<uintptr_t>(header->Parent)));
+		if (!Plugins::Load(header->Source))
+		{
+			return 1;
+		}
+
+		const std::vector<Plugin>& plugins = Plugins::Get();
+		auto plugin = std::find_if(
+			plugins.begin(),
+			plugins.end(),
+			[header](const Plugin& plugin) { return plugin.Name == header->Name; });
+		if (plugin == plugins.end())
+		{
+			return 1;
+		}
+
+		// Our local copy of the features, which the plugin holds a pointer to
+		std::vector<float> spectrum(header->SpectrumCapacity);
+		std::vector<float> bands(header->BandCapacity);
+		DanceFeatures features{};
+		features.Size = sizeof(DanceFeatures);
+		features.Spectrum = spectrum.data();
+		features.Bands = bands.data();
+
+		LONG width = Read(&header->Width);
+		LONG height = Read(&header->Height);
+		LONG sized = Read(&header->Sized);
+		Offscreen offscreen(width, height, false);
+
+		Visualizer::Dependencies dependencies = offscreen.Dependencies();
+		if (plugin->Shared)
+		{
+			dependencies.Features = &features;
+		}
+
+		// Fill in the features before the plugin sees them
+		const auto receive = [&]() -> double
+		{
+			for (;;)
+			{
+				const LONG64 published = Read(&header->Published);
+				if (published == 0)
+				{
+					return 0.0;
+				}
+
+				SandboxSlot* slot = GetSandboxSlot(header, published);
+				const LONG64 sequence = Read(&slot->Sequence);
+				if (sequence != published * 2)
+				{
+					continue;
+				}
+
+				const double elapsed = slot->Elapsed;
+				if (slot->Analyzed)
+				{
+					const float* source = GetSandboxSpectrum(slot);
+					features.SampleRate = slot->SampleRate;
+					features.SpectrumSize = std::min(slot->SpectrumSize, header->SpectrumCapacity);
+					features.BandCount = std::min(slot->BandCount, header->BandCapacity);
+					features.Frame = slot->Frame;
+					features.Level = slot->Level;
+					features.Peak = slot->Peak;
+					std::copy(source, source + features.SpectrumSize, spectrum.begin());
+					std::copy(source + header->SpectrumCapacity, source + header->SpectrumCapacity + features.BandCount, bands.begin());
+				}
+
+				// The runtime lapped us while we were copying, so try again with the newer frame
+				if (Read(&slot->Sequence) == sequence)
+				{
+					return elapsed;
+				}
+			}
+		};
+		receive();
+
+		Visualizer* visualizer = plugin->Constructor(dependencies);
+
+		// Pick up state left by the runtime or by our predecessor, clearing it so a relaunch after a crash doesn't
+		// rewind the visualizer
+		if (const LONG size = Read(&header->StateSize); size > 0)
+		{
+			const uint8_t* state = GetSandboxState(header);
+			visualizer->Restore(std::vector<uint8_t>(state, state + size));
+			::InterlockedExchange(&header->StateSize, 0);
+		}
+
+		ComPtr<ID3D11DeviceContext> context;
+		dependencies.D3dDevice->GetImmediateContext(context.GetAddressOf());
+
+		ComPtr<ID3D11Texture2D> surface;
+		ComPtr<IDXGIKeyedMutex> surfaceMutex;
+		KernelHandle surfaceHandle;
+		const auto share = [&]()
+		{
+			surface.Reset();
+			surfaceMutex.Reset();
+			surfaceHandle.reset();
+
+			D3D11_TEXTURE2D_DESC description{};
+			description.Width = width;
+			description.Height = height;
+			description.MipLevels = 1;
+			description.ArraySize = 1;
+			description.Format = DXGI_FORMAT_B8G8R8A8_UNORM;
+			description.SampleDesc.Count = 1;
+			description.Usage = D3D11_USAGE_DEFAULT;
+			description.BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
+			description.MiscFlags = D3D11_RESOURCE_MISC_SHARED_NTHANDLE | D3D11_RESOURCE_MISC_SHARED_KEYEDMUTEX;
+			OKE(dependencies.D3dDevice->CreateTexture2D(&description, nullptr, surface.GetAddressOf()));
+			OKE(surface.As(&surfaceMutex));
+
+			// The runtime opens the surface by name, which stays valid as long as we hold the handle
+			const LONG generation = Read(&header->Surface) + 1;
+			ComPtr<IDXGIResource1> resource;
+			OKE(surface.As(&resource));
+			HANDLE handle = nullptr;
+			OKE(resource->CreateSharedHandle(
+				nullptr,
+				DXGI_SHARED_RESOURCE_READ | DXGI_SHARED_RESOURCE_WRITE,
+				Name(id, L".Surface." + std::to_wstring(generation)).c_str(),
+				&handle));
+			surfaceHandle.reset(handle);
+			::InterlockedExchange(&header->Surface, generation);
+		};
+		share();
+
+		double then = 0.0;
+		const HANDLE waits[] = { frame.get(), parent.get() };
+		while (!Read(&header->Quit))
+		{
+			// Exit along with the runtime, which would otherwise leave us waiting for frames that never come. Nobody is
+			// left to take our state, and the plugin isn't trusted to clean up without hanging
+			const DWORD woken = ::WaitForMultipleObjects(parent ? 2 : 1, waits, FALSE, POLLING);
+			if (woken == WAIT_OBJECT_0 + 1)
+			{
+				return 1;
+			}
+
+			if (woken != WAIT_OBJECT_0 || Read(&header->Quit))
+			{
+				continue;
+			}
+
+			if (Read(&header->Sized) != sized)
+			{
+				sized = Read(&header->Sized);
+				width = Read(&header->Width);
+				height = Read(&header->Height);
+				visualizer->Unsize();
+				offscreen.Resize(width, height);
+				visualizer->Resize({ 0, 0, width, height });
+				share();
+			}
+
+			const double now = receive();
+			visualizer->Update(now - then);
+			visualizer->Render();
+			then = now;
+
+			// With the flip model the frame the plugin just presented has rotated to the last buffer
+			DXGI_SWAP_CHAIN_DESC1 description;
+			dependencies.DxgiSwapChain->GetDesc1(&description);
+			ComPtr<ID3D11Texture2D> presented;
+			if (SUCCEEDED(dependencies.DxgiSwapChain->GetBuffer(description.BufferCount - 1, IID_PPV_ARGS(presented.GetAddressOf())))
+				&& surfaceMutex->AcquireSync(0, POLLING) == S_OK)
+			{
+				context->CopyResource(surface.Get(), presented.Get());
+				surfaceMutex->ReleaseSync(0);
+				context->Flush();
+			}
+
+			::InterlockedIncrement64(&header->Rendered);
+		}
+
+		// Leave our state behind for whichever sandbox launches next
+		const std::vector<uint8_t> state = visualizer->Serialize();
+		if (state.size() <= header->StateCapacity)
+		{
+			std::copy(state.begin(), state.end(), GetSandboxState(header));
+			::InterlockedExchange(&header->StateSize, static_cast<LONG>(state.size()));
+		}
+		else
+		{
+			TRACE("dropped " << state.size() << " bytes of state too large to hand off");
+		}
+
+		plugin->Destructor(visualizer);
+		return 0;
+	}
+}
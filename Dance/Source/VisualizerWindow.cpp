@@ -1,4 +1,6 @@
 #include "VisualizerWindow.h"
+#include "Audio.h"
+#include "Sandbox.h"
 
 namespace Dance::Application
 {
@@ -23,12 +25,22 @@ namespace Dance::Application
 	VisualizerWindow::~VisualizerWindow()
 	{
 		// Destroy the visualizer
-		this->plugin.get().Destructor(this->visualizer);
+		this->destructor(this->visualizer);
+	}
+
+	void VisualizerWindow::Isolate(bool isolated)
+	{
+		this->isolated = isolated;
+	}
+
+	void VisualizerWindow::Govern(double silence, double rate)
+	{
+		this->governor.Configure(silence, rate);
 	}
 
 	Visualizer::Dependencies VisualizerWindow::Dependencies() const
 	{
-		return {
+		Visualizer::Dependencies dependencies{
 			this->instance,
 			this->window,
 			this->d3dDevice,
@@ -36,6 +48,13 @@ namespace Dance::Application
 			this->dxgiSwapChain,
 			this->d2dDevice
 		};
+
+		if (this->features)
+		{
+			dependencies.Features = this->features->Block();
+		}
+
+		return dependencies;
 	}
 
 	HRESULT VisualizerWindow::Create()
@@ -50,6 +69,9 @@ namespace Dance::Application
 			this->dxgiDevice.Get(),
 			this->d2dDevice.ReleaseAndGetAddressOf()));
 
+		// Without a meter we simply never throttle
+		this->governor.Create();
+
 		this->Switch(Plugins::First());
 
 		return S_OK;
@@ -101,11 +123,36 @@ namespace Dance::Application
 
 	void VisualizerWindow::Render()
 	{
-		this->visualizer->Render();
+		if (this->admitted)
+		{
+			this->visualizer->Render();
+		}
 	}
 
 	void VisualizerWindow::Update(double delta)
 	{
+		this->Reload();
+
+		// While throttled, validate the window so that the wait isn't cut short by the WM_PAINT we never clear, sleep
+		// until the next idle frame or any input, then invalidate it again so the loop comes back around
+		this->admitted = this->governor.Admit();
+		if (!this->admitted)
+		{
+			this->withheld += delta;
+			::ValidateRect(this->window, nullptr);
+			::MsgWaitForMultipleObjects(0, nullptr, FALSE, this->governor.Wait(), QS_ALLINPUT);
+			::InvalidateRect(this->window, nullptr, FALSE);
+			return;
+		}
+
+		delta += this->withheld;
+		this->withheld = 0.0;
+
+		if (this->plugin.get().Shared && this->features)
+		{
+			this->features->Listen();
+		}
+
 		this->visualizer->Update(delta);
 	}
 
@@ -113,15 +160,86 @@ namespace Dance::Application
 	{
 		if (this->visualizer != nullptr)
 		{
-			this->plugin.get().Destructor(this->visualizer);
+			this->destructor(this->visualizer);
+		}
+
+		// Only capture while the visualizer is reading the shared features
+		if (plugin.Shared)
+		{
+			if (!this->features)
+			{
+				this->features = std::make_unique<Dance::Audio::Features>(Dance::Audio::getDefaultAudioDevice(), ONE_SECOND / 20);
+			}
+			this->features->Enable();
+		}
+		else if (this->features)
+		{
+			this->features->Disable();
 		}
 
 		this->plugin = plugin;
-		this->visualizer = plugin.Constructor(this->Dependencies());
+		this->visualizer = this->Construct(plugin);
 		::SetWindowText(this->window, plugin.Name.data());
 		return 0;
 	}
 
+	Visualizer* VisualizerWindow::Construct(const Plugin& plugin)
+	{
+		if (this->isolated)
+		{
+			this->destructor = Visualizer::Delete;
+			return new SandboxVisualizer(plugin, this->Dependencies());
+		}
+
+		this->destructor = plugin.Destructor;
+		return plugin.Constructor(this->Dependencies());
+	}
+
+	void VisualizerWindow::Reload()
+	{
+		for (const std::filesystem::path& source : Plugins::Modified())
+		{
+			// New registrations can grow the plugin vector, so our reference is looked up again by index
+			if (this->plugin.get().Source != source)
+			{
+				const size_t index = this->plugin.get().Index;
+				Plugins::Reload(source);
+				this->plugin = Plugins::Get().at(index);
+				continue;
+			}
+
+			// Declared first so that the old module outlives everything below that points into its code
+			std::unique_ptr<Module> retired;
+			{
+				const size_t index = this->plugin.get().Index;
+				const Visualizer::Destructor destructor = this->destructor;
+				const std::vector<uint8_t> state = this->visualizer->Serialize();
+
+				retired = Plugins::Reload(source);
+				if (!retired)
+				{
+					continue;
+				}
+
+				// The rebuild stopped registering our plugin, so there's nothing to hand the state to
+				const Plugin& plugin = Plugins::Get().at(index);
+				if (!plugin.Available)
+				{
+					destructor(this->visualizer);
+					this->visualizer = nullptr;
+					this->Switch(Plugins::First());
+					continue;
+				}
+
+				Visualizer* previous = this->visualizer;
+				this->plugin = plugin;
+				this->visualizer = this->Construct(plugin);
+				this->visualizer->Restore(state);
+				destructor(previous);
+			}
+		}
+	}
+
 	LRESULT VisualizerWindow::MouseMove(WPARAM wParam, LPARAM lParam)
 	{
 		this->isMouseHovering = true;
@@ -167,6 +285,11 @@ namespace Dance::Application
 		HMENU menu = ::CreatePopupMenu();
 		for (const Plugin& plugin : Plugins::Get())
 		{
+			if (!plugin.Available)
+			{
+				continue;
+			}
+
 			BET(::AppendMenu(
 				menu,
 				MF_BYPOSITION | MF_STRING | (this->plugin.get().Index == plugin.Index ? MF_CHECKED | MF_DISABLED : 0),
@@ -205,9 +328,9 @@ namespace Dance::Application
 				::DestroyWindow(this->window);
 				return 0;
 			}
-			else
+			else if (index < Plugins::Get().size() && Plugins::Get()[index].Available)
 			{
-				return this->Switch(Plugins::Get().at(index));
+				return this->Switch(Plugins::Get()[index]);
 			}
 		}
 
@@ -216,6 +339,10 @@ namespace Dance::Application
 
 	LRESULT VisualizerWindow::Close()
 	{
+		const Governor::Statistics& statistics = this->governor.Report();
+		TRACE("governor went idle " << statistics.Idled << " times, skipped " << statistics.Skipped
+			<< " frames and saved " << statistics.Saved << " s of CPU");
+
 		// Close the window
 		this->Destroy();
 
@@ -159,6 +159,13 @@ namespace Dance::Audio
         /// @exception ComError if format determination fails, audio client initialization fails, or capture setup fails.
         AudioAnalyzer(ComPtr<IMMDevice> device, REFERENCE_TIME duration);
 
+        /// Initialize an audio analyzer that isn't bound to a capture device. Audio is instead passed directly to
+        /// AudioAnalyzer::Handle as interleaved stereo floats, which is how headless hosts provide audio.
+        /// 
+        /// @param samplesPerSecond is the sample rate of the audio that will be handled.
+        /// @param duration is a duration in 100 ns intervals that determines the analysis window.
+        AudioAnalyzer(DWORD samplesPerSecond, REFERENCE_TIME duration);
+
         /// We override the handle method to write the audio frame to our ring buffer for later analysis. Because this
         /// buffer is written to circularly, it may have to be reordered prior to analysis.
         /// 
@@ -175,10 +182,24 @@ namespace Dance::Audio
         /// @returns a const reference to the complex spectrum output.
         const std::vector<FFTWFComplex>& Spectrum() const;
 
+        /// Get a reference to the samples the spectrum was computed from. The ring may be partially filled and isn't
+        /// in chronological order, which doesn't matter for order-independent statistics like level and peak.
+        /// 
+        /// @returns a const reference to the sample buffer.
+        const Ring<float>& Samples() const;
+
+        /// Get the sample rate of the analyzed audio.
+        /// 
+        /// @returns the number of frames per second.
+        DWORD SampleRate() const;
+
     protected:
         /// The number of audio frames to use for the FFT.
         size_t window{ 0 };
 
+        /// Frames per second of the analyzed audio.
+        DWORD samplesPerSecond{ 0 };
+
         /// Audio adapter
         std::unique_ptr<AudioAdapter> adapter;
 
@@ -190,5 +211,11 @@ namespace Dance::Audio
 
         /// A container for the result of the FFT.
         std::vector<FFTWFComplex> spectrum;
+
+        /// Size the sample buffer and spectrum for the analysis window and create the FFT plan.
+        /// 
+        /// @param samplesPerSecond is the sample rate of the analyzed audio.
+        /// @param duration is a duration in 100 ns intervals that determines the analysis window.
+        void Plan(DWORD samplesPerSecond, REFERENCE_TIME duration);
     };
 }
@@ -16,5 +16,8 @@ namespace Dance::Audio
 
     protected:
         AudioAnalyzer analyzer;
+
+        /// Host-provided audio used in place of loopback capture, empty when capturing.
+        std::function<size_t(const float*& frames)> source;
     };
 }
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Interface.h"
+#include "AudioAnalyzer.h"
+
+#include <vector>
+
+namespace Dance::Audio
+{
+    /// Owns the single audio analysis stack of the runtime and publishes its results as a DanceFeatures block. The
+    /// block is handed to every visualizer registered through the C ABI, so plugins no longer capture and transform
+    /// audio themselves. Not copyable or movable since plugins hold pointers into it.
+    class Features
+    {
+    public:
+        /// Number of logarithmically spaced bands summarized from the spectrum.
+        static constexpr size_t BANDS = 32;
+
+        /// Analyze loopback capture of a system audio device.
+        ///
+        /// @param device expects a ComPtr to a system audio device.
+        /// @param duration is a duration in 100 ns intervals that determines the analysis window.
+        /// @exception ComError if the analyzer can't capture from the device.
+        Features(ComPtr<IMMDevice> device, REFERENCE_TIME duration);
+
+        /// Analyze audio passed in through Features::Handle rather than captured from a device.
+        ///
+        /// @param samplesPerSecond is the sample rate of the audio that will be handled.
+        /// @param duration is a duration in 100 ns intervals that determines the analysis window.
+        Features(DWORD samplesPerSecond, REFERENCE_TIME duration);
+
+        Features(const Features&) = delete;
+        Features& operator=(const Features&) = delete;
+
+        /// Start capturing. Capture may be stopped while no visualizer needs features.
+        ///
+        /// @returns the result of starting the audio client.
+        HRESULT Enable();
+
+        /// Stop capturing.
+        ///
+        /// @returns the result of stopping the audio client.
+        HRESULT Disable();
+
+        /// Read any newly captured audio and recompute the features if there was some.
+        ///
+        /// @exception ComError if any capture client operations fail.
+        /// @returns whether the features were recomputed.
+        bool Listen();
+
+        /// Analyze interleaved stereo float frames directly and recompute the features.
+        ///
+        /// @param frames points to count interleaved stereo frames.
+        /// @param count is the number of frames.
+        void Handle(const float* frames, size_t count);
+
+        /// Get the feature block. The address is stable for the lifetime of this object.
+        ///
+        /// @returns a pointer to the published block.
+        const DanceFeatures* Block() const;
+
+    private:
+        AudioAnalyzer analyzer;
+
+        /// Normalized spectrum magnitudes backing DanceFeatures::Spectrum.
+        std::vector<float> spectrum;
+
+        /// Per-band means backing DanceFeatures::Bands.
+        std::vector<float> bands;
+
+        /// First spectrum bin of each band, followed by one past the last bin of the last band.
+        std::vector<size_t> edges;
+
+        /// The published block.
+        DanceFeatures block{};
+
+        /// Size the feature arrays for the analyzer's spectrum and point the block at them.
+        void Bind();
+
+        /// Derive the published features from the analyzer's latest spectrum and samples.
+        void Compute();
+    };
+}
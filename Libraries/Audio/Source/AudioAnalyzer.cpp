@@ -8,19 +8,7 @@ namespace Dance::Audio
         : AudioListener(device, duration)
         , fft()
     {
-        // The window is how much data we will ever analyze at once; we calculate it from duration
-        this->window = static_cast<size_t>(duration) * this->waveFormat->nSamplesPerSec / ONE_SECOND;
-
-        // Resize the data container to fit our window continuously at any index
-        this->buffer.Resize(this->window);
-        this->spectrum.resize(this->window / 2 + 1);
-
-        // Create the FFT plan
-        this->fft.Overwrite(::fftwf_plan_dft_r2c_1d(
-            this->window,
-            reinterpret_cast<float*>(this->buffer.Data()),
-            reinterpret_cast<fftwf_complex*>(this->spectrum.data()),
-            static_cast<unsigned int>(FFTW_MEASURE)));
+        this->Plan(this->waveFormat->nSamplesPerSec, duration);
 
         // Determine what kind of audio adapter we need
         if (this->waveFormat->wFormatTag == WAVE_FORMAT_PCM)
@@ -64,6 +52,33 @@ namespace Dance::Audio
         }
     }
 
+    AudioAnalyzer::AudioAnalyzer(DWORD samplesPerSecond, REFERENCE_TIME duration)
+        : AudioListener()
+        , fft()
+    {
+        this->Plan(samplesPerSecond, duration);
+        this->adapter = std::make_unique<StaticAudioAdapter<float>>(2);
+    }
+
+    void AudioAnalyzer::Plan(DWORD samplesPerSecond, REFERENCE_TIME duration)
+    {
+        this->samplesPerSecond = samplesPerSecond;
+
+        // The window is how much data we will ever analyze at once; we calculate it from duration
+        this->window = static_cast<size_t>(duration) * samplesPerSecond / ONE_SECOND;
+
+        // Resize the data container to fit our window continuously at any index
+        this->buffer.Resize(this->window);
+        this->spectrum.resize(this->window / 2 + 1);
+
+        // Create the FFT plan
+        this->fft.Overwrite(::fftwf_plan_dft_r2c_1d(
+            this->window,
+            reinterpret_cast<float*>(this->buffer.Data()),
+            reinterpret_cast<fftwf_complex*>(this->spectrum.data()),
+            static_cast<unsigned int>(FFTW_MEASURE)));
+    }
+
     void AudioAnalyzer::Handle(const void* data, size_t count, DWORD flags)
     {
         // https://stackoverflow.com/questions/64158704/wasapi-captured-packets-do-not-align
@@ -89,4 +104,14 @@ namespace Dance::Audio
     {
         return this->spectrum;
     }
+
+    const Ring<float>& AudioAnalyzer::Samples() const
+    {
+        return this->buffer;
+    }
+
+    DWORD AudioAnalyzer::SampleRate() const
+    {
+        return this->samplesPerSecond;
+    }
 }
\ No newline at end of file
@@ -78,12 +78,23 @@ namespace Dance::Audio
 
     HRESULT AudioListener::Enable()
     {
+        // Nothing to start if we were constructed without a device
+        if (this->audioClient == nullptr)
+        {
+            return S_OK;
+        }
+
         OK(this->audioClient->Start());
         return S_OK;
     }
 
     HRESULT AudioListener::Disable()
     {
+        if (this->audioClient == nullptr)
+        {
+            return S_OK;
+        }
+
         OK(this->audioClient->Stop());
         return S_OK;
     }
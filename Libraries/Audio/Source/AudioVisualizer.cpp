@@ -5,7 +5,15 @@
 namespace Dance::Audio
 {
     AudioVisualizer::AudioVisualizer(const Visualizer::Dependencies& dependencies)
+        : source(dependencies.AudioSource)
     {
+        // Headless hosts feed us audio directly
+        if (this->source)
+        {
+            this->analyzer = AudioAnalyzer(dependencies.AudioSampleRate, ONE_SECOND / 20);
+            return;
+        }
+
         ComPtr<IMMDevice> device = Dance::Audio::getDefaultAudioDevice();
         TRACE("capturing " << Dance::Audio::getAudioDeviceFriendlyName(device.Get()));
         this->analyzer = AudioAnalyzer(device, ONE_SECOND / 20);
@@ -19,6 +27,17 @@ namespace Dance::Audio
 
     void AudioVisualizer::Update(double delta)
     {
+        if (this->source)
+        {
+            const float* frames = nullptr;
+            if (size_t count = this->source(frames))
+            {
+                this->analyzer.Handle(frames, count, 0);
+                this->analyzer.Analyze();
+            }
+            return;
+        }
+
         if (this->analyzer.Listen())
         {
             this->analyzer.Analyze();
@@ -0,0 +1,120 @@
+#include "Features.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Dance::Audio
+{
+    /// Lower edge of the lowest band in Hz, below which there's little worth visualizing.
+    constexpr double LOWEST_FREQUENCY = 20.0;
+
+    Features::Features(ComPtr<IMMDevice> device, REFERENCE_TIME duration)
+        : analyzer(device, duration)
+    {
+        this->Bind();
+    }
+
+    Features::Features(DWORD samplesPerSecond, REFERENCE_TIME duration)
+        : analyzer(samplesPerSecond, duration)
+    {
+        this->Bind();
+    }
+
+    void Features::Bind()
+    {
+        const size_t size = this->analyzer.Spectrum().size();
+        const double rate = this->analyzer.SampleRate();
+        const double nyquist = rate / 2.0;
+        const double window = static_cast<double>(size - 1) * 2.0;
+
+        // Space the bands evenly in log frequency, but never narrower than a single bin
+        this->edges.resize(Features::BANDS + 1);
+        for (size_t i = 0; i <= Features::BANDS; ++i)
+        {
+            const double frequency = LOWEST_FREQUENCY * std::pow(nyquist / LOWEST_FREQUENCY, static_cast<double>(i) / Features::BANDS);
+            const size_t bin = static_cast<size_t>(std::lround(frequency * window / rate));
+            this->edges[i] = std::min(i > 0 ? std::max(bin, this->edges[i - 1] + 1) : bin, size);
+        }
+
+        this->spectrum.resize(size);
+        this->bands.resize(Features::BANDS);
+
+        this->block.Size = sizeof(DanceFeatures);
+        this->block.Frame = 0;
+        this->block.SampleRate = this->analyzer.SampleRate();
+        this->block.SpectrumSize = static_cast<uint32_t>(this->spectrum.size());
+        this->block.Spectrum = this->spectrum.data();
+        this->block.BandCount = static_cast<uint32_t>(this->bands.size());
+        this->block.Bands = this->bands.data();
+    }
+
+    HRESULT Features::Enable()
+    {
+        return this->analyzer.Enable();
+    }
+
+    HRESULT Features::Disable()
+    {
+        return this->analyzer.Disable();
+    }
+
+    bool Features::Listen()
+    {
+        if (!this->analyzer.Listen())
+        {
+            return false;
+        }
+
+        this->analyzer.Analyze();
+        this->Compute();
+        return true;
+    }
+
+    void Features::Handle(const float* frames, size_t count)
+    {
+        this->analyzer.Handle(frames, count, 0);
+        this->analyzer.Analyze();
+        this->Compute();
+    }
+
+    const DanceFeatures* Features::Block() const
+    {
+        return &this->block;
+    }
+
+    void Features::Compute()
+    {
+        const std::vector<FFTWFComplex>& source = this->analyzer.Spectrum();
+        const size_t normalize = source.size();
+        for (size_t i = 0; i < source.size(); ++i)
+        {
+            this->spectrum[i] = source[i].magnitude(normalize);
+        }
+
+        for (size_t i = 0; i < this->bands.size(); ++i)
+        {
+            const size_t start = this->edges[i];
+            const size_t end = this->edges[i + 1];
+            float sum = 0.0f;
+            for (size_t j = start; j < end; ++j)
+            {
+                sum += this->spectrum[j];
+            }
+            this->bands[i] = end > start ? sum / (end - start) : 0.0f;
+        }
+
+        const Ring<float>& samples = this->analyzer.Samples();
+        float squares = 0.0f;
+        float peak = 0.0f;
+        for (size_t i = 0; i < samples.Size(); ++i)
+        {
+            const float sample = samples.Data()[i];
+            squares += sample * sample;
+            peak = std::max(peak, std::abs(sample));
+        }
+
+        this->block.Level = samples.Size() > 0 ? std::sqrt(squares / samples.Size()) : 0.0f;
+        this->block.Peak = peak;
+        this->block.Frame += 1;
+    }
+}
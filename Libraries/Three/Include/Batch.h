@@ -0,0 +1,402 @@
+#pragma once
+
+#include "Bounds.h"
+#include "FastMath.h"
+#include "Lanes.h"
+#include "Vector3.h"
+#include "Quaternion.h"
+#include "Matrix4.h"
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace Dance::Three::Math
+{
+    /// Structure-of-arrays storage for many Vector3s, one contiguous array per component. Loading four or eight
+    /// consecutive x components is then a single instruction, so the batch kernels below process that many vectors
+    /// at once with no shuffling.
+    template<typename T>
+    class Vector3Array
+    {
+    public:
+        std::vector<T> x;
+        std::vector<T> y;
+        std::vector<T> z;
+
+        Vector3Array() = default;
+        explicit Vector3Array(size_t count) : x(count), y(count), z(count) {}
+
+        size_t Size() const
+        {
+            return this->x.size();
+        }
+
+        void Resize(size_t count)
+        {
+            this->x.resize(count);
+            this->y.resize(count);
+            this->z.resize(count);
+        }
+
+        Vector3<T> Get(size_t i) const
+        {
+            return Vector3<T>(this->x[i], this->y[i], this->z[i]);
+        }
+
+        void Set(size_t i, const Vector3<T>& v)
+        {
+            this->x[i] = v.x;
+            this->y[i] = v.y;
+            this->z[i] = v.z;
+        }
+    };
+
+    /// Structure-of-arrays storage for many Quaternions.
+    template<typename T>
+    class QuaternionArray
+    {
+    public:
+        std::vector<T> x;
+        std::vector<T> y;
+        std::vector<T> z;
+        std::vector<T> w;
+
+        QuaternionArray() = default;
+        explicit QuaternionArray(size_t count) : x(count), y(count), z(count), w(count, 1) {}
+
+        size_t Size() const
+        {
+            return this->x.size();
+        }
+
+        void Resize(size_t count)
+        {
+            this->x.resize(count);
+            this->y.resize(count);
+            this->z.resize(count);
+            this->w.resize(count, 1);
+        }
+
+        Quaternion<T> Get(size_t i) const
+        {
+            return Quaternion<T>(this->x[i], this->y[i], this->z[i], this->w[i]);
+        }
+
+        void Set(size_t i, const Quaternion<T>& q)
+        {
+            this->x[i] = q.x;
+            this->y[i] = q.y;
+            this->z[i] = q.z;
+            this->w[i] = q.w;
+        }
+    };
+
+    /// Structure-of-arrays storage for many bounding spheres.
+    template<typename T>
+    class SphereArray
+    {
+    public:
+        std::vector<T> x;
+        std::vector<T> y;
+        std::vector<T> z;
+        std::vector<T> radius;
+
+        SphereArray() = default;
+        explicit SphereArray(size_t count) : x(count), y(count), z(count), radius(count) {}
+
+        size_t Size() const
+        {
+            return this->x.size();
+        }
+
+        void Resize(size_t count)
+        {
+            this->x.resize(count);
+            this->y.resize(count);
+            this->z.resize(count);
+            this->radius.resize(count);
+        }
+
+        Sphere<T> Get(size_t i) const
+        {
+            return Sphere<T>(Vector3<T>(this->x[i], this->y[i], this->z[i]), this->radius[i]);
+        }
+
+        void Set(size_t i, const Sphere<T>& sphere)
+        {
+            this->x[i] = sphere.center.x;
+            this->y[i] = sphere.center.y;
+            this->z[i] = sphere.center.z;
+            this->radius[i] = sphere.radius;
+        }
+    };
+
+    /// Structure-of-arrays storage for many axis-aligned boxes, kept as centers and extents since that is what the
+    /// plane tests use.
+    template<typename T>
+    class AABBArray
+    {
+    public:
+        Vector3Array<T> center;
+        Vector3Array<T> extent;
+
+        AABBArray() = default;
+        explicit AABBArray(size_t count) : center(count), extent(count) {}
+
+        size_t Size() const
+        {
+            return this->center.Size();
+        }
+
+        void Resize(size_t count)
+        {
+            this->center.Resize(count);
+            this->extent.Resize(count);
+        }
+
+        AABB<T> Get(size_t i) const
+        {
+            return AABB<T>::FromCenter(this->center.Get(i), this->extent.Get(i));
+        }
+
+        void Set(size_t i, const AABB<T>& box)
+        {
+            this->center.Set(i, box.Center());
+            this->extent.Set(i, box.Extent());
+        }
+    };
+
+    using Vector3ArrayF = Vector3Array<float>;
+    using QuaternionArrayF = QuaternionArray<float>;
+    using SphereArrayF = SphereArray<float>;
+    using AABBArrayF = AABBArray<float>;
+
+    /// Transform every vector by a matrix, with w as the implied fourth component. The output is resized to match
+    /// and may be the input.
+    inline void Transform(const Matrix4<float>& m, const Vector3ArrayF& in, Vector3ArrayF& out, float w = 1.0f)
+    {
+        out.Resize(in.Size());
+        Simd::Sweep(in.Size(), [&](auto lane, size_t i)
+        {
+            using L = decltype(lane);
+            const L x = L::Load(&in.x[i]);
+            const L y = L::Load(&in.y[i]);
+            const L z = L::Load(&in.z[i]);
+            for (int j = 0; j < 3; ++j)
+            {
+                const L result = x * L::Broadcast(m.value[0][j])
+                    + y * L::Broadcast(m.value[1][j])
+                    + z * L::Broadcast(m.value[2][j])
+                    + L::Broadcast(w * m.value[3][j]);
+                result.Store(j == 0 ? &out.x[i] : j == 1 ? &out.y[i] : &out.z[i]);
+            }
+        });
+    }
+
+    /// Normalize every vector in place.
+    inline void Normalize(Vector3ArrayF& v)
+    {
+        Simd::Sweep(v.Size(), [&](auto lane, size_t i)
+        {
+            using L = decltype(lane);
+            const L x = L::Load(&v.x[i]);
+            const L y = L::Load(&v.y[i]);
+            const L z = L::Load(&v.z[i]);
+            const L length = Sqrt(x * x + y * y + z * z);
+            (x / length).Store(&v.x[i]);
+            (y / length).Store(&v.y[i]);
+            (z / length).Store(&v.z[i]);
+        });
+    }
+
+    /// Cross every pair of vectors. The output is resized to match and may be either input.
+    inline void Cross(const Vector3ArrayF& a, const Vector3ArrayF& b, Vector3ArrayF& out)
+    {
+        out.Resize(a.Size());
+        Simd::Sweep(a.Size(), [&](auto lane, size_t i)
+        {
+            using L = decltype(lane);
+            const L ax = L::Load(&a.x[i]);
+            const L ay = L::Load(&a.y[i]);
+            const L az = L::Load(&a.z[i]);
+            const L bx = L::Load(&b.x[i]);
+            const L by = L::Load(&b.y[i]);
+            const L bz = L::Load(&b.z[i]);
+            (ay * bz - az * by).Store(&out.x[i]);
+            (az * bx - ax * bz).Store(&out.y[i]);
+            (ax * by - ay * bx).Store(&out.z[i]);
+        });
+    }
+
+    /// Rotate each vector by the matching unit quaternion, v + 2 q.xyz x (q.xyz x v + q.w v). The output is resized
+    /// to match and may be the input.
+    inline void Rotate(const QuaternionArrayF& q, const Vector3ArrayF& in, Vector3ArrayF& out)
+    {
+        out.Resize(in.Size());
+        Simd::Sweep(in.Size(), [&](auto lane, size_t i)
+        {
+            using L = decltype(lane);
+            const L qx = L::Load(&q.x[i]);
+            const L qy = L::Load(&q.y[i]);
+            const L qz = L::Load(&q.z[i]);
+            const L qw = L::Load(&q.w[i]);
+            const L x = L::Load(&in.x[i]);
+            const L y = L::Load(&in.y[i]);
+            const L z = L::Load(&in.z[i]);
+
+            const L tx = qy * z - qz * y + qw * x;
+            const L ty = qz * x - qx * z + qw * y;
+            const L tz = qx * y - qy * x + qw * z;
+            const L two = L::Broadcast(2.0f);
+            (x + two * (qy * tz - qz * ty)).Store(&out.x[i]);
+            (y + two * (qz * tx - qx * tz)).Store(&out.y[i]);
+            (z + two * (qx * ty - qy * tx)).Store(&out.z[i]);
+        });
+    }
+
+    /// Normalized linear interpolation between each pair of unit quaternions along the shorter arc. Cheaper than
+    /// Slerp and close to it for small angles. The output is resized to match and may be either input.
+    inline void Nlerp(const QuaternionArrayF& a, const QuaternionArrayF& b, float f, QuaternionArrayF& out)
+    {
+        out.Resize(a.Size());
+        Simd::Sweep(a.Size(), [&](auto lane, size_t i)
+        {
+            using L = decltype(lane);
+            const L ax = L::Load(&a.x[i]);
+            const L ay = L::Load(&a.y[i]);
+            const L az = L::Load(&a.z[i]);
+            const L aw = L::Load(&a.w[i]);
+            L bx = L::Load(&b.x[i]);
+            L by = L::Load(&b.y[i]);
+            L bz = L::Load(&b.z[i]);
+            L bw = L::Load(&b.w[i]);
+
+            // Flip b onto the same hemisphere as a
+            const L zero = L::Broadcast(0.0f);
+            const auto opposite = ax * bx + ay * by + az * bz + aw * bw < zero;
+            bx = Select(opposite, -bx, bx);
+            by = Select(opposite, -by, by);
+            bz = Select(opposite, -bz, bz);
+            bw = Select(opposite, -bw, bw);
+
+            const L t = L::Broadcast(f);
+            const L x = ax + t * (bx - ax);
+            const L y = ay + t * (by - ay);
+            const L z = az + t * (bz - az);
+            const L w = aw + t * (bw - aw);
+            const L length = Sqrt(x * x + y * y + z * z + w * w);
+            (x / length).Store(&out.x[i]);
+            (y / length).Store(&out.y[i]);
+            (z / length).Store(&out.z[i]);
+            (w / length).Store(&out.w[i]);
+        });
+    }
+
+    /// Spherical linear interpolation between each pair of unit quaternions, matching the scalar Slerp. The angle is
+    /// evaluated per element since there's no vector form of acos here; everything else, including the sines, is done
+    /// a register at a time. The output is resized to match and may be either input.
+    inline void Slerp(const QuaternionArrayF& a, const QuaternionArrayF& b, float f, QuaternionArrayF& out)
+    {
+        out.Resize(a.Size());
+        Simd::Sweep(a.Size(), [&](auto lane, size_t i)
+        {
+            using L = decltype(lane);
+            const L ax = L::Load(&a.x[i]);
+            const L ay = L::Load(&a.y[i]);
+            const L az = L::Load(&a.z[i]);
+            const L aw = L::Load(&a.w[i]);
+            const L bx = L::Load(&b.x[i]);
+            const L by = L::Load(&b.y[i]);
+            const L bz = L::Load(&b.z[i]);
+            const L bw = L::Load(&b.w[i]);
+
+            const L dot = ax * bx + ay * by + az * bz + aw * bw;
+            const L cosom = Abs(dot);
+            const L t = L::Broadcast(f);
+            const L u = L::Broadcast(1.0f - f);
+
+            // Fall back to linear weights where the quaternions are nearly collinear
+            const L omega = Map(Min(cosom, L::Broadcast(1.0f)), [](float c) { return std::acos(c); });
+            const L invSin = L::Broadcast(1.0f) / Fast::Sin(omega);
+            const auto curved = cosom < L::Broadcast(0.9999f);
+            const L scale0 = Select(curved, Fast::Sin(u * omega) * invSin, u);
+            L scale1 = Select(curved, Fast::Sin(t * omega) * invSin, t);
+            scale1 = Select(dot < L::Broadcast(0.0f), -scale1, scale1);
+
+            const L x = scale0 * ax + scale1 * bx;
+            const L y = scale0 * ay + scale1 * by;
+            const L z = scale0 * az + scale1 * bz;
+            const L w = scale0 * aw + scale1 * bw;
+            const L length = Sqrt(x * x + y * y + z * z + w * w);
+            (x / length).Store(&out.x[i]);
+            (y / length).Store(&out.y[i]);
+            (z / length).Store(&out.z[i]);
+            (w / length).Store(&out.w[i]);
+        });
+    }
+
+    /// Test every sphere against the frustum and list the indices of those that may be visible, in order. Each lane
+    /// keeps the smallest plane distance over the six planes so that the visibility is a single comparison. Returns
+    /// the number of visible spheres, which is also the new size of the list.
+    inline size_t Cull(const FrustumF& frustum, const SphereArrayF& spheres, std::vector<uint32_t>& visible)
+    {
+        visible.resize(spheres.Size());
+        size_t count = 0;
+        Simd::Sweep(spheres.Size(), [&](auto lane, size_t i)
+        {
+            using L = decltype(lane);
+            const L x = L::Load(&spheres.x[i]);
+            const L y = L::Load(&spheres.y[i]);
+            const L z = L::Load(&spheres.z[i]);
+            const L radius = L::Load(&spheres.radius[i]);
+
+            L nearest = L::Broadcast(std::numeric_limits<float>::max());
+            for (const Vector4<float>& plane : frustum.planes)
+            {
+                const L distance = x * L::Broadcast(plane.x)
+                    + y * L::Broadcast(plane.y)
+                    + z * L::Broadcast(plane.z)
+                    + L::Broadcast(plane.w);
+                nearest = Min(nearest, distance + radius);
+            }
+            Simd::Compact<L>(nearest >= L::Broadcast(0.0f), i, visible.data(), count);
+        });
+        visible.resize(count);
+        return count;
+    }
+
+    /// Test every box against the frustum and list the indices of those that may be visible, in order. A box reaches
+    /// as far toward each plane as its extent projected onto the absolute normal.
+    inline size_t Cull(const FrustumF& frustum, const AABBArrayF& boxes, std::vector<uint32_t>& visible)
+    {
+        visible.resize(boxes.Size());
+        size_t count = 0;
+        Simd::Sweep(boxes.Size(), [&](auto lane, size_t i)
+        {
+            using L = decltype(lane);
+            const L x = L::Load(&boxes.center.x[i]);
+            const L y = L::Load(&boxes.center.y[i]);
+            const L z = L::Load(&boxes.center.z[i]);
+            const L ex = L::Load(&boxes.extent.x[i]);
+            const L ey = L::Load(&boxes.extent.y[i]);
+            const L ez = L::Load(&boxes.extent.z[i]);
+
+            L nearest = L::Broadcast(std::numeric_limits<float>::max());
+            for (const Vector4<float>& plane : frustum.planes)
+            {
+                const L distance = x * L::Broadcast(plane.x)
+                    + y * L::Broadcast(plane.y)
+                    + z * L::Broadcast(plane.z)
+                    + L::Broadcast(plane.w);
+                const L reach = ex * L::Broadcast(std::abs(plane.x))
+                    + ey * L::Broadcast(std::abs(plane.y))
+                    + ez * L::Broadcast(std::abs(plane.z));
+                nearest = Min(nearest, distance + reach);
+            }
+            Simd::Compact<L>(nearest >= L::Broadcast(0.0f), i, visible.data(), count);
+        });
+        visible.resize(count);
+        return count;
+    }
+}
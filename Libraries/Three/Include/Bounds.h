@@ -0,0 +1,203 @@
+#pragma once
+
+#include "Vector3.h"
+#include "Vector4.h"
+#include "Matrix4.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Dance::Three::Math
+{
+    /// An axis-aligned bounding box. The default box is empty, with min above max, so that including the first point
+    /// makes it exactly that point.
+    template<typename T>
+    class AABB
+    {
+    public:
+        Vector3<T> min;
+        Vector3<T> max;
+
+        AABB()
+            : min(std::numeric_limits<T>::max(), std::numeric_limits<T>::max(), std::numeric_limits<T>::max())
+            , max(std::numeric_limits<T>::lowest(), std::numeric_limits<T>::lowest(), std::numeric_limits<T>::lowest())
+        {}
+
+        explicit AABB(const Vector3<T>& min, const Vector3<T>& max) : min(min), max(max) {}
+
+        static AABB FromCenter(const Vector3<T>& center, const Vector3<T>& extent)
+        {
+            return AABB(center - extent, center + extent);
+        }
+
+        bool Empty() const
+        {
+            return this->min.x > this->max.x || this->min.y > this->max.y || this->min.z > this->max.z;
+        }
+
+        Vector3<T> Center() const
+        {
+            return (this->min + this->max) / static_cast<T>(2);
+        }
+
+        /// Half the size along each axis.
+        Vector3<T> Extent() const
+        {
+            return (this->max - this->min) / static_cast<T>(2);
+        }
+
+        void Include(const Vector3<T>& point)
+        {
+            this->min = Vector3<T>(std::min(this->min.x, point.x), std::min(this->min.y, point.y), std::min(this->min.z, point.z));
+            this->max = Vector3<T>(std::max(this->max.x, point.x), std::max(this->max.y, point.y), std::max(this->max.z, point.z));
+        }
+
+        void Include(const AABB& box)
+        {
+            this->Include(box.min);
+            this->Include(box.max);
+        }
+
+        /// The box enclosing this one after an affine transform. Each axis of the result spans the absolute values of
+        /// the matrix rows weighted by the extent, which is tight for the transformed corners without visiting them.
+        AABB Transformed(const Matrix4<T>& m) const
+        {
+            const auto& v = m.value;
+            const Vector3<T> c = this->Center();
+            const Vector3<T> e = this->Extent();
+            return AABB::FromCenter(
+                Vector3<T>(
+                    c.x * v[0][0] + c.y * v[1][0] + c.z * v[2][0] + v[3][0],
+                    c.x * v[0][1] + c.y * v[1][1] + c.z * v[2][1] + v[3][1],
+                    c.x * v[0][2] + c.y * v[1][2] + c.z * v[2][2] + v[3][2]),
+                Vector3<T>(
+                    e.x * std::abs(v[0][0]) + e.y * std::abs(v[1][0]) + e.z * std::abs(v[2][0]),
+                    e.x * std::abs(v[0][1]) + e.y * std::abs(v[1][1]) + e.z * std::abs(v[2][1]),
+                    e.x * std::abs(v[0][2]) + e.y * std::abs(v[1][2]) + e.z * std::abs(v[2][2])));
+        }
+    };
+
+    /// A bounding sphere.
+    template<typename T>
+    class Sphere
+    {
+    public:
+        Vector3<T> center;
+        T radius;
+
+        Sphere() : center(), radius(0) {}
+        explicit Sphere(const Vector3<T>& center, T radius) : center(center), radius(radius) {}
+
+        /// The sphere through the corners of a box, which is looser than the box itself.
+        static Sphere From(const AABB<T>& box)
+        {
+            return Sphere(box.Center(), box.Extent().Length());
+        }
+
+        /// The sphere enclosing this one after an affine transform, grown by the largest axis scale.
+        Sphere Transformed(const Matrix4<T>& m) const
+        {
+            T scale = 0;
+            for (int i = 0; i < 3; ++i)
+            {
+                scale = std::max(scale, m.value[i][0] * m.value[i][0] + m.value[i][1] * m.value[i][1] + m.value[i][2] * m.value[i][2]);
+            }
+
+            const Vector3<T>& p = this->center;
+            return Sphere(
+                Vector3<T>(
+                    p.x * m.value[0][0] + p.y * m.value[1][0] + p.z * m.value[2][0] + m.value[3][0],
+                    p.x * m.value[0][1] + p.y * m.value[1][1] + p.z * m.value[2][1] + m.value[3][1],
+                    p.x * m.value[0][2] + p.y * m.value[1][2] + p.z * m.value[2][2] + m.value[3][2]),
+                this->radius * std::sqrt(scale));
+        }
+    };
+
+    /// The six planes bounding what a camera can see, each stored as (normal, distance) with the unit normal pointing
+    /// inward, so that a point is inside when Dot(normal, p) + distance is non-negative for every plane.
+    template<typename T>
+    class Frustum
+    {
+    public:
+        /// Plane indices, not in capitals since windef.h defines NEAR and FAR as macros.
+        enum Side
+        {
+            Left,
+            Right,
+            Bottom,
+            Top,
+            Near,
+            Far,
+            Sides,
+        };
+
+        Vector4<T> planes[Sides];
+
+        Frustum() = default;
+
+        /// Extract the planes from a row-vector view projection, as in Camera, with Direct3D's [0, 1] clip depth.
+        /// Clip coordinates are p * m, so each plane is a combination of the matrix columns.
+        explicit Frustum(const Matrix4<T>& viewProjection)
+        {
+            const auto& m = viewProjection.value;
+            const auto column = [&](int j) { return Vector4<T>(m[0][j], m[1][j], m[2][j], m[3][j]); };
+            const Vector4<T> x = column(0);
+            const Vector4<T> y = column(1);
+            const Vector4<T> z = column(2);
+            const Vector4<T> w = column(3);
+
+            this->planes[Left] = w + x;
+            this->planes[Right] = w - x;
+            this->planes[Bottom] = w + y;
+            this->planes[Top] = w - y;
+            this->planes[Near] = z;
+            this->planes[Far] = w - z;
+            for (Vector4<T>& plane : this->planes)
+            {
+                plane = plane / Vector3<T>(plane.x, plane.y, plane.z).Length();
+            }
+        }
+
+        /// Signed distance from a plane to a point, positive on the inside.
+        T Distance(int side, const Vector3<T>& point) const
+        {
+            const Vector4<T>& plane = this->planes[side];
+            return plane.x * point.x + plane.y * point.y + plane.z * point.z + plane.w;
+        }
+
+        /// Whether any part of the sphere may be visible. Conservative near the frustum's edges and corners, where a
+        /// sphere outside every plane's half-space but one can still be reported visible.
+        bool Intersects(const Sphere<T>& sphere) const
+        {
+            for (int side = 0; side < Sides; ++side)
+            {
+                if (this->Distance(side, sphere.center) < -sphere.radius)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /// Whether any part of the box may be visible, conservative in the same way as for spheres.
+        bool Intersects(const AABB<T>& box) const
+        {
+            const Vector3<T> center = box.Center();
+            const Vector3<T> extent = box.Extent();
+            for (const Vector4<T>& plane : this->planes)
+            {
+                const T reach = extent.x * std::abs(plane.x) + extent.y * std::abs(plane.y) + extent.z * std::abs(plane.z);
+                if (plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -reach)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    using AABBF = AABB<float>;
+    using SphereF = Sphere<float>;
+    using FrustumF = Frustum<float>;
+}
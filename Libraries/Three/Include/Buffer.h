@@ -1,8 +1,11 @@
 #pragma once
 
 #include "Three.h"
+#include "UploadRing.h"
 
 #include <cstdint>
+#include <deque>
+#include <vector>
 
 namespace Dance::Three::Graphics
 {
@@ -90,6 +93,12 @@ namespace Dance::Three::Graphics
             this->deviceContext->Draw(this->count, 0);
         }
 
+        /// Check whether two vertex buffers wrap the same underlying buffer, as copies of one another do.
+        bool operator==(const VertexBuffer& other) const
+        {
+            return this->buffer == other.buffer;
+        }
+
     private:
         /// We have to keep track of the device context in order to set and draw the buffer.
         ComPtr<ID3D11DeviceContext> deviceContext;
@@ -98,11 +107,15 @@ namespace Dance::Three::Graphics
         ComPtr<ID3D11Buffer> buffer;
     };
 
+    /// The DXGI_FORMAT matching an index type, either uint16_t or uint32_t, so that the format follows the type.
+    template<typename T>
+    constexpr DXGI_FORMAT INDEX_FORMAT = sizeof(T) == 4 ? DXGI_FORMAT_R32_UINT : DXGI_FORMAT_R16_UINT;
+
     /// An immutable buffer bound as a D3D11_BIND_INDEX_BUFFER.
     /// 
     /// @typeparam T is the index type.
     /// @typeparam TF is the DXGI_FORMAT of T, which simply indicates the integer type.
-    template<typename T, DXGI_FORMAT TF>
+    template<typename T, DXGI_FORMAT TF = INDEX_FORMAT<T>>
     class IndexBuffer : public Buffer<T>
     {
     public:
@@ -138,6 +151,21 @@ namespace Dance::Three::Graphics
             this->deviceContext->DrawIndexed(this->count, startIndex, baseVertexIndex);
         }
 
+        /// Draw the current vertex buffer once per instance using the indices contained in our buffer.
+        /// 
+        /// @param instanceCount is the number of instances to draw.
+        /// @param startInstance is the first instance read from any per-instance vertex buffers.
+        inline void DrawInstanced(UINT instanceCount, UINT startInstance = 0) const
+        {
+            this->deviceContext->DrawIndexedInstanced(this->count, instanceCount, 0, 0, startInstance);
+        }
+
+        /// Check whether two index buffers wrap the same underlying buffer, as copies of one another do.
+        bool operator==(const IndexBuffer& other) const
+        {
+            return this->buffer == other.buffer;
+        }
+
     private:
         /// We have to keep track of the device context in order to set and draw the buffer.
         ComPtr<ID3D11DeviceContext> deviceContext;
@@ -151,7 +179,7 @@ namespace Dance::Three::Graphics
     /// @typeparam V is the vertex type, as passed to T in VertexBuffer.
     /// @typeparam I is the index type, as passed to T in IndexBuffer.
     /// @typeparam IF is the index format, as passed to TF in IndexBuffer.
-    template<typename V, typename I = uint16_t, DXGI_FORMAT IF = DXGI_FORMAT_R16_UINT>
+    template<typename V, typename I = uint16_t, DXGI_FORMAT IF = INDEX_FORMAT<I>>
     class IndexedVertexBuffer
     {
     public:
@@ -196,6 +224,280 @@ namespace Dance::Three::Graphics
         {
             this->Indices.Draw();
         }
+
+        /// Draw the vertices via the index buffer once per instance.
+        /// 
+        /// @see IndexBuffer::DrawInstanced
+        inline void DrawInstanced(UINT instanceCount, UINT startInstance = 0) const
+        {
+            this->Indices.DrawInstanced(instanceCount, startInstance);
+        }
+
+        /// Check whether both buffers are shared with another indexed vertex buffer.
+        bool operator==(const IndexedVertexBuffer& other) const
+        {
+            return this->Vertices == other.Vertices && this->Indices == other.Indices;
+        }
+    };
+
+    /// A vertex buffer rewritten from the CPU, usually every frame, such as per-instance data. Sets usage to
+    /// D3D11_USAGE_DYNAMIC and binds as D3D11_BIND_VERTEX_BUFFER.
+    /// 
+    /// @typeparam T the underlying vertex type.
+    template<typename T>
+    class MutableVertexBuffer : public Buffer<T>
+    {
+    public:
+        /// Initialize an empty vertex buffer. Does no allocation.
+        MutableVertexBuffer() : Buffer<T>(0), deviceContext(nullptr), buffer(nullptr) {}
+
+        /// Allocate a new vertex buffer using the D3D11 device. Its contents are undefined until the first write.
+        /// 
+        /// @param device expects a ComPtr to a D3D11 device, from which we extract the immediate context for later use.
+        /// @param count is the most vertices the buffer can contain.
+        /// @throws a ComError if ID3D11Device::CreateBuffer returns an invalid result.
+        MutableVertexBuffer(ComPtr<ID3D11Device> device, UINT count) : Buffer<T>(count)
+        {
+            device->GetImmediateContext(this->deviceContext.ReleaseAndGetAddressOf());
+            D3D11_BUFFER_DESC bufferDescriptor{};
+            bufferDescriptor.Usage = D3D11_USAGE_DYNAMIC;
+            bufferDescriptor.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+            bufferDescriptor.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+            bufferDescriptor.ByteWidth = this->Size();
+            OKE(device->CreateBuffer(&bufferDescriptor, nullptr, this->buffer.ReleaseAndGetAddressOf()));
+        }
+
+        /// Replace the start of the buffer, discarding the rest of its previous contents.
+        /// 
+        /// @param data a pointer to the vertices to copy in.
+        /// @param count is the number of vertices to copy, at most Count().
+        /// @throws ComError if ID3D11DeviceContext::Map returns an invalid result.
+        inline void Write(const T* data, UINT count) const
+        {
+            D3D11_MAPPED_SUBRESOURCE mappedSubresource;
+            OKE(this->deviceContext->Map(this->buffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedSubresource));
+            memcpy(mappedSubresource.pData, data, count * sizeof(T));
+            this->deviceContext->Unmap(this->buffer.Get(), 0);
+        }
+
+        /// Set the buffer to one of the device context's vertex buffer slots.
+        /// 
+        /// @param slot is the input slot, which must match the one named in the input layout.
+        inline void Set(UINT slot) const
+        {
+            UINT stride = this->Stride();
+            this->deviceContext->IASetVertexBuffers(slot, 1, this->buffer.GetAddressOf(), &stride, &ZERO);
+        }
+
+    private:
+        /// We have to keep track of the device context in order to set and write the buffer.
+        ComPtr<ID3D11DeviceContext> deviceContext;
+
+        /// Underlying pointer to the buffer.
+        ComPtr<ID3D11Buffer> buffer;
+    };
+
+    /// A typed view of part of a mapped buffer, returned by StreamingBuffer::Append. The buffer stays mapped for as long
+    /// as the span lives and is unmapped when it goes out of scope, which has to happen before drawing from it.
+    /// 
+    /// @typeparam T is the element type.
+    template<typename T>
+    class MappedSpan
+    {
+    public:
+        /// Wrap a range that has already been mapped.
+        /// 
+        /// @param deviceContext is the context the buffer was mapped through.
+        /// @param buffer is the mapped buffer, unmapped on destruction.
+        /// @param data points to the first element of the range.
+        /// @param first is the index of that element within the whole buffer.
+        /// @param count is the number of elements in the range.
+        MappedSpan(ID3D11DeviceContext* deviceContext, ID3D11Buffer* buffer, T* data, UINT first, UINT count)
+            : deviceContext(deviceContext)
+            , buffer(buffer)
+            , data(data)
+            , first(first)
+            , count(count)
+        {}
+
+        MappedSpan(const MappedSpan&) = delete;
+        MappedSpan& operator=(const MappedSpan&) = delete;
+
+        MappedSpan(MappedSpan&& other) noexcept
+            : deviceContext(other.deviceContext)
+            , buffer(other.buffer)
+            , data(other.data)
+            , first(other.first)
+            , count(other.count)
+        {
+            other.buffer = nullptr;
+        }
+
+        ~MappedSpan()
+        {
+            if (this->buffer != nullptr)
+            {
+                this->deviceContext->Unmap(this->buffer, 0);
+            }
+        }
+
+        /// Get the index of the span's first element within the whole buffer, which is what draws start from.
+        UINT First() const
+        {
+            return this->first;
+        }
+
+        /// Get the number of elements in the span.
+        UINT Count() const
+        {
+            return this->count;
+        }
+
+        T& operator[](UINT index)
+        {
+            return this->data[index];
+        }
+
+        T* begin()
+        {
+            return this->data;
+        }
+
+        T* end()
+        {
+            return this->data + this->count;
+        }
+
+    private:
+        ID3D11DeviceContext* deviceContext;
+        ID3D11Buffer* buffer;
+        T* data;
+        UINT first;
+        UINT count;
+    };
+
+    /// A dynamic buffer for geometry generated every frame. Appends are handed out front to back with
+    /// D3D11_MAP_WRITE_NO_OVERWRITE, so ranges the GPU may still be reading are left alone, and once the end is reached
+    /// the buffer is mapped with D3D11_MAP_WRITE_DISCARD and filled from the start again. Nothing is allocated after
+    /// construction.
+    /// 
+    /// @typeparam T is the element type.
+    /// @typeparam B is the D3D11_BIND_FLAG the buffer is created with.
+    template<typename T, UINT B>
+    class StreamingBuffer : public Buffer<T>
+    {
+    public:
+        /// Initialize an empty streaming buffer. Does no allocation.
+        StreamingBuffer() : Buffer<T>(0), deviceContext(nullptr), buffer(nullptr), cursor(0) {}
+
+        /// Allocate a new streaming buffer using the D3D11 device. Its contents are undefined until appended to.
+        /// 
+        /// @param device expects a ComPtr to a D3D11 device, from which we extract the immediate context for later use.
+        /// @param count is the most elements the buffer can hold, which should cover a few frames' worth.
+        /// @throws a ComError if ID3D11Device::CreateBuffer returns an invalid result.
+        StreamingBuffer(ComPtr<ID3D11Device> device, UINT count) : Buffer<T>(count), cursor(count)
+        {
+            device->GetImmediateContext(this->deviceContext.ReleaseAndGetAddressOf());
+            D3D11_BUFFER_DESC bufferDescriptor{};
+            bufferDescriptor.Usage = D3D11_USAGE_DYNAMIC;
+            bufferDescriptor.BindFlags = B;
+            bufferDescriptor.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+            bufferDescriptor.ByteWidth = this->Size();
+            OKE(device->CreateBuffer(&bufferDescriptor, nullptr, this->buffer.ReleaseAndGetAddressOf()));
+        }
+
+        /// Map the next count elements for writing. The cursor starts at the end, so the first append discards.
+        /// 
+        /// @param count is the number of elements to write, at most Count().
+        /// @returns a span over the mapped elements, which must be destroyed before drawing them.
+        /// @throws ComError if count exceeds the buffer or ID3D11DeviceContext::Map returns an invalid result.
+        MappedSpan<T> Append(UINT count)
+        {
+            if (count > this->count)
+            {
+                throw ComError(E_INVALIDARG, "append larger than the streaming buffer");
+            }
+
+            D3D11_MAP map = D3D11_MAP_WRITE_NO_OVERWRITE;
+            if (this->cursor + count > this->count)
+            {
+                map = D3D11_MAP_WRITE_DISCARD;
+                this->cursor = 0;
+            }
+
+            D3D11_MAPPED_SUBRESOURCE mappedSubresource;
+            OKE(this->deviceContext->Map(this->buffer.Get(), 0, map, 0, &mappedSubresource));
+            const UINT first = this->cursor;
+            this->cursor += count;
+            T* data = static_cast<T*>(mappedSubresource.pData) + first;
+            return MappedSpan<T>(this->deviceContext.Get(), this->buffer.Get(), data, first, count);
+        }
+
+    protected:
+        /// We have to keep track of the device context in order to map, set and draw the buffer.
+        ComPtr<ID3D11DeviceContext> deviceContext;
+
+        /// Underlying pointer to the buffer.
+        ComPtr<ID3D11Buffer> buffer;
+
+        /// Index of the first element not yet handed out since the last discard.
+        UINT cursor;
+    };
+
+    /// A streaming buffer bound as a D3D11_BIND_VERTEX_BUFFER, for waveforms, ribbons and other per-frame geometry.
+    /// 
+    /// @typeparam T the underlying vertex type.
+    template<typename T>
+    class StreamingVertexBuffer : public StreamingBuffer<T, D3D11_BIND_VERTEX_BUFFER>
+    {
+    public:
+        using StreamingBuffer<T, D3D11_BIND_VERTEX_BUFFER>::StreamingBuffer;
+
+        /// Set the buffer to one of the device context's vertex buffer slots.
+        /// 
+        /// @param slot is the input slot, which must match the one named in the input layout.
+        inline void Set(UINT slot = 0) const
+        {
+            UINT stride = this->Stride();
+            this->deviceContext->IASetVertexBuffers(slot, 1, this->buffer.GetAddressOf(), &stride, &ZERO);
+        }
+
+        /// Draw vertices appended earlier without an index buffer.
+        /// 
+        /// @param count is the number of vertices to draw.
+        /// @param first is the index of the first one, usually MappedSpan::First.
+        inline void Draw(UINT count, UINT first) const
+        {
+            this->deviceContext->Draw(count, first);
+        }
+    };
+
+    /// A streaming buffer bound as a D3D11_BIND_INDEX_BUFFER.
+    /// 
+    /// @typeparam T is the index type.
+    /// @typeparam TF is the DXGI_FORMAT of T, which simply indicates the integer type.
+    template<typename T = uint16_t, DXGI_FORMAT TF = INDEX_FORMAT<T>>
+    class StreamingIndexBuffer : public StreamingBuffer<T, D3D11_BIND_INDEX_BUFFER>
+    {
+    public:
+        using StreamingBuffer<T, D3D11_BIND_INDEX_BUFFER>::StreamingBuffer;
+
+        /// Set the device context's active index buffer.
+        inline void Set() const
+        {
+            this->deviceContext->IASetIndexBuffer(this->buffer.Get(), TF, 0);
+        }
+
+        /// Draw indices appended earlier from whichever vertex buffer is set.
+        /// 
+        /// @param count is the number of indices to draw.
+        /// @param first is the index of the first one, usually MappedSpan::First.
+        /// @param baseVertex is added to every index, usually the MappedSpan::First of the matching vertices so that
+        /// the indices can be written relative to them.
+        inline void Draw(UINT count, UINT first, INT baseVertex) const
+        {
+            this->deviceContext->DrawIndexed(count, first, baseVertex);
+        }
     };
 
     /// A managed, immutable buffer bound as a D3D11_BIND_CONSTANT_BUFFER. The constant in its name does not refer to its
@@ -291,18 +593,30 @@ namespace Dance::Three::Graphics
         }
     };
 
+    /// Running totals of writes through every ManagedMutableConstantBuffer.
+    struct ConstantStatistics
+    {
+        /// Writes that mapped the buffer and uploaded new data.
+        uint64_t Uploaded;
+
+        /// Writes skipped because the data hadn't changed since the last upload.
+        uint64_t Skipped;
+    };
+
+    /// Totals for this module, so each plugin counts its own.
+    inline ConstantStatistics ConstantUploads{};
+
     /// A constant buffer for a single T with a local instance provided within the class itself. Count is implicitly one.
+    /// Changes go through Modify, which bumps a generation counter, and Write only maps and uploads the data when the
+    /// generation has moved on since the last upload.
     /// 
     /// @typeparam T is the type/format of the buffer's contents.
     template<typename T>
     class ManagedMutableConstantBuffer : public MutableConstantBuffer<T>
     {
     public:
-        /// The data source we're writing from.
-        T Data;
-
         /// Initialize an empty constant buffer. Makes no allocations.
-        ManagedMutableConstantBuffer() : MutableConstantBuffer<T>() {}
+        ManagedMutableConstantBuffer() : MutableConstantBuffer<T>(), data(), generation(0), uploaded(0) {}
 
         /// Allocatae the constant buffer using the D3D11 device and write the default-constructed data into it.
         /// 
@@ -310,24 +624,324 @@ namespace Dance::Three::Graphics
         /// @throws ComError if ID3D11Device::CreateBuffer returns an invalid result.
         /// @see MutableConstantBuffer::MutableConstantBuffer
         ManagedMutableConstantBuffer(ComPtr<ID3D11Device> device)
-            : MutableConstantBuffer<T>(device, 1, &this->Data)
+            : ManagedMutableConstantBuffer(device, T())
         {}
 
         /// Allocatae the constant buffer using the D3D11 device and copy-construct data before writing it.
         /// 
         /// @param device expects a ComPtr to a D3D11 device, from which we extract the immediate context for later use.
-        /// @param data a pointer to the data to write to the buffer, required as it is immutable.
+        /// @param data is the initial contents of the buffer, which starts out clean.
         /// @throws ComError if ID3D11Device::CreateBuffer returns an invalid result.
         /// @see MutableConstantBuffer::MutableConstantBuffer
         ManagedMutableConstantBuffer(ComPtr<ID3D11Device> device, T data)
-            : Data(data)
-            , MutableConstantBuffer<T>(device, 1, &this->Data)
+            : MutableConstantBuffer<T>(device, 1, &data)
+            , data(data)
+            , generation(0)
+            , uploaded(0)
+        {}
+
+        /// Get read-only access to the data, which leaves it clean.
+        /// 
+        /// @returns a const reference to our copy of the buffer contents.
+        const T& Data() const
+        {
+            return this->data;
+        }
+
+        /// Get mutable access to the data, marking it to be uploaded on the next write.
+        /// 
+        /// @returns a reference to our copy of the buffer contents.
+        T& Modify()
+        {
+            this->generation += 1;
+            return this->data;
+        }
+
+        /// Get the number of times the data has been handed out for modification.
+        uint64_t Generation() const
+        {
+            return this->generation;
+        }
+
+        /// Check whether the data may have changed since it was last uploaded.
+        bool Dirty() const
+        {
+            return this->uploaded != this->generation;
+        }
+
+        /// Overwrite MutableConstantBuffer::Write because we're always gonna write our this->data, and only if it's dirty.
+        /// 
+        /// @returns true if the data was uploaded, false if the upload was skipped.
+        /// @throws ComError if ID3D11DeviceContext::Map returns an invalid result.
+        inline bool Write()
+        {
+            if (!this->Dirty())
+            {
+                ConstantUploads.Skipped += 1;
+                return false;
+            }
+
+            MutableConstantBuffer<T>::Write(&this->data);
+            this->uploaded = this->generation;
+            ConstantUploads.Uploaded += 1;
+            return true;
+        }
+
+    private:
+        /// The data source we're writing from.
+        T data;
+
+        /// Bumped every time the data is handed out by Modify.
+        uint64_t generation;
+
+        /// The generation last uploaded. Creating the buffer uploads the initial data, so both start at zero.
+        uint64_t uploaded;
+    };
+
+    /// One large constant buffer shared by everything drawn in a frame, in place of a MutableConstantBuffer and its
+    /// D3D11_MAP_WRITE_DISCARD per object. Each write takes a fresh 256-byte aligned range of the buffer through
+    /// D3D11_MAP_WRITE_NO_OVERWRITE, so the driver never has to rename it, and ranges are only handed out again once an
+    /// event query shows the GPU has finished the frame that wrote them. Requires the Direct3D 11.1 features checked by
+    /// Supported.
+    ///
+    /// The buffer is mapped by the first write and stays mapped through the writes after it, so a frame that writes
+    /// all of its constants before binding any of them maps once. The GPU can't read a mapped buffer, so binding or
+    /// finishing the frame unmaps it, and interleaving writes with draws costs a map per draw as before.
+    class FrameConstantBuffer
+    {
+    public:
+        /// The range of the buffer holding one write, counted in the 16-byte constants *SetConstantBuffers1 expects.
+        struct Slice
+        {
+            UINT First;
+            UINT Count;
+        };
+
+        /// Initialize an empty frame buffer. Makes no allocations.
+        FrameConstantBuffer()
+            : device(nullptr)
+            , deviceContext(nullptr)
+            , buffer(nullptr)
+            , ring()
+            , queries()
+            , spare()
+            , frame(0)
+            , discarded(false)
+            , mapped(nullptr)
         {}
 
-        /// Overwrite MutableConstantBuffer::Write because we're always gonna write our this->Data.
-        inline void Write() const
+        /// Check whether a device supports the optional Direct3D 11.1 features the buffer relies on: binding constant
+        /// buffer offsets and mapping dynamic constant buffers with D3D11_MAP_WRITE_NO_OVERWRITE. Where it doesn't,
+        /// fall back to a MutableConstantBuffer per object.
+        /// 
+        /// @param device is the device to check.
+        /// @returns whether a FrameConstantBuffer can be created on the device.
+        static bool Supported(ID3D11Device* device)
+        {
+            D3D11_FEATURE_DATA_D3D11_OPTIONS options{};
+            return SUCCEEDED(device->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options)))
+                && options.ConstantBufferOffsetting
+                && options.MapNoOverwriteOnDynamicConstantBuffer;
+        }
+
+        /// Allocate the shared buffer using a D3D11 device.
+        /// 
+        /// The buffer is sized to hold a frame's constants for every frame the GPU may be behind by, so that Write
+        /// doesn't wait in steady state. Only a frame writing more than it was sized for has to.
+        /// 
+        /// @param device expects a ComPtr to a D3D11 device, from which we extract the immediate context for later use.
+        /// @param frameBytes is the most constant data one frame writes, counting each write rounded up to 256 bytes.
+        /// @throws ComError if the device isn't Supported, the context isn't Direct3D 11.1, or
+        /// ID3D11Device::CreateBuffer returns an invalid result.
+        FrameConstantBuffer(ComPtr<ID3D11Device> device, UINT frameBytes)
+            : device(device)
+            , deviceContext(nullptr)
+            , buffer(nullptr)
+            , ring(FrameConstantBuffer::Capacity(device.Get(), frameBytes))
+            , queries()
+            , spare()
+            , frame(0)
+            , discarded(false)
+            , mapped(nullptr)
+        {
+            if (!FrameConstantBuffer::Supported(device.Get()))
+            {
+                throw ComError(DXGI_ERROR_UNSUPPORTED, "device can't bind constant buffer offsets or map them without overwriting");
+            }
+
+            ComPtr<ID3D11DeviceContext> deviceContext;
+            device->GetImmediateContext(deviceContext.ReleaseAndGetAddressOf());
+            OKE(deviceContext.As(&this->deviceContext));
+
+            D3D11_BUFFER_DESC bufferDescriptor{};
+            bufferDescriptor.Usage = D3D11_USAGE_DYNAMIC;
+            bufferDescriptor.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+            bufferDescriptor.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+            bufferDescriptor.ByteWidth = static_cast<UINT>(this->ring.Capacity());
+            OKE(device->CreateBuffer(&bufferDescriptor, nullptr, this->buffer.ReleaseAndGetAddressOf()));
+        }
+
+        /// Copy data into a fresh range of the buffer, mapping it unless it's still mapped from the previous write.
+        /// Waits for the GPU to finish older frames if the buffer is full, which only happens if the frame writes more
+        /// than the buffer was sized for.
+        /// 
+        /// @param data is the constant data to write.
+        /// @returns the range written, to pass to Set.
+        /// @throws ComError if the data is larger than the whole buffer or ID3D11DeviceContext::Map fails.
+        template<typename T>
+        Slice Write(const T& data)
+        {
+            static_assert(sizeof(T) % 16 == 0, "constant buffer contents must be a whole number of 16-byte constants");
+
+            UploadRing::Allocation allocation;
+            while (!this->ring.Allocate(sizeof(T), allocation))
+            {
+                if (this->ring.InFlight() == 0)
+                {
+                    throw ComError(E_OUTOFMEMORY, "constants larger than the frame constant buffer");
+                }
+                this->Wait();
+            }
+
+            // The first map has to discard so that later ones are allowed not to overwrite
+            if (this->mapped == nullptr)
+            {
+                D3D11_MAPPED_SUBRESOURCE mappedSubresource;
+                const D3D11_MAP map = this->discarded ? D3D11_MAP_WRITE_NO_OVERWRITE : D3D11_MAP_WRITE_DISCARD;
+                OKE(this->deviceContext->Map(this->buffer.Get(), 0, map, 0, &mappedSubresource));
+                this->mapped = static_cast<uint8_t*>(mappedSubresource.pData);
+                this->discarded = true;
+            }
+
+            memcpy(this->mapped + allocation.Offset, &data, sizeof(T));
+
+            return Slice{ static_cast<UINT>(allocation.Offset / 16), static_cast<UINT>(allocation.Size / 16) };
+        }
+
+        /// Bind a written range to one of the constant buffer indices for both the vertex and pixel shaders, unmapping
+        /// the buffer first if a write left it mapped.
+        /// 
+        /// @param index is the index we set the buffer to.
+        /// @param slice is the range returned by Write this frame.
+        inline void Set(UINT index, const Slice& slice)
+        {
+            this->Unmap();
+            this->deviceContext->VSSetConstantBuffers1(index, 1, this->buffer.GetAddressOf(), &slice.First, &slice.Count);
+            this->deviceContext->PSSetConstantBuffers1(index, 1, this->buffer.GetAddressOf(), &slice.First, &slice.Count);
+        }
+
+        /// Close the frame after its last draw, fencing what it wrote, and reclaim frames the GPU has since finished.
+        /// 
+        /// @throws ComError if the event query can't be created.
+        void Finish()
+        {
+            this->Unmap();
+
+            ComPtr<ID3D11Query> query;
+            if (this->spare.empty())
+            {
+                D3D11_QUERY_DESC queryDescriptor{ D3D11_QUERY_EVENT, 0 };
+                OKE(this->device->CreateQuery(&queryDescriptor, query.ReleaseAndGetAddressOf()));
+            }
+            else
+            {
+                query = std::move(this->spare.back());
+                this->spare.pop_back();
+            }
+
+            this->deviceContext->End(query.Get());
+            this->ring.Finish(++this->frame);
+            this->queries.push_back(std::move(query));
+
+            while (!this->queries.empty()
+                && this->deviceContext->GetData(this->queries.front().Get(), nullptr, 0, D3D11_ASYNC_GETDATA_DONOTFLUSH) == S_OK)
+            {
+                this->Retire();
+            }
+        }
+
+    private:
+        /// Needed to create event queries as frames are finished.
+        ComPtr<ID3D11Device> device;
+
+        /// The 11.1 context, which can bind constant buffer offsets.
+        ComPtr<ID3D11DeviceContext1> deviceContext;
+
+        /// Underlying pointer to the buffer.
+        ComPtr<ID3D11Buffer> buffer;
+
+        /// Tracks which ranges of the buffer are free.
+        UploadRing ring;
+
+        /// Event queries for finished frames the GPU may still be reading, oldest first, one per ring frame.
+        std::deque<ComPtr<ID3D11Query>> queries;
+
+        /// Queries from retired frames, kept for reuse.
+        std::vector<ComPtr<ID3D11Query>> spare;
+
+        /// Fence value of the last finished frame.
+        uint64_t frame;
+
+        /// Whether the buffer has been mapped with D3D11_MAP_WRITE_DISCARD yet.
+        bool discarded;
+
+        /// Where the buffer is mapped while writes are batched up, otherwise null.
+        uint8_t* mapped;
+
+        /// Hand the buffer back to the GPU if it's mapped.
+        void Unmap()
+        {
+            if (this->mapped != nullptr)
+            {
+                this->deviceContext->Unmap(this->buffer.Get(), 0);
+                this->mapped = nullptr;
+            }
+        }
+
+        /// Release the oldest finished frame's ranges.
+        void Retire()
+        {
+            this->ring.Retire(this->ring.Oldest());
+            this->spare.push_back(std::move(this->queries.front()));
+            this->queries.pop_front();
+        }
+
+        /// Bytes that hold a frame's constants for every frame the swap chain lets the GPU fall behind by, plus the frame
+        /// being written and the most that wrapping around can skip.
+        static size_t Capacity(ID3D11Device* device, UINT frameBytes)
+        {
+            UINT latency = 0;
+            ComPtr<IDXGIDevice1> dxgiDevice;
+            if (SUCCEEDED(device->QueryInterface(IID_PPV_ARGS(dxgiDevice.GetAddressOf()))))
+            {
+                dxgiDevice->GetMaximumFrameLatency(&latency);
+            }
+
+            // Zero means the default of three
+            latency = latency != 0 ? latency : 3;
+            const size_t frame = (static_cast<size_t>(frameBytes) + UploadRing::ALIGNMENT - 1) & ~(UploadRing::ALIGNMENT - 1);
+            return frame * (latency + 2);
+        }
+
+        /// Block until the GPU finishes the oldest frame still in flight, then release it. Polls give up the rest of
+        /// the time slice at first and then sleep, rather than spinning a core that the governor would count as work.
+        void Wait()
         {
-            MutableConstantBuffer<T>::Write(&this->Data);
+            ID3D11Query* query = this->queries.front().Get();
+            HRESULT status;
+            for (UINT polls = 0; (status = this->deviceContext->GetData(query, nullptr, 0, 0)) == S_FALSE; ++polls)
+            {
+                if (polls < 16)
+                {
+                    ::SwitchToThread();
+                }
+                else
+                {
+                    ::Sleep(1);
+                }
+            }
+            OKE(status);
+            this->Retire();
         }
     };
 }
@@ -10,8 +10,9 @@ namespace Dance::Three::Graphics
 	class Camera
 	{
 	public:
-		/// Transforms world coordinates relative to the camera.
-		Matrix4F WorldToCamera;
+		/// Transforms world coordinates relative to the camera. Tagged so that finding the camera position only takes
+		/// the rigid or affine inverse when the transform allows it.
+		Math::TaggedMatrix4F WorldToCamera;
 
 		/// Projection matrix for the camera.
 		Matrix4F Projection;
@@ -25,7 +26,7 @@ namespace Dance::Three::Graphics
 		};
 
 		/// Empty initialize a camera without making allocation.
-		Camera() : constants() {}
+		Camera() : constants(), computedWorldToCamera(), computedProjection(), computed(false) {}
 
 		/// Initialize a camera for a D3D11 device since we need a constant buffer. Takes an initial transform and projection.
 		/// 
@@ -33,27 +34,74 @@ namespace Dance::Three::Graphics
 		/// @param worldToCamera should be a matrix that transforms world coordinates to be relative to the camera.
 		/// @param projection is the initial camera projection.
 		/// @throws ComError if constant buffer allocation fails.
-		Camera(ComPtr<ID3D11Device> device, Matrix4F worldToCamera, Matrix4F projection)
+		Camera(ComPtr<ID3D11Device> device, Math::TaggedMatrix4F worldToCamera, Matrix4F projection)
 			: WorldToCamera(worldToCamera)
 			, Projection(projection)
 			, constants(device)
+			, computedWorldToCamera()
+			, computedProjection()
+			, computed(false)
 		{}
 
-		/// Recompute the view projection and position. Set the constant buffer to the CONSTANT_BUFFER_CAMERA slot.
+		/// Recompute the view projection and position if the transform or projection changed since the last activation.
+		/// Set the constant buffer to the CONSTANT_BUFFER_CAMERA slot, uploading the constants only if they changed.
 		/// 
 		/// @param index is the index we set the buffer to.
-		/// @todo move out recalculation logic since it's needlessly expensive if the camera is static. Also need to 
-		/// refactor the slot system.
+		/// @todo refactor the slot system.
 		void Activate(UINT index)
 		{
-			this->constants.Data.ViewProjection = this->WorldToCamera * this->Projection;
-			this->constants.Data.Position = this->WorldToCamera.Inverted().Translation();
+			this->Update();
 			this->constants.Set(index);
 			this->constants.Write();
 		}
 
+		/// Same as Activate, but writing the constants into the frame's shared buffer instead of our own. The shared
+		/// buffer is rewritten every frame, so only the recomputation can be skipped.
+		/// 
+		/// @param index is the index we set the written range to.
+		/// @param uploads is the shared buffer for the current frame.
+		void Activate(UINT index, FrameConstantBuffer& uploads)
+		{
+			this->Update();
+			uploads.Set(index, uploads.Write(this->constants.Data()));
+		}
+
+		/// Get the planes bounding what the camera currently sees, for culling renderables before drawing them.
+		/// 
+		/// @returns the frustum of the current transform and projection, which need not have been activated yet.
+		Math::FrustumF Frustum() const
+		{
+			return Math::FrustumF(this->WorldToCamera * this->Projection);
+		}
+
 	protected:
 		/// The mutable buffer we'll write our camera constants into.
 		ManagedMutableConstantBuffer<Constants> constants;
+
+		/// The transform and projection the constants were last computed from.
+		Matrix4F computedWorldToCamera;
+		Matrix4F computedProjection;
+
+		/// Whether the constants have been computed at all yet.
+		bool computed;
+
+		/// Recompute the constants, unless the transform and projection are bit for bit what they were last time.
+		void Update()
+		{
+			const Matrix4F& worldToCamera = this->WorldToCamera;
+			if (this->computed
+				&& memcmp(&worldToCamera, &this->computedWorldToCamera, sizeof(Matrix4F)) == 0
+				&& memcmp(&this->Projection, &this->computedProjection, sizeof(Matrix4F)) == 0)
+			{
+				return;
+			}
+
+			Constants& data = this->constants.Modify();
+			data.ViewProjection = this->WorldToCamera * this->Projection;
+			data.Position = this->WorldToCamera.Inverted().Translation();
+			this->computedWorldToCamera = worldToCamera;
+			this->computedProjection = this->Projection;
+			this->computed = true;
+		}
 	};
 }
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace Dance::Three::Graphics
+{
+    /// One draw recorded for later submission. The state it needs is named by small integer ids rather than pointers,
+    /// so that a backend decides what they refer to and the ordering can be checked without a device.
+    struct DrawPacket
+    {
+        /// Sort key, usually from SortKey::Make. Packets are drawn in ascending key order.
+        uint64_t Key;
+
+        /// Id of the shader and input layout to bind.
+        uint32_t Shader;
+
+        /// Id of the vertex and index buffers to bind.
+        uint32_t Mesh;
+
+        /// Id of whatever the backend draws, such as a renderable and its constants.
+        uint32_t Object;
+    };
+
+    namespace SortKey
+    {
+        /// Map a float onto an unsigned integer with the same ordering, negatives included.
+        inline uint32_t Depth(float depth)
+        {
+            uint32_t bits;
+            std::memcpy(&bits, &depth, sizeof(bits));
+            return bits & 0x80000000u ? ~bits : bits | 0x80000000u;
+        }
+
+        /// Build a key that groups packets by shader, then by mesh within a shader, then orders them front to back.
+        /// Binding a shader is the costliest change, so it takes the highest bits.
+        ///
+        /// @param shader is the shader id, of which the low 16 bits are kept.
+        /// @param mesh is the mesh id, of which the low 16 bits are kept.
+        /// @param depth is the distance from the camera.
+        inline uint64_t Make(uint32_t shader, uint32_t mesh, float depth)
+        {
+            return static_cast<uint64_t>(shader & 0xFFFF) << 48
+                | static_cast<uint64_t>(mesh & 0xFFFF) << 32
+                | Depth(depth);
+        }
+    }
+
+    /// Draw packets collected over a frame, sorted by key and then submitted so that a shader or mesh is only bound
+    /// when it differs from the previous packet's. A backend provides:
+    ///
+    ///     void BindShader(uint32_t shader);
+    ///     void BindMesh(uint32_t mesh);
+    ///     void Draw(const DrawPacket& packet);
+    ///
+    /// Nothing is assumed to be bound before submission, so the first packet always binds both.
+    class CommandBuffer
+    {
+    public:
+        /// What a submission did, for checking how much sorting saved.
+        struct Statistics
+        {
+            /// Packets drawn.
+            uint64_t Draws;
+
+            /// Shaders and meshes actually bound.
+            uint64_t ShaderBinds;
+            uint64_t MeshBinds;
+
+            /// Binds skipped because the state was already current.
+            uint64_t Elided;
+        };
+
+        /// Get the number of packets recorded since the last clear.
+        size_t Size() const
+        {
+            return this->packets.size();
+        }
+
+        /// Allocate room for count packets up front so that recording doesn't reallocate.
+        void Reserve(size_t count)
+        {
+            this->packets.reserve(count);
+            this->scratch.reserve(count);
+        }
+
+        /// Remove every packet, keeping the allocation for the next frame.
+        void Clear()
+        {
+            this->packets.clear();
+        }
+
+        /// Record a draw.
+        void Add(const DrawPacket& packet)
+        {
+            this->packets.push_back(packet);
+        }
+
+        /// Get the packets in their current order, which is key order after Sort.
+        const std::vector<DrawPacket>& Packets() const
+        {
+            return this->packets;
+        }
+
+        /// Order the packets by key with a least significant digit radix sort, a byte at a time. Stable, so packets
+        /// with equal keys keep the order they were added in. Bytes that are the same in every key, such as the shader
+        /// bits when there's only one shader, are skipped.
+        void Sort()
+        {
+            const size_t count = this->packets.size();
+            this->scratch.resize(count);
+
+            for (int shift = 0; shift < 64; shift += 8)
+            {
+                size_t offsets[256] = {};
+                for (const DrawPacket& packet : this->packets)
+                {
+                    offsets[(packet.Key >> shift) & 0xFF] += 1;
+                }
+
+                if (count == 0 || offsets[(this->packets[0].Key >> shift) & 0xFF] == count)
+                {
+                    continue;
+                }
+
+                size_t total = 0;
+                for (size_t& offset : offsets)
+                {
+                    const size_t bucket = offset;
+                    offset = total;
+                    total += bucket;
+                }
+
+                for (const DrawPacket& packet : this->packets)
+                {
+                    this->scratch[offsets[(packet.Key >> shift) & 0xFF]++] = packet;
+                }
+                this->packets.swap(this->scratch);
+            }
+        }
+
+        /// Hand every packet to the backend in order, binding state only where it changes.
+        ///
+        /// @param backend receives the binds and draws.
+        /// @returns what was bound, drawn, and skipped.
+        template<typename B>
+        Statistics Submit(B& backend) const
+        {
+            Statistics statistics{};
+            const DrawPacket* previous = nullptr;
+            for (const DrawPacket& packet : this->packets)
+            {
+                if (previous == nullptr || packet.Shader != previous->Shader)
+                {
+                    backend.BindShader(packet.Shader);
+                    statistics.ShaderBinds += 1;
+                }
+                else
+                {
+                    statistics.Elided += 1;
+                }
+
+                if (previous == nullptr || packet.Mesh != previous->Mesh)
+                {
+                    backend.BindMesh(packet.Mesh);
+                    statistics.MeshBinds += 1;
+                }
+                else
+                {
+                    statistics.Elided += 1;
+                }
+
+                backend.Draw(packet);
+                statistics.Draws += 1;
+                previous = &packet;
+            }
+            return statistics;
+        }
+
+    private:
+        /// Recorded packets, in the order added until sorted.
+        std::vector<DrawPacket> packets;
+
+        /// The other half of each radix pass, kept between frames to avoid reallocating.
+        std::vector<DrawPacket> scratch;
+    };
+}
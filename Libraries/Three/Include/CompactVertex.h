@@ -0,0 +1,219 @@
+#pragma once
+
+#include "Three.h"
+#include "Primitive.h"
+#include "Packing.h"
+#include "Vector2.h"
+
+#include <array>
+#include <cstring>
+#include <type_traits>
+
+namespace Dance::Three::Graphics
+{
+    /// Vertex attributes for PackedVertex. Each one describes a single input element: its semantic, the DXGI format
+    /// and matching storage, and how to convert between the storage and the values the rest of the code works with.
+    namespace Attribute
+    {
+        /// Position as three half floats. There's no three-component half format, so a fourth carrying one pads it.
+        /// Halves keep about three significant digits, which suits meshes built around the origin and scaled by
+        /// their transform, like the ones in Geometry.h.
+        struct HalfPosition
+        {
+            using Value = Vector3F;
+            using Storage = std::array<uint16_t, 4>;
+            static constexpr const char* SEMANTIC = "POSITION";
+            static constexpr UINT INDEX = 0;
+            static constexpr DXGI_FORMAT FORMAT = DXGI_FORMAT_R16G16B16A16_FLOAT;
+
+            static Storage Encode(const Value& value)
+            {
+                return { Math::ToHalf(value.x), Math::ToHalf(value.y), Math::ToHalf(value.z), Math::ToHalf(1.0f) };
+            }
+
+            static Value Decode(const Storage& storage)
+            {
+                return Value(Math::FromHalf(storage[0]), Math::FromHalf(storage[1]), Math::FromHalf(storage[2]));
+            }
+        };
+
+        /// Position at full precision, for meshes that don't sit near the origin.
+        struct FloatPosition
+        {
+            using Value = Vector3F;
+            using Storage = Vector3F;
+            static constexpr const char* SEMANTIC = "POSITION";
+            static constexpr UINT INDEX = 0;
+            static constexpr DXGI_FORMAT FORMAT = DXGI_FORMAT_R32G32B32_FLOAT;
+
+            static Storage Encode(const Value& value)
+            {
+                return value;
+            }
+
+            static Value Decode(const Storage& storage)
+            {
+                return storage;
+            }
+        };
+
+        /// Unit normal folded onto an octahedron as two 16-bit signed normalized coordinates.
+        ///
+        /// @see Math::ToOctahedral
+        struct OctahedralNormal
+        {
+            using Value = Vector3F;
+            using Storage = uint32_t;
+            static constexpr const char* SEMANTIC = "NORMAL";
+            static constexpr UINT INDEX = 0;
+            static constexpr DXGI_FORMAT FORMAT = DXGI_FORMAT_R16G16_SNORM;
+
+            static Storage Encode(const Value& value)
+            {
+                return Math::ToOctahedral(value);
+            }
+
+            static Value Decode(const Storage& storage)
+            {
+                return Math::FromOctahedral(storage);
+            }
+        };
+
+        /// Color as a byte per channel.
+        struct UnormColor
+        {
+            using Value = Color4F;
+            using Storage = uint32_t;
+            static constexpr const char* SEMANTIC = "COLOR";
+            static constexpr UINT INDEX = 0;
+            static constexpr DXGI_FORMAT FORMAT = DXGI_FORMAT_R8G8B8A8_UNORM;
+
+            static Storage Encode(const Value& value)
+            {
+                return Math::ToUnorm8(Math::Vector4<float>(value.r, value.g, value.b, value.a));
+            }
+
+            static Value Decode(const Storage& storage)
+            {
+                const Math::Vector4<float> channels = Math::FromUnorm8(storage);
+                return Value(channels.x, channels.y, channels.z, channels.w);
+            }
+        };
+
+        /// Texture coordinates as two half floats, exact to a texel on textures up to 2048 wide.
+        struct HalfUV
+        {
+            using Value = Math::Vector2<float>;
+            using Storage = std::array<uint16_t, 2>;
+            static constexpr const char* SEMANTIC = "TEXCOORD";
+            static constexpr UINT INDEX = 0;
+            static constexpr DXGI_FORMAT FORMAT = DXGI_FORMAT_R16G16_FLOAT;
+
+            static Storage Encode(const Value& value)
+            {
+                return { Math::ToHalf(value.x), Math::ToHalf(value.y) };
+            }
+
+            static Value Decode(const Storage& storage)
+            {
+                return Value(Math::FromHalf(storage[0]), Math::FromHalf(storage[1]));
+            }
+        };
+    }
+
+    /// A vertex laid out from a list of attributes, packed back to back in the order given. The input layout is derived
+    /// from the same list, so the struct and the layout the shader is created with can't drift apart. Attributes are
+    /// read and written through Get and Set, which encode and decode.
+    ///
+    /// @typeparam A are the attributes, each appearing at most once. Keep four-byte storage ahead of two-byte storage
+    /// so every element stays aligned.
+    template<typename... A>
+    class PackedVertex
+    {
+    public:
+        /// Bytes per vertex.
+        static constexpr UINT SIZE = (static_cast<UINT>(sizeof(typename A::Storage)) + ...);
+
+        /// Whether T is one of the attributes.
+        template<typename T>
+        static constexpr bool Has = (std::is_same_v<T, A> || ...);
+
+        /// Byte offset of attribute T within the vertex.
+        template<typename T>
+        static constexpr UINT Offset()
+        {
+            static_assert(Has<T>, "attribute is not part of this vertex");
+            constexpr bool matches[] = { std::is_same_v<T, A>... };
+            constexpr UINT sizes[] = { static_cast<UINT>(sizeof(typename A::Storage))... };
+            UINT offset = 0;
+            for (size_t i = 0; !matches[i]; ++i)
+            {
+                offset += sizes[i];
+            }
+            return offset;
+        }
+
+        /// Corresponding DirectX mapping for translation to shader data.
+        static constexpr D3D11_INPUT_ELEMENT_DESC LAYOUT[] = {
+            { A::SEMANTIC, A::INDEX, A::FORMAT, 0, Offset<A>(), D3D11_INPUT_PER_VERTEX_DATA, 0 }...
+        };
+
+        /// Encode and store one attribute.
+        template<typename T>
+        void Set(const typename T::Value& value)
+        {
+            const typename T::Storage storage = T::Encode(value);
+            std::memcpy(this->bytes + Offset<T>(), &storage, sizeof(storage));
+        }
+
+        /// Load and decode one attribute.
+        template<typename T>
+        typename T::Value Get() const
+        {
+            typename T::Storage storage;
+            std::memcpy(&storage, this->bytes + Offset<T>(), sizeof(storage));
+            return T::Decode(storage);
+        }
+
+    private:
+        alignas(4) uint8_t bytes[SIZE];
+    };
+
+    namespace CompactVertex
+    {
+        /// SimpleVertex::Structure in 20 bytes rather than 48.
+        using Structure = PackedVertex<
+            Attribute::OctahedralNormal,
+            Attribute::UnormColor,
+            Attribute::HalfPosition,
+            Attribute::HalfUV>;
+
+        static_assert(sizeof(Structure) == 20, "compact vertices should have no padding");
+
+        /// Corresponding DirectX mapping for translation to shader data.
+        constexpr const auto& LAYOUT = Structure::LAYOUT;
+
+        /// Pack a full precision vertex.
+        inline Structure Compress(const SimpleVertex::Structure& vertex)
+        {
+            Structure compact;
+            compact.Set<Attribute::HalfPosition>(vertex.Position);
+            compact.Set<Attribute::OctahedralNormal>(vertex.Normal);
+            compact.Set<Attribute::UnormColor>(vertex.Color);
+            compact.Set<Attribute::HalfUV>(Math::Vector2<float>(vertex.UV[0], vertex.UV[1]));
+            return compact;
+        }
+
+        /// Unpack to a full precision vertex, as the input assembler would.
+        inline SimpleVertex::Structure Expand(const Structure& compact)
+        {
+            const Math::Vector2<float> uv = compact.Get<Attribute::HalfUV>();
+            return SimpleVertex::Structure{
+                compact.Get<Attribute::HalfPosition>(),
+                compact.Get<Attribute::OctahedralNormal>(),
+                compact.Get<Attribute::UnormColor>(),
+                { uv.x, uv.y },
+            };
+        }
+    }
+}
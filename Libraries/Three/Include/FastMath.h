@@ -0,0 +1,187 @@
+#pragma once
+
+#include "Lanes.h"
+
+#include <cmath>
+
+namespace Dance::Three::Math::Fast
+{
+    // Polynomial approximations after Cephes, written once against the lane types in Lanes.h so that the same code
+    // runs one, four or eight floats at a time. They skip the special cases the standard library handles (NaN,
+    // infinities, denormals, huge arguments) in exchange for being branch-free and inlinable. Bench --math measures
+    // the error bounds quoted below against the standard library.
+
+    /// Sine and cosine together, sharing the range reduction. Absolute error below 1e-6 for |x| < 8192; past that
+    /// the reduction loses precision.
+    template<typename L>
+    inline void SinCos(L x, L& sine, L& cosine)
+    {
+        // Reduce to r in [-pi/4, pi/4] around the nearest multiple of pi/2, with pi/2 split three ways so that the
+        // products with the quadrant stay exact
+        const L quadrant = Round(x * L::Broadcast(0.636619772367581343f));
+        const L r = x
+            - quadrant * L::Broadcast(1.5703125f)
+            - quadrant * L::Broadcast(4.837512969970703125e-4f)
+            - quadrant * L::Broadcast(7.54978995489188216e-8f);
+        const L r2 = r * r;
+
+        const L s = r + r * r2 * (L::Broadcast(-1.6666654611e-1f)
+            + r2 * (L::Broadcast(8.3321608736e-3f) + r2 * L::Broadcast(-1.9515295891e-4f)));
+        const L c = L::Broadcast(1.0f) - L::Broadcast(0.5f) * r2 + r2 * r2 * (L::Broadcast(4.166664568298827e-2f)
+            + r2 * (L::Broadcast(-1.388731625493765e-3f) + r2 * L::Broadcast(2.443315711809948e-5f)));
+
+        // By quadrant modulo four, sine is s, c, -s, -c and cosine is c, -s, -c, s
+        const L one = L::Broadcast(1.0f);
+        const L two = L::Broadcast(2.0f);
+        const L half = L::Broadcast(0.5f);
+        const L q = quadrant - L::Broadcast(4.0f) * Floor(quadrant * L::Broadcast(0.25f));
+        const L upper = Floor(q * half);
+        const L odd = q - two * upper;
+        const L shifted = Floor((q + one) * half);
+        const L flipped = shifted - two * Floor(shifted * half);
+
+        const auto swap = odd > half;
+        sine = Select(swap, c, s) * (one - two * upper);
+        cosine = Select(swap, s, c) * (one - two * flipped);
+    }
+
+    template<typename L>
+    inline L Sin(L x)
+    {
+        L sine, cosine;
+        SinCos(x, sine, cosine);
+        return sine;
+    }
+
+    template<typename L>
+    inline L Cos(L x)
+    {
+        L sine, cosine;
+        SinCos(x, sine, cosine);
+        return cosine;
+    }
+
+    /// e^x with relative error below 1e-6. Saturates outside [-87.3, 88], where the result leaves the normal range.
+    template<typename L>
+    inline L Exp(L x)
+    {
+        x = Min(Max(x, L::Broadcast(-87.3f)), L::Broadcast(88.0f));
+
+        // e^x = 2^n e^r with |r| <= ln(2) / 2, ln(2) split in two for the same reason as in SinCos
+        const L n = Round(x * L::Broadcast(1.44269504088896341f));
+        const L r = x - n * L::Broadcast(0.693359375f) - n * L::Broadcast(-2.12194440e-4f);
+
+        L p = L::Broadcast(1.9875691500e-4f);
+        p = p * r + L::Broadcast(1.3981999507e-3f);
+        p = p * r + L::Broadcast(8.3334519073e-3f);
+        p = p * r + L::Broadcast(4.1665795894e-2f);
+        p = p * r + L::Broadcast(1.6666665459e-1f);
+        p = p * r + L::Broadcast(5.0000001201e-1f);
+        return (p * r * r + r + L::Broadcast(1.0f)) * Pow2(n);
+    }
+
+    /// Natural logarithm with relative error below 1e-6 away from 1 and absolute error below 1e-7 near it. Only
+    /// defined for positive normal x; clamp to FLT_MIN first if zero can occur.
+    template<typename L>
+    inline L Log(L x)
+    {
+        // log x = e log 2 + log m with the mantissa centered on 1, in [sqrt(2)/2, sqrt(2)]
+        L m, e;
+        Split(x, m, e);
+        const auto high = m > L::Broadcast(1.41421356237309505f);
+        const L one = L::Broadcast(1.0f);
+        const L f = Select(high, m * L::Broadcast(0.5f) - one, m - one);
+        e = Select(high, e + one, e);
+
+        const L f2 = f * f;
+        L p = L::Broadcast(7.0376836292e-2f);
+        p = p * f + L::Broadcast(-1.1514610310e-1f);
+        p = p * f + L::Broadcast(1.1676998740e-1f);
+        p = p * f + L::Broadcast(-1.2420140846e-1f);
+        p = p * f + L::Broadcast(1.4249322787e-1f);
+        p = p * f + L::Broadcast(-1.6668057665e-1f);
+        p = p * f + L::Broadcast(2.0000714765e-1f);
+        p = p * f + L::Broadcast(-2.4999993993e-1f);
+        p = p * f + L::Broadcast(3.3333331174e-1f);
+
+        const L y = p * f * f2 + e * L::Broadcast(-2.12194440e-4f) - L::Broadcast(0.5f) * f2;
+        return f + y + e * L::Broadcast(0.693359375f);
+    }
+
+    /// Floored modulo, x - y floor(x / y), which unlike fmod is never negative for positive y.
+    template<typename L>
+    inline L Mod(L x, L y)
+    {
+        return x - y * Floor(x / y);
+    }
+
+    // Plain float overloads run the same code through Float1, except SinCos, which can pick the quadrant with an
+    // integer switch rather than the float arithmetic the lanes need. That also makes it usable in constant
+    // expressions, so the math types' rotations are. The double overloads exist so that the templated math types can
+    // call these unconditionally; they use the standard library, whose precision doubles are chosen for.
+
+    constexpr void SinCos(float x, float& sine, float& cosine)
+    {
+        const float quadrant = (x * 0.636619772367581343f + 12582912.0f) - 12582912.0f;
+        const float r = x
+            - quadrant * 1.5703125f
+            - quadrant * 4.837512969970703125e-4f
+            - quadrant * 7.54978995489188216e-8f;
+        const float r2 = r * r;
+        const float s = r + r * r2 * (-1.6666654611e-1f + r2 * (8.3321608736e-3f + r2 * -1.9515295891e-4f));
+        const float c = 1.0f - 0.5f * r2
+            + r2 * r2 * (4.166664568298827e-2f + r2 * (-1.388731625493765e-3f + r2 * 2.443315711809948e-5f));
+
+        switch (static_cast<int>(quadrant) & 3)
+        {
+        case 0:
+            sine = s;
+            cosine = c;
+            break;
+        case 1:
+            sine = c;
+            cosine = -s;
+            break;
+        case 2:
+            sine = -s;
+            cosine = -c;
+            break;
+        default:
+            sine = -c;
+            cosine = s;
+            break;
+        }
+    }
+
+    inline void SinCos(double x, double& sine, double& cosine)
+    {
+        sine = std::sin(x);
+        cosine = std::cos(x);
+    }
+
+    constexpr float Sin(float x)
+    {
+        float sine = 0.0f;
+        float cosine = 0.0f;
+        SinCos(x, sine, cosine);
+        return sine;
+    }
+
+    constexpr float Cos(float x)
+    {
+        float sine = 0.0f;
+        float cosine = 0.0f;
+        SinCos(x, sine, cosine);
+        return cosine;
+    }
+
+    inline float Exp(float x) { return Exp(Simd::Float1(x)).value; }
+    inline float Log(float x) { return Log(Simd::Float1(x)).value; }
+    inline float Mod(float x, float y) { return Mod(Simd::Float1(x), Simd::Float1(y)).value; }
+
+    inline double Sin(double x) { return std::sin(x); }
+    inline double Cos(double x) { return std::cos(x); }
+    inline double Exp(double x) { return std::exp(x); }
+    inline double Log(double x) { return std::log(x); }
+    inline double Mod(double x, double y) { return x - y * std::floor(x / y); }
+}
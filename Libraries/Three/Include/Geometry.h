@@ -0,0 +1,279 @@
+#pragma once
+
+#include "Three.h"
+#include "Primitive.h"
+#include "Mathematics.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace Dance::Three::Graphics
+{
+    /// A triangle list whose sizes are known at compile time. The generators below are constexpr, so a mesh declared
+    /// as a constexpr variable is computed by the compiler and emitted as read-only data, with nothing to run at load.
+    ///
+    /// @typeparam V is the number of vertices, which 16-bit indices limit to 65536.
+    /// @typeparam I is the number of indices, three per triangle.
+    template<size_t V, size_t I>
+    struct StaticMesh
+    {
+        static_assert(V <= 65536, "16-bit indices address at most 65536 vertices");
+        static_assert(I % 3 == 0, "indices describe whole triangles");
+
+        std::array<SimpleVertex::Structure, V> vertices;
+        std::array<uint16_t, I> indices;
+    };
+
+    /// Check that every index addresses a vertex.
+    template<size_t V, size_t I>
+    constexpr bool IndicesInRange(const StaticMesh<V, I>& mesh)
+    {
+        for (size_t i = 0; i < I; ++i)
+        {
+            if (mesh.indices[i] >= V)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// Check that every triangle winds clockwise when seen from the side its vertex normals point to, which is the
+    /// front face under Direct3D's default rasterizer state.
+    template<size_t V, size_t I>
+    constexpr bool FacesOutward(const StaticMesh<V, I>& mesh)
+    {
+        for (size_t i = 0; i < I; i += 3)
+        {
+            const SimpleVertex::Structure& a = mesh.vertices[mesh.indices[i]];
+            const SimpleVertex::Structure& b = mesh.vertices[mesh.indices[i + 1]];
+            const SimpleVertex::Structure& c = mesh.vertices[mesh.indices[i + 2]];
+            const Vector3F normal = a.Normal + b.Normal + c.Normal;
+            if (!(Dot(Cross(b.Position - a.Position, c.Position - a.Position), normal) > 0.0f))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// Colors of the cube faces, in the order CubeMesh emits them: -Z, +Z, +Y, -Y, -X, +X.
+    constexpr std::array<Color4F, 6> CUBE_COLORS =
+    {
+        Color4F(0.0f, 1.0f, 1.0f, 1.0f),
+        Color4F(1.0f, 0.0f, 0.0f, 1.0f),
+        Color4F(1.0f, 0.0f, 1.0f, 1.0f),
+        Color4F(0.0f, 1.0f, 0.0f, 1.0f),
+        Color4F(0.0f, 0.0f, 1.0f, 1.0f),
+        Color4F(1.0f, 1.0f, 0.0f, 1.0f),
+    };
+
+    /// An axis-aligned cube centered on the origin with a flat-shaded quad per face, four vertices each so that
+    /// every face has its own normal, color and texture coordinates.
+    ///
+    /// @param size is the length of an edge.
+    /// @param colors gives each face a solid color.
+    constexpr StaticMesh<24, 36> CubeMesh(float size = 1.0f, const std::array<Color4F, 6>& colors = CUBE_COLORS)
+    {
+        // Outward normal and the two axes spanned by the corners of each face
+        const Vector3F faces[6][3] =
+        {
+            { Vector3F(0.0f, 0.0f, -1.0f), Vector3F(1.0f, 0.0f, 0.0f), Vector3F(0.0f, 1.0f, 0.0f) },
+            { Vector3F(0.0f, 0.0f, 1.0f), Vector3F(1.0f, 0.0f, 0.0f), Vector3F(0.0f, 1.0f, 0.0f) },
+            { Vector3F(0.0f, 1.0f, 0.0f), Vector3F(1.0f, 0.0f, 0.0f), Vector3F(0.0f, 0.0f, 1.0f) },
+            { Vector3F(0.0f, -1.0f, 0.0f), Vector3F(1.0f, 0.0f, 0.0f), Vector3F(0.0f, 0.0f, 1.0f) },
+            { Vector3F(-1.0f, 0.0f, 0.0f), Vector3F(0.0f, 1.0f, 0.0f), Vector3F(0.0f, 0.0f, 1.0f) },
+            { Vector3F(1.0f, 0.0f, 0.0f), Vector3F(0.0f, 1.0f, 0.0f), Vector3F(0.0f, 0.0f, 1.0f) },
+        };
+
+        // Corners go around each face as (-, -), (-, +), (+, +), (+, -) in its two axes
+        const float corners[4][2] = { { 0.0f, 0.0f }, { 0.0f, 1.0f }, { 1.0f, 1.0f }, { 1.0f, 0.0f } };
+
+        StaticMesh<24, 36> mesh{};
+        const float half = size / 2.0f;
+        for (size_t f = 0; f < 6; ++f)
+        {
+            const Vector3F& normal = faces[f][0];
+            const Vector3F& u = faces[f][1];
+            const Vector3F& v = faces[f][2];
+            for (size_t k = 0; k < 4; ++k)
+            {
+                const float s = corners[k][0];
+                const float t = corners[k][1];
+                mesh.vertices[f * 4 + k] =
+                {
+                    normal * half + u * (half * (2.0f * s - 1.0f)) + v * (half * (2.0f * t - 1.0f)),
+                    normal,
+                    colors[f],
+                    { s, t },
+                };
+            }
+
+            // Both triangles share the diagonal from the first to the third corner; which way round depends on
+            // whether the face's axes turn toward or away from its normal
+            const uint16_t base = static_cast<uint16_t>(f * 4);
+            const bool flip = Dot(Cross(u, v), normal) > 0.0f;
+            const unsigned order[6] = { 2, flip ? 1u : 0u, flip ? 0u : 1u, 3, flip ? 2u : 0u, flip ? 0u : 2u };
+            for (size_t i = 0; i < 6; ++i)
+            {
+                mesh.indices[f * 6 + i] = static_cast<uint16_t>(base + order[i]);
+            }
+        }
+        return mesh;
+    }
+
+    /// A flat grid of N by N cells in the XZ plane, centered on the origin and facing +Y, with texture coordinates
+    /// spanning the whole grid once.
+    ///
+    /// @typeparam N is the number of cells along each side.
+    /// @param size is the length of a side.
+    /// @param color is applied to every vertex.
+    template<size_t N>
+    constexpr StaticMesh<(N + 1) * (N + 1), N * N * 6> GridMesh(float size = 1.0f, const Color4F& color = Color4F(1.0f, 1.0f, 1.0f))
+    {
+        StaticMesh<(N + 1) * (N + 1), N * N * 6> mesh{};
+        for (size_t i = 0; i <= N; ++i)
+        {
+            for (size_t j = 0; j <= N; ++j)
+            {
+                const float s = static_cast<float>(i) / N;
+                const float t = static_cast<float>(j) / N;
+                mesh.vertices[i * (N + 1) + j] =
+                {
+                    Vector3F((s - 0.5f) * size, 0.0f, (t - 0.5f) * size),
+                    Vector3F(0.0f, 1.0f, 0.0f),
+                    color,
+                    { s, t },
+                };
+            }
+        }
+
+        size_t index = 0;
+        for (size_t i = 0; i < N; ++i)
+        {
+            for (size_t j = 0; j < N; ++j)
+            {
+                const uint16_t corner = static_cast<uint16_t>(i * (N + 1) + j);
+                const uint16_t across = static_cast<uint16_t>(corner + N + 1);
+                const uint16_t quad[6] = { corner, static_cast<uint16_t>(corner + 1), across, across, static_cast<uint16_t>(corner + 1), static_cast<uint16_t>(across + 1) };
+                for (uint16_t vertex : quad)
+                {
+                    mesh.indices[index++] = vertex;
+                }
+            }
+        }
+        return mesh;
+    }
+
+    /// A flat annulus of N segments in the XY plane, centered on the origin and facing -Z. The seam is duplicated so
+    /// that the texture coordinates run from zero to one around the ring and from the inside out across it.
+    ///
+    /// @typeparam N is the number of segments, at least three.
+    /// @param inner is the radius of the hole.
+    /// @param outer is the radius of the outside edge.
+    /// @param color is applied to every vertex.
+    template<size_t N>
+    constexpr StaticMesh<(N + 1) * 2, N * 6> RingMesh(float inner, float outer, const Color4F& color = Color4F(1.0f, 1.0f, 1.0f))
+    {
+        static_assert(N >= 3, "a ring needs at least three segments");
+
+        StaticMesh<(N + 1) * 2, N * 6> mesh{};
+        for (size_t k = 0; k <= N; ++k)
+        {
+            const float s = static_cast<float>(k) / N;
+            float sine = 0.0f;
+            float cosine = 0.0f;
+            Math::Fast::SinCos(Math::TwoPi * s, sine, cosine);
+
+            const Vector3F direction(cosine, sine, 0.0f);
+            mesh.vertices[k * 2] = { direction * inner, Vector3F(0.0f, 0.0f, -1.0f), color, { s, 0.0f } };
+            mesh.vertices[k * 2 + 1] = { direction * outer, Vector3F(0.0f, 0.0f, -1.0f), color, { s, 1.0f } };
+        }
+
+        for (size_t k = 0; k < N; ++k)
+        {
+            const uint16_t in = static_cast<uint16_t>(k * 2);
+            const uint16_t quad[6] = { in, static_cast<uint16_t>(in + 2), static_cast<uint16_t>(in + 1), static_cast<uint16_t>(in + 1), static_cast<uint16_t>(in + 2), static_cast<uint16_t>(in + 3) };
+            for (size_t i = 0; i < 6; ++i)
+            {
+                mesh.indices[k * 6 + i] = quad[i];
+            }
+        }
+        return mesh;
+    }
+
+    /// A sphere made by splitting each face of an octahedron into L by L triangles and pushing the vertices out to
+    /// the radius, which spaces them more evenly than latitude and longitude do. Faces don't share vertices, and
+    /// their texture coordinates span each face.
+    ///
+    /// @typeparam L is the number of subdivisions along each octahedron edge, at least one.
+    /// @param radius is the radius of the sphere.
+    /// @param color is applied to every vertex.
+    template<size_t L>
+    constexpr StaticMesh<8 * (L + 1) * (L + 2) / 2, 8 * L * L * 3> SphereMesh(float radius = 1.0f, const Color4F& color = Color4F(1.0f, 1.0f, 1.0f))
+    {
+        static_assert(L >= 1, "a sphere needs at least one subdivision");
+        constexpr size_t PER_FACE = (L + 1) * (L + 2) / 2;
+
+        StaticMesh<8 * PER_FACE, 8 * L * L * 3> mesh{};
+        size_t index = 0;
+        for (size_t f = 0; f < 8; ++f)
+        {
+            // One corner on each axis, picking the sign of each by a bit of the face number
+            const Vector3F a((f & 1) ? -1.0f : 1.0f, 0.0f, 0.0f);
+            Vector3F b(0.0f, (f & 2) ? -1.0f : 1.0f, 0.0f);
+            Vector3F c(0.0f, 0.0f, (f & 4) ? -1.0f : 1.0f);
+            if (!(Dot(Cross(b - a, c - a), a + b + c) > 0.0f))
+            {
+                const Vector3F swap = b;
+                b = c;
+                c = swap;
+            }
+
+            // Row i steps from a toward b and column j from a toward c, with i + j <= L
+            const size_t base = f * PER_FACE;
+            const auto at = [base](size_t i, size_t j)
+            {
+                return static_cast<uint16_t>(base + i * (L + 1) - i * (i - (i > 0 ? 1 : 0)) / 2 + j);
+            };
+
+            for (size_t i = 0; i <= L; ++i)
+            {
+                for (size_t j = 0; i + j <= L; ++j)
+                {
+                    const float s = static_cast<float>(i) / L;
+                    const float t = static_cast<float>(j) / L;
+                    const Vector3F normal = (a + (b - a) * s + (c - a) * t).Normalized();
+                    mesh.vertices[at(i, j)] = { normal * radius, normal, color, { s, t } };
+                }
+            }
+
+            for (size_t i = 0; i < L; ++i)
+            {
+                for (size_t j = 0; i + j < L; ++j)
+                {
+                    mesh.indices[index++] = at(i, j);
+                    mesh.indices[index++] = at(i + 1, j);
+                    mesh.indices[index++] = at(i, j + 1);
+                    if (i + j + 1 < L)
+                    {
+                        mesh.indices[index++] = at(i + 1, j);
+                        mesh.indices[index++] = at(i + 1, j + 1);
+                        mesh.indices[index++] = at(i, j + 1);
+                    }
+                }
+            }
+        }
+        return mesh;
+    }
+
+    // Compile-time checks of the generators; a failure here is a build error wherever this header is included
+    static_assert(IndicesInRange(CubeMesh()) && FacesOutward(CubeMesh()), "cube faces must point outward");
+    static_assert(IndicesInRange(GridMesh<3>()) && FacesOutward(GridMesh<3>()), "grid must face +Y");
+    static_assert(IndicesInRange(RingMesh<8>(0.5f, 1.0f)) && FacesOutward(RingMesh<8>(0.5f, 1.0f)), "ring must face -Z");
+    static_assert(IndicesInRange(SphereMesh<3>()) && FacesOutward(SphereMesh<3>()), "sphere faces must point outward");
+    static_assert(CubeMesh(2.0f).vertices[22].Position.x == 1.0f && CubeMesh(2.0f).vertices[22].Position.z == 1.0f);
+    static_assert(GridMesh<4>(2.0f).vertices[24].Position.x == 1.0f && GridMesh<4>(2.0f).vertices[24].Position.z == 1.0f);
+    static_assert(Math::IsNear(SphereMesh<4>(2.0f).vertices[7].Position.Length(), 2.0f, 1e-6f));
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "Matrix4.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace Dance::Three::Math
+{
+    /// A tree of transforms stored flat, for scenes with many nested objects. Nodes are kept in topological order,
+    /// every parent before its children, so a single front to back pass over contiguous arrays computes every world
+    /// transform with the parent's already done. Only nodes whose local transform changed, and their descendants,
+    /// are recomputed, and the pass starts at the first changed node.
+    template<typename T>
+    class Hierarchy
+    {
+    public:
+        /// Parent index of a node at the top of the tree.
+        static constexpr uint32_t ROOT = UINT32_MAX;
+
+        Hierarchy() : first(0) {}
+
+        size_t Size() const
+        {
+            return this->parents.size();
+        }
+
+        void Reserve(size_t count)
+        {
+            this->parents.reserve(count);
+            this->locals.reserve(count);
+            this->worlds.reserve(count);
+            this->dirty.reserve(count);
+            this->changed.reserve(count);
+        }
+
+        void Clear()
+        {
+            this->parents.clear();
+            this->locals.clear();
+            this->worlds.clear();
+            this->dirty.clear();
+            this->changed.clear();
+            this->first = 0;
+        }
+
+        /// Append a node under a parent that already exists, or under ROOT, which keeps the order topological; any
+        /// other parent is treated as ROOT. Returns the index of the new node, which stays valid until Clear.
+        uint32_t Add(uint32_t parent, const Matrix4<T>& local = Matrix4<T>())
+        {
+            const uint32_t index = static_cast<uint32_t>(this->parents.size());
+            this->parents.push_back(parent < index ? parent : ROOT);
+            this->locals.push_back(local);
+            this->worlds.push_back(local);
+            this->dirty.push_back(1);
+            this->changed.push_back(0);
+            this->first = std::min(this->first, static_cast<size_t>(index));
+            return index;
+        }
+
+        uint32_t Parent(uint32_t node) const
+        {
+            return this->parents[node];
+        }
+
+        const Matrix4<T>& Local(uint32_t node) const
+        {
+            return this->locals[node];
+        }
+
+        /// Replace a node's transform relative to its parent, marking it and so its subtree for the next Update.
+        void SetLocal(uint32_t node, const Matrix4<T>& local)
+        {
+            this->locals[node] = local;
+            this->dirty[node] = 1;
+            this->first = std::min(this->first, static_cast<size_t>(node));
+        }
+
+        /// A node's transform to world coordinates as of the last Update.
+        const Matrix4<T>& World(uint32_t node) const
+        {
+            return this->worlds[node];
+        }
+
+        /// Every world transform in node order, for uploading in one copy.
+        const Matrix4<T>* Worlds() const
+        {
+            return this->worlds.data();
+        }
+
+        /// Whether the last Update recomputed a node's world transform, so callers can skip unchanged uploads.
+        bool Changed(uint32_t node) const
+        {
+            return this->changed[node] != 0;
+        }
+
+        /// Recompute the world transforms of every dirty node and its descendants. A node changes if it is dirty or
+        /// its parent changed, and since the parent comes first its flag is always settled by the time it's read.
+        void Update()
+        {
+            const size_t count = this->parents.size();
+            std::fill(this->changed.begin(), this->changed.begin() + std::min(this->first, count), 0);
+            for (size_t i = this->first; i < count; ++i)
+            {
+                const uint32_t parent = this->parents[i];
+                const bool moved = this->dirty[i] || (parent != ROOT && this->changed[parent]);
+                if (moved)
+                {
+                    this->worlds[i] = parent == ROOT ? this->locals[i] : this->locals[i] * this->worlds[parent];
+                }
+                this->changed[i] = moved;
+                this->dirty[i] = 0;
+            }
+            this->first = count;
+        }
+
+    protected:
+        std::vector<uint32_t> parents;
+        std::vector<Matrix4<T>> locals;
+        std::vector<Matrix4<T>> worlds;
+
+        /// Nodes whose local transform was set since the last Update.
+        std::vector<uint8_t> dirty;
+
+        /// Nodes whose world transform the last Update recomputed.
+        std::vector<uint8_t> changed;
+
+        /// Lowest index that may be dirty; nodes before it are untouched since the last Update.
+        size_t first;
+    };
+
+    using HierarchyF = Hierarchy<float>;
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "Three.h"
+#include "Buffer.h"
+#include "Primitive.h"
+#include "Shader.h"
+#include "Instancing.h"
+#include "Mathematics.h"
+
+namespace Dance::Three::Graphics
+{
+	/// Many copies of one mesh, each with its own transform and color. Where a Renderable per copy would write its own
+	/// constant buffer and issue its own draw, this uploads every instance at once and draws them with a single
+	/// instanced call. Expects a shader built with InstancedVertex::LAYOUT, like Cube's Shader/InstancedMesh.hlsl.
+	class InstancedRenderable
+	{
+	public:
+		using Instance = InstancedVertex::Instance;
+
+		/// Empty initialize a new instanced renderable. Makes no allocations.
+		InstancedRenderable()
+			: deviceContext(nullptr)
+			, vertices()
+			, instanceBuffer()
+			, shader()
+			, bounds()
+			, instances()
+		{}
+
+		/// Create a new instanced renderable using a device to allocate the instance buffer.
+		/// 
+		/// @param device expects a D3D11 device to initialize the instance buffer with.
+		/// @param capacity is the most instances drawn per call; any more are split across further uploads and draws.
+		/// @throws ComError if the instance buffer fails to allocate.
+		InstancedRenderable(ComPtr<ID3D11Device> device, UINT capacity)
+			: deviceContext(nullptr)
+			, vertices()
+			, instanceBuffer(device, capacity)
+			, shader()
+			, bounds()
+			, instances()
+		{
+			device->GetImmediateContext(this->deviceContext.ReleaseAndGetAddressOf());
+			this->instances.Reserve(capacity);
+		}
+
+		/// Apply the shader, set the vertices and instances, then upload and draw every instance.
+		virtual void Render()
+		{
+			if (this->instances.Size() > 0)
+			{
+				Backend backend{ *this };
+				this->Set();
+				this->instances.Submit(backend);
+			}
+		}
+
+		/// Same as Render, but leaving out instances whose transformed bounds lie outside the frustum.
+		/// 
+		/// @param frustum is the camera frustum to test against, usually from Camera::Frustum.
+		virtual void Render(const Math::FrustumF& frustum)
+		{
+			if (this->instances.Size() > 0)
+			{
+				Backend backend{ *this };
+				this->Set();
+				this->instances.Submit(backend, frustum, this->bounds);
+			}
+		}
+
+		/// Get mutable access to the instances, which are usually cleared and refilled every frame.
+		/// 
+		/// @returns a reference to the batch that is uploaded on render.
+		InstanceBatch<Instance>& Instances()
+		{
+			return this->instances;
+		}
+
+		/// Get mutable access to the mesh's bounds in its own coordinates, before any instance transform is applied.
+		/// 
+		/// @returns a reference to the box, which is empty until the subclass fills it in from its vertices.
+		Math::AABBF& Bounds()
+		{
+			return this->bounds;
+		}
+
+	protected:
+		/// Handle to the device context, which we use for allocating a couple things.
+		ComPtr<ID3D11DeviceContext> deviceContext;
+
+		/// Container for the mesh shared by every instance.
+		IndexedVertexBuffer<SimpleVertex::Structure> vertices;
+
+		/// Per-instance transforms and colors, bound to the second input slot.
+		MutableVertexBuffer<Instance> instanceBuffer;
+
+		/// The shader with which to draw our vertices.
+		Shader shader;
+
+		/// Box around the vertices in local coordinates.
+		Math::AABBF bounds;
+
+		/// The instances collected on the CPU for this frame.
+		InstanceBatch<Instance> instances;
+
+	private:
+		/// Routes the batch's uploads and draws into the instance buffer and the device context.
+		struct Backend
+		{
+			const InstancedRenderable& renderable;
+
+			uint32_t Capacity() const
+			{
+				return this->renderable.instanceBuffer.Count();
+			}
+
+			void Upload(const Instance* data, uint32_t count)
+			{
+				this->renderable.instanceBuffer.Write(data, count);
+			}
+
+			void Draw(uint32_t count)
+			{
+				this->renderable.vertices.DrawInstanced(count);
+			}
+		};
+
+		/// Apply the shader and bind the mesh to slot 0 and the instances to slot 1.
+		void Set()
+		{
+			this->shader.Apply();
+			this->vertices.Set();
+			this->instanceBuffer.Set(1);
+		}
+	};
+}
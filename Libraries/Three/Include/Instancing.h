@@ -0,0 +1,126 @@
+#pragma once
+
+#include "Bounds.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace Dance::Three::Graphics
+{
+    /// Per-instance data collected on the CPU each frame and submitted in as few uploads and draws as the backend's
+    /// capacity allows. There's nothing Direct3D in here so that the packing can be checked against a backend that just
+    /// records its calls; InstancedRenderable supplies the real one. A backend provides:
+    ///
+    ///     uint32_t Capacity() const;                  // most instances a single upload can hold
+    ///     void Upload(const T* data, uint32_t count); // replace the start of the instance buffer
+    ///     void Draw(uint32_t count);                  // draw that many instances from the start of the buffer
+    ///
+    /// @typeparam T is the instance type, which needs a Math::Matrix4F Transform member to be culled.
+    template<typename T>
+    class InstanceBatch
+    {
+    public:
+        /// Get the number of instances added since the last clear.
+        size_t Size() const
+        {
+            return this->instances.size();
+        }
+
+        /// Allocate room for count instances up front so that adding them doesn't reallocate.
+        void Reserve(size_t count)
+        {
+            this->instances.reserve(count);
+            this->visible.reserve(count);
+        }
+
+        /// Remove every instance, keeping the allocation for the next frame.
+        void Clear()
+        {
+            this->instances.clear();
+        }
+
+        /// Append an instance to be drawn.
+        ///
+        /// @returns its index, which stays valid until the next clear.
+        size_t Add(const T& instance)
+        {
+            this->instances.push_back(instance);
+            return this->instances.size() - 1;
+        }
+
+        T& operator[](size_t index)
+        {
+            return this->instances[index];
+        }
+
+        const T& operator[](size_t index) const
+        {
+            return this->instances[index];
+        }
+
+        /// Upload and draw every instance, one upload and one draw per Capacity() instances.
+        ///
+        /// @param backend receives the uploads and draws.
+        /// @returns the number of instances drawn.
+        template<typename B>
+        size_t Submit(B& backend) const
+        {
+            return InstanceBatch::Submit(backend, this->instances.data(), this->instances.size());
+        }
+
+        /// Upload and draw only the instances that may be seen. The survivors are packed together first, so culling
+        /// never adds uploads or draws.
+        ///
+        /// @param backend receives the uploads and draws.
+        /// @param frustum is the camera frustum to test against, usually from Camera::Frustum.
+        /// @param bounds is the box around the shared mesh in its own coordinates; empty bounds skip culling.
+        /// @returns the number of instances drawn.
+        template<typename B>
+        size_t Submit(B& backend, const Math::FrustumF& frustum, const Math::AABBF& bounds)
+        {
+            if (bounds.Empty())
+            {
+                return this->Submit(backend);
+            }
+
+            this->visible.clear();
+            for (const T& instance : this->instances)
+            {
+                if (frustum.Intersects(bounds.Transformed(instance.Transform)))
+                {
+                    this->visible.push_back(instance);
+                }
+            }
+
+            return InstanceBatch::Submit(backend, this->visible.data(), this->visible.size());
+        }
+
+    private:
+        /// Everything added this frame, in order.
+        std::vector<T> instances;
+
+        /// Scratch space for the instances that survive culling, kept between frames to avoid reallocating.
+        std::vector<T> visible;
+
+        /// Split a contiguous run of instances into chunks the backend can hold.
+        template<typename B>
+        static size_t Submit(B& backend, const T* data, size_t count)
+        {
+            const size_t capacity = backend.Capacity();
+            if (capacity == 0)
+            {
+                return 0;
+            }
+
+            for (size_t first = 0; first < count; first += capacity)
+            {
+                const uint32_t chunk = static_cast<uint32_t>(std::min(capacity, count - first));
+                backend.Upload(data + first, chunk);
+                backend.Draw(chunk);
+            }
+
+            return count;
+        }
+    };
+}
@@ -0,0 +1,364 @@
+#pragma once
+
+#include "Simd.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace Dance::Three::Math::Simd
+{
+    /// A single float with the same interface as the vector lanes below, so that a kernel written once against a lane
+    /// type also handles the elements left over after the widest lanes, and builds without SSE at all.
+    struct Float1
+    {
+        /// Result of a comparison.
+        struct Mask
+        {
+            bool value;
+        };
+
+        static constexpr size_t Width = 1;
+
+        float value;
+
+        Float1() = default;
+        Float1(float value) : value(value) {}
+
+        static Float1 Load(const float* source) { return *source; }
+        static Float1 Broadcast(float value) { return value; }
+        void Store(float* destination) const { *destination = this->value; }
+
+        /// Spread the bytes of packed 32-bit values, such as B8G8R8A8 pixels, one lane value per byte, lowest first.
+        static void Unpack(const uint32_t* source, Float1 (&bytes)[4])
+        {
+            for (uint32_t c = 0; c < 4; ++c)
+            {
+                bytes[c] = static_cast<float>((*source >> (c * 8)) & 0xFF);
+            }
+        }
+
+        /// Clamp byte values to [0, 255], round them to the nearest integer, ties to even, and pack them back into
+        /// 32-bit values, the first in the lowest byte.
+        static void Pack(const Float1 (&bytes)[4], uint32_t* destination)
+        {
+            uint32_t packed = 0;
+            for (uint32_t c = 0; c < 4; ++c)
+            {
+                const float clamped = bytes[c].value < 0.0f ? 0.0f : bytes[c].value > 255.0f ? 255.0f : bytes[c].value;
+                packed |= static_cast<uint32_t>((clamped + 12582912.0f) - 12582912.0f) << (c * 8);
+            }
+            *destination = packed;
+        }
+
+        friend Float1 operator+(Float1 a, Float1 b) { return a.value + b.value; }
+        friend Float1 operator-(Float1 a, Float1 b) { return a.value - b.value; }
+        friend Float1 operator*(Float1 a, Float1 b) { return a.value * b.value; }
+        friend Float1 operator/(Float1 a, Float1 b) { return a.value / b.value; }
+        friend Float1 operator-(Float1 a) { return -a.value; }
+
+        friend Mask operator<(Float1 a, Float1 b) { return { a.value < b.value }; }
+        friend Mask operator>(Float1 a, Float1 b) { return { a.value > b.value }; }
+        friend Mask operator<=(Float1 a, Float1 b) { return { a.value <= b.value }; }
+        friend Mask operator>=(Float1 a, Float1 b) { return { a.value >= b.value }; }
+
+        friend Float1 Sqrt(Float1 a) { return std::sqrt(a.value); }
+        friend Float1 Abs(Float1 a) { return std::fabs(a.value); }
+        friend Float1 Min(Float1 a, Float1 b) { return a.value < b.value ? a.value : b.value; }
+        friend Float1 Max(Float1 a, Float1 b) { return a.value < b.value ? b.value : a.value; }
+        /// Round to the nearest integer, ties to even, for magnitudes below 2^22. Adding and subtracting 1.5 * 2^23
+        /// pushes the fraction out of the mantissa, which avoids a library call where the instruction set has no
+        /// rounding instruction.
+        friend Float1 Round(Float1 a) { return (a.value + 12582912.0f) - 12582912.0f; }
+
+        friend Float1 Floor(Float1 a)
+        {
+            const float rounded = (a.value + 12582912.0f) - 12582912.0f;
+            return rounded > a.value ? rounded - 1.0f : rounded;
+        }
+
+        /// Two to the power of an integral value within the normal exponent range.
+        friend Float1 Pow2(Float1 n) { return std::ldexp(1.0f, static_cast<int>(n.value)); }
+
+        /// Split a positive normal value into a mantissa in [1, 2) and its exponent.
+        friend void Split(Float1 a, Float1& mantissa, Float1& exponent)
+        {
+            int e = 0;
+            mantissa = std::frexp(a.value, &e) * 2.0f;
+            exponent = static_cast<float>(e - 1);
+        }
+
+        /// Pick a where the mask is set and b elsewhere.
+        friend Float1 Select(Mask mask, Float1 a, Float1 b) { return mask.value ? a : b; }
+
+        /// One bit per element of a mask, lowest element first.
+        friend int Bits(Mask mask) { return mask.value ? 1 : 0; }
+
+        /// Apply a scalar function to every element, for the odd operation that has no vector form.
+        template<typename F>
+        friend Float1 Map(Float1 a, F&& function) { return function(a.value); }
+    };
+
+#if DANCE_SSE
+    /// Four floats in an SSE register.
+    struct Float4
+    {
+        struct Mask
+        {
+            __m128 value;
+        };
+
+        static constexpr size_t Width = 4;
+
+        __m128 value;
+
+        Float4() = default;
+        Float4(__m128 value) : value(value) {}
+
+        static Float4 Load(const float* source) { return _mm_loadu_ps(source); }
+        static Float4 Broadcast(float value) { return _mm_set1_ps(value); }
+        void Store(float* destination) const { _mm_storeu_ps(destination, this->value); }
+
+        static void Unpack(const uint32_t* source, Float4 (&bytes)[4])
+        {
+            const __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+            const __m128i mask = _mm_set1_epi32(0xFF);
+            bytes[0] = _mm_cvtepi32_ps(_mm_and_si128(packed, mask));
+            bytes[1] = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(packed, 8), mask));
+            bytes[2] = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(packed, 16), mask));
+            bytes[3] = _mm_cvtepi32_ps(_mm_srli_epi32(packed, 24));
+        }
+
+        static void Pack(const Float4 (&bytes)[4], uint32_t* destination)
+        {
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 top = _mm_set1_ps(255.0f);
+            const auto byte = [&](const Float4& value) { return _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(value.value, zero), top)); };
+            const __m128i packed = _mm_or_si128(
+                _mm_or_si128(byte(bytes[0]), _mm_slli_epi32(byte(bytes[1]), 8)),
+                _mm_or_si128(_mm_slli_epi32(byte(bytes[2]), 16), _mm_slli_epi32(byte(bytes[3]), 24)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destination), packed);
+        }
+
+        friend Float4 operator+(Float4 a, Float4 b) { return _mm_add_ps(a.value, b.value); }
+        friend Float4 operator-(Float4 a, Float4 b) { return _mm_sub_ps(a.value, b.value); }
+        friend Float4 operator*(Float4 a, Float4 b) { return _mm_mul_ps(a.value, b.value); }
+        friend Float4 operator/(Float4 a, Float4 b) { return _mm_div_ps(a.value, b.value); }
+        friend Float4 operator-(Float4 a) { return _mm_xor_ps(a.value, _mm_set1_ps(-0.0f)); }
+
+        friend Mask operator<(Float4 a, Float4 b) { return { _mm_cmplt_ps(a.value, b.value) }; }
+        friend Mask operator>(Float4 a, Float4 b) { return { _mm_cmpgt_ps(a.value, b.value) }; }
+        friend Mask operator<=(Float4 a, Float4 b) { return { _mm_cmple_ps(a.value, b.value) }; }
+        friend Mask operator>=(Float4 a, Float4 b) { return { _mm_cmpge_ps(a.value, b.value) }; }
+
+        friend Float4 Sqrt(Float4 a) { return _mm_sqrt_ps(a.value); }
+        friend Float4 Abs(Float4 a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a.value); }
+        friend Float4 Min(Float4 a, Float4 b) { return _mm_min_ps(a.value, b.value); }
+        friend Float4 Max(Float4 a, Float4 b) { return _mm_max_ps(a.value, b.value); }
+
+        /// Round to the nearest integer, ties to even, for magnitudes below 2^31.
+        friend Float4 Round(Float4 a) { return _mm_cvtepi32_ps(_mm_cvtps_epi32(a.value)); }
+
+        friend Float4 Floor(Float4 a)
+        {
+            const __m128 rounded = _mm_cvtepi32_ps(_mm_cvtps_epi32(a.value));
+            return _mm_sub_ps(rounded, _mm_and_ps(_mm_cmpgt_ps(rounded, a.value), _mm_set1_ps(1.0f)));
+        }
+
+        friend Float4 Pow2(Float4 n)
+        {
+            const __m128i biased = _mm_add_epi32(_mm_cvtps_epi32(n.value), _mm_set1_epi32(127));
+            return _mm_castsi128_ps(_mm_slli_epi32(biased, 23));
+        }
+
+        friend void Split(Float4 a, Float4& mantissa, Float4& exponent)
+        {
+            const __m128i bits = _mm_castps_si128(a.value);
+            exponent = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127)));
+            mantissa = _mm_or_ps(_mm_and_ps(a.value, _mm_castsi128_ps(_mm_set1_epi32(0x007fffff))), _mm_set1_ps(1.0f));
+        }
+
+        friend Float4 Select(Mask mask, Float4 a, Float4 b)
+        {
+            return _mm_or_ps(_mm_and_ps(mask.value, a.value), _mm_andnot_ps(mask.value, b.value));
+        }
+
+        friend int Bits(Mask mask) { return _mm_movemask_ps(mask.value); }
+
+        template<typename F>
+        friend Float4 Map(Float4 a, F&& function)
+        {
+            alignas(16) float lanes[4];
+            _mm_store_ps(lanes, a.value);
+            for (float& lane : lanes)
+            {
+                lane = function(lane);
+            }
+            return _mm_load_ps(lanes);
+        }
+    };
+#endif
+
+#if DANCE_AVX
+    /// Eight floats in an AVX register.
+    struct Float8
+    {
+        struct Mask
+        {
+            __m256 value;
+        };
+
+        static constexpr size_t Width = 8;
+
+        __m256 value;
+
+        Float8() = default;
+        Float8(__m256 value) : value(value) {}
+
+        static Float8 Load(const float* source) { return _mm256_loadu_ps(source); }
+        static Float8 Broadcast(float value) { return _mm256_set1_ps(value); }
+        void Store(float* destination) const { _mm256_storeu_ps(destination, this->value); }
+
+        // AVX has no 256-bit integer shifts, so bytes are moved on each half with SSE2
+
+        static void Unpack(const uint32_t* source, Float8 (&bytes)[4])
+        {
+            const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+            const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + 4));
+            const __m128i mask = _mm_set1_epi32(0xFF);
+            const auto widen = [](__m128i low, __m128i high)
+            {
+                return _mm256_cvtepi32_ps(_mm256_insertf128_si256(_mm256_castsi128_si256(low), high, 1));
+            };
+            bytes[0] = widen(_mm_and_si128(low, mask), _mm_and_si128(high, mask));
+            bytes[1] = widen(_mm_and_si128(_mm_srli_epi32(low, 8), mask), _mm_and_si128(_mm_srli_epi32(high, 8), mask));
+            bytes[2] = widen(_mm_and_si128(_mm_srli_epi32(low, 16), mask), _mm_and_si128(_mm_srli_epi32(high, 16), mask));
+            bytes[3] = widen(_mm_srli_epi32(low, 24), _mm_srli_epi32(high, 24));
+        }
+
+        static void Pack(const Float8 (&bytes)[4], uint32_t* destination)
+        {
+            const __m256 zero = _mm256_setzero_ps();
+            const __m256 top = _mm256_set1_ps(255.0f);
+            __m128i halves[4][2];
+            for (size_t c = 0; c < 4; ++c)
+            {
+                const __m256i rounded = _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(bytes[c].value, zero), top));
+                halves[c][0] = _mm256_castsi256_si128(rounded);
+                halves[c][1] = _mm256_extractf128_si256(rounded, 1);
+            }
+            for (size_t half = 0; half < 2; ++half)
+            {
+                const __m128i packed = _mm_or_si128(
+                    _mm_or_si128(halves[0][half], _mm_slli_epi32(halves[1][half], 8)),
+                    _mm_or_si128(_mm_slli_epi32(halves[2][half], 16), _mm_slli_epi32(halves[3][half], 24)));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + half * 4), packed);
+            }
+        }
+
+        friend Float8 operator+(Float8 a, Float8 b) { return _mm256_add_ps(a.value, b.value); }
+        friend Float8 operator-(Float8 a, Float8 b) { return _mm256_sub_ps(a.value, b.value); }
+        friend Float8 operator*(Float8 a, Float8 b) { return _mm256_mul_ps(a.value, b.value); }
+        friend Float8 operator/(Float8 a, Float8 b) { return _mm256_div_ps(a.value, b.value); }
+        friend Float8 operator-(Float8 a) { return _mm256_xor_ps(a.value, _mm256_set1_ps(-0.0f)); }
+
+        friend Mask operator<(Float8 a, Float8 b) { return { _mm256_cmp_ps(a.value, b.value, _CMP_LT_OQ) }; }
+        friend Mask operator>(Float8 a, Float8 b) { return { _mm256_cmp_ps(a.value, b.value, _CMP_GT_OQ) }; }
+        friend Mask operator<=(Float8 a, Float8 b) { return { _mm256_cmp_ps(a.value, b.value, _CMP_LE_OQ) }; }
+        friend Mask operator>=(Float8 a, Float8 b) { return { _mm256_cmp_ps(a.value, b.value, _CMP_GE_OQ) }; }
+
+        friend Float8 Sqrt(Float8 a) { return _mm256_sqrt_ps(a.value); }
+        friend Float8 Abs(Float8 a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.value); }
+        friend Float8 Min(Float8 a, Float8 b) { return _mm256_min_ps(a.value, b.value); }
+        friend Float8 Max(Float8 a, Float8 b) { return _mm256_max_ps(a.value, b.value); }
+        friend Float8 Floor(Float8 a) { return _mm256_floor_ps(a.value); }
+        friend Float8 Round(Float8 a) { return _mm256_round_ps(a.value, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+
+        // AVX has no 256-bit integer arithmetic, so the exponent work is done on each half with SSE2
+
+        friend Float8 Pow2(Float8 n)
+        {
+            const __m256i integral = _mm256_cvtps_epi32(n.value);
+            const __m128i bias = _mm_set1_epi32(127);
+            const __m128i low = _mm_slli_epi32(_mm_add_epi32(_mm256_castsi256_si128(integral), bias), 23);
+            const __m128i high = _mm_slli_epi32(_mm_add_epi32(_mm256_extractf128_si256(integral, 1), bias), 23);
+            return _mm256_castsi256_ps(_mm256_insertf128_si256(_mm256_castsi128_si256(low), high, 1));
+        }
+
+        friend void Split(Float8 a, Float8& mantissa, Float8& exponent)
+        {
+            const __m256i bits = _mm256_castps_si256(a.value);
+            const __m128i bias = _mm_set1_epi32(127);
+            const __m128i low = _mm_sub_epi32(_mm_srli_epi32(_mm256_castsi256_si128(bits), 23), bias);
+            const __m128i high = _mm_sub_epi32(_mm_srli_epi32(_mm256_extractf128_si256(bits, 1), 23), bias);
+            exponent = _mm256_cvtepi32_ps(_mm256_insertf128_si256(_mm256_castsi128_si256(low), high, 1));
+            mantissa = _mm256_or_ps(
+                _mm256_and_ps(a.value, _mm256_castsi256_ps(_mm256_set1_epi32(0x007fffff))),
+                _mm256_set1_ps(1.0f));
+        }
+
+        friend Float8 Select(Mask mask, Float8 a, Float8 b)
+        {
+            return _mm256_blendv_ps(b.value, a.value, mask.value);
+        }
+
+        friend int Bits(Mask mask) { return _mm256_movemask_ps(mask.value); }
+
+        template<typename F>
+        friend Float8 Map(Float8 a, F&& function)
+        {
+            alignas(32) float lanes[8];
+            _mm256_store_ps(lanes, a.value);
+            for (float& lane : lanes)
+            {
+                lane = function(lane);
+            }
+            return _mm256_load_ps(lanes);
+        }
+    };
+#endif
+
+    /// Append the indices of the elements whose mask bit is set, starting from element i, without branching on each
+    /// one. The output must have room for every element up to i + L::Width.
+    template<typename L>
+    inline void Compact(typename L::Mask mask, size_t i, uint32_t* output, size_t& count)
+    {
+        const int bits = Bits(mask);
+        for (size_t j = 0; j < L::Width; ++j)
+        {
+            output[count] = static_cast<uint32_t>(i + j);
+            count += (bits >> j) & 1;
+        }
+    }
+
+    /// Run a kernel over count elements, as many at a time as the build allows: eight with AVX, then four with SSE,
+    /// then one by one for the tail. The kernel is called with a default lane value, whose type it should take as
+    /// auto to pick up the width, and the index of the first element to process.
+    template<typename K>
+    inline void Sweep(size_t count, K&& kernel)
+    {
+        size_t i = 0;
+#if DANCE_AVX
+        for (; i + Float8::Width <= count; i += Float8::Width)
+        {
+            kernel(Float8(), i);
+        }
+#endif
+#if DANCE_SSE
+        for (; i + Float4::Width <= count; i += Float4::Width)
+        {
+            kernel(Float4(), i);
+        }
+
+        // Bounding the tail by the remainder rather than by count tells the compiler it's shorter than a lane, which
+        // it otherwise can't prove once the kernel is inlined and warns about as it unrolls
+        const size_t tail = count % Float4::Width;
+#else
+        const size_t tail = count;
+#endif
+        for (size_t j = 0; j < tail; ++j)
+        {
+            kernel(Float1(), i + j);
+        }
+    }
+}
@@ -6,6 +6,7 @@
 
 #include "Vector2.h"
 #include "Vector3.h"
+#include "FastMath.h"
 
 namespace Dance::Three::Math
 {
@@ -15,14 +16,29 @@ namespace Dance::Three::Math
     public:
         T value[3][3];
 
-        Matrix3()
+        constexpr Matrix3()
+            : value{ {1, 0, 0}, {0, 1, 0}, {0, 0, 1} }
+        {}
+
+        explicit constexpr Matrix3
+        (
+            T a, T b, T c,
+            T d, T e, T f,
+            T g, T h, T i
+        )
+            : value{ {a, b, c}, {d, e, f}, {g, h, i} }
+        {}
+
+        explicit constexpr Matrix3(const T value[3][3])
+            : value{}
         {
-            *this = Matrix3::Identity();
-        }
-
-        explicit Matrix3(const T value[3][3])
-        {
-            std::memcpy(this->value, value, 9 * sizeof(T));
+            for (int i = 0; i < 3; ++i)
+            {
+                for (int j = 0; j < 3; ++j)
+                {
+                    this->value[i][j] = value[i][j];
+                }
+            }
         }
 
         const T* Flatten() const
@@ -30,7 +46,7 @@ namespace Dance::Three::Math
             return reinterpret_cast<const T*>(&this->value[0][0]);
         }
 
-        friend Matrix3 operator*(const Matrix3& a, const Matrix3& b)
+        friend constexpr Matrix3 operator*(const Matrix3& a, const Matrix3& b)
         {
             Matrix3<T> c;
             c.value[0][0] =
@@ -83,80 +99,79 @@ namespace Dance::Three::Math
             return c;
         }
 
-        Matrix3& operator*=(const Matrix3& m)
+        constexpr Matrix3& operator*=(const Matrix3& m)
         {
             *this = *this * m;
             return *this;
         }
 
-        void Transpose()
+        constexpr void Transpose()
         {
-            std::swap(this->value[0][1], value[1][0]);
-            std::swap(this->value[0][2], value[2][0]);
-            std::swap(this->value[1][2], value[2][1]);
+            // std::swap is only constexpr from C++20
+            for (int i = 0; i < 3; ++i)
+            {
+                for (int j = i + 1; j < 3; ++j)
+                {
+                    const T swap = this->value[i][j];
+                    this->value[i][j] = this->value[j][i];
+                    this->value[j][i] = swap;
+                }
+            }
         }
 
-        Matrix3 Transposed() const
+        constexpr Matrix3 Transposed() const
         {
             Matrix3 result(*this);
             result.Transpose();
             return result;
         }
 
-        template<typename T>
         static constexpr Matrix3<T> Scale(T x, T y)
         {
             return Matrix3<T>
-            ({
-                { x, 0, 0 },
-                { 0, y, 0 },
-                { 0, 0, 1 },
-            });
+                (
+                    x, 0, 0,
+                    0, y, 0,
+                    0, 0, 1
+                    );
         }
 
-        template<typename T>
         static constexpr Matrix3<T> Scale(const Vector2<T>& v)
         {
             return Matrix3::Scale(v.x, v.y);
         }
 
-        template<typename T>
         static constexpr Matrix3<T> Scale(T s)
         {
             return Matrix3::Scale(s, s);
         }
 
-        template<typename T>
         static constexpr Matrix3 Rotation(T theta)
         {
+            T s = 0;
+            T c = 0;
+            Fast::SinCos(theta, s, c);
             return Matrix3
-            ({
-                { std::cos(theta), std::sin(theta), 0 },
-                { -std::sin(theta), std::cos(theta), 0 },
-                { 0, 0, 1 },
-            });
+                (
+                    c, s, 0,
+                    -s, c, 0,
+                    0, 0, 1
+                    );
         }
 
-        template<typename T>
         static constexpr Matrix3 Translation(const Vector2<T>& v)
         {
             return Matrix3
-            ({
-                { 1, 0, 0 },
-                { 0, 1, 0 },
-                { v.x, v.y, 1 },
-            });
+                (
+                    1, 0, 0,
+                    0, 1, 0,
+                    v.x, v.y, 1
+                    );
         }
 
-        template<typename T>
         static constexpr Matrix3<T> Identity()
         {
-            return Matrix3
-            ({
-                { 1, 0, 0 },
-                { 0, 1, 0 },
-                { 0, 0, 1 }
-            });
+            return Matrix3();
         }
     };
 
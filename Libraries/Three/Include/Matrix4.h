@@ -2,6 +2,8 @@
 
 #include "Vector3.h"
 #include "Quaternion.h"
+#include "FastMath.h"
+#include "Simd.h"
 
 namespace Dance::Three::Math
 {
@@ -11,12 +13,11 @@ namespace Dance::Three::Math
     public:
         T value[4][4];
 
-        Matrix4()
-        {
-            *this = Matrix4::Identity<T>();
-        }
+        constexpr Matrix4()
+            : value{ {1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}, {0, 0, 0, 1} }
+        {}
 
-        explicit Matrix4
+        explicit constexpr Matrix4
         (
             T a, T b, T c, T d,
             T e, T f, T g, T h,
@@ -26,9 +27,16 @@ namespace Dance::Three::Math
             : value{ {a, b, c, d}, {e, f, g, h}, {i, j, k, l}, {m, n, o, p} }
         {}
 
-        explicit Matrix4(const T value[4][4])
+        explicit constexpr Matrix4(const T value[4][4])
+            : value{}
         {
-            memcpy(this->value, value, 16 * sizeof(T));
+            for (int i = 0; i < 4; ++i)
+            {
+                for (int j = 0; j < 4; ++j)
+                {
+                    this->value[i][j] = value[i][j];
+                }
+            }
         }
 
         explicit Matrix4(const __m128 rows[4])
@@ -41,7 +49,32 @@ namespace Dance::Three::Math
             return reinterpret_cast<const T*>(&this->value[0][0]);
         }
 
-        friend Matrix4 operator*(const Matrix4& a, const Matrix4& b)
+        /// Uses the vectorized kernel when there is one for T, except in constant expressions.
+        friend constexpr Matrix4 operator*(const Matrix4& a, const Matrix4& b)
+        {
+#if DANCE_SSE
+            if constexpr (Simd::Accelerated<T>)
+            {
+                if (Runtime())
+                {
+                    return Matrix4::MultiplyVector(a, b);
+                }
+            }
+#endif
+            return Matrix4::MultiplyScalar(a, b);
+        }
+
+        /// Vectorized matrix product. Kept out of operator* so that c is the only object returned here and is built in
+        /// place; otherwise the result is copied out with wide loads that stall on the kernel's narrower stores.
+        static Matrix4 MultiplyVector(const Matrix4& a, const Matrix4& b)
+        {
+            Matrix4 c;
+            Simd::Multiply(a.value, b.value, c.value);
+            return c;
+        }
+
+        /// Portable matrix product, used for types without a vectorized kernel.
+        static constexpr Matrix4 MultiplyScalar(const Matrix4& a, const Matrix4& b)
         {
             Matrix4 c;
 
@@ -134,18 +167,34 @@ namespace Dance::Three::Math
             return c;
         }
 
-        Matrix4& operator*=(const Matrix4& right)
+        constexpr Matrix4& operator*=(const Matrix4& right)
         {
             *this = *this * right;
             return *this;
         }
 
-        void Invert()
+        constexpr void Invert()
         {
-            T tmp[12];  // temp array for pairs
-            T src[16];  // array of transpose source matrix
-            T dst[16];  // storage
-            T det;      // determinant
+#if DANCE_SSE
+            if constexpr (Simd::Accelerated<T>)
+            {
+                if (Runtime())
+                {
+                    Simd::Invert(this->value);
+                    return;
+                }
+            }
+#endif
+            this->InvertScalar();
+        }
+
+        /// Portable inverse by cofactor expansion, used for types without a vectorized kernel.
+        constexpr void InvertScalar()
+        {
+            T tmp[12] = {};  // temp array for pairs
+            T src[16] = {};  // array of transpose source matrix
+            T dst[16] = {};  // storage
+            T det = 0;       // determinant
 
             // row 1 to col 1
             src[0] = this->value[0][0];
@@ -255,39 +304,110 @@ namespace Dance::Three::Math
             }
         }
 
-        Matrix4 Inverted() const
+        constexpr Matrix4 Inverted() const
         {
             Matrix4 result(*this);
             result.Invert();
             return result;
         }
 
-        Vector3<T> Translation() const
+        /// Invert a matrix whose last column is (0, 0, 0, 1), i.e. a linear transform followed by a translation. Uses
+        /// the vectorized kernel when there is one for T, except in constant expressions.
+        constexpr void InvertAffine()
+        {
+#if DANCE_SSE
+            if constexpr (Simd::Accelerated<T>)
+            {
+                if (Runtime())
+                {
+                    Simd::InvertAffine(this->value);
+                    return;
+                }
+            }
+#endif
+            this->InvertAffineScalar();
+        }
+
+        /// Portable affine inverse. Only the upper 3x3 block needs a general inverse, after which the translation is
+        /// carried through it.
+        constexpr void InvertAffineScalar()
+        {
+            const T(&m)[4][4] = this->value;
+            const T c00 = m[1][1] * m[2][2] - m[1][2] * m[2][1];
+            const T c01 = m[1][2] * m[2][0] - m[1][0] * m[2][2];
+            const T c02 = m[1][0] * m[2][1] - m[1][1] * m[2][0];
+            const T invDet = static_cast<T>(1) / (m[0][0] * c00 + m[0][1] * c01 + m[0][2] * c02);
+
+            T inverse[3][3] = {};
+            inverse[0][0] = c00 * invDet;
+            inverse[0][1] = (m[0][2] * m[2][1] - m[0][1] * m[2][2]) * invDet;
+            inverse[0][2] = (m[0][1] * m[1][2] - m[0][2] * m[1][1]) * invDet;
+            inverse[1][0] = c01 * invDet;
+            inverse[1][1] = (m[0][0] * m[2][2] - m[0][2] * m[2][0]) * invDet;
+            inverse[1][2] = (m[0][2] * m[1][0] - m[0][0] * m[1][2]) * invDet;
+            inverse[2][0] = c02 * invDet;
+            inverse[2][1] = (m[0][1] * m[2][0] - m[0][0] * m[2][1]) * invDet;
+            inverse[2][2] = (m[0][0] * m[1][1] - m[0][1] * m[1][0]) * invDet;
+
+            this->SetInverseTranslation(inverse);
+        }
+
+        constexpr Matrix4 InvertedAffine() const
+        {
+            Matrix4 result(*this);
+            result.InvertAffine();
+            return result;
+        }
+
+        /// Invert a rotation followed by a translation. The rotation rows must be orthonormal, so its inverse is just
+        /// its transpose and the translation is negated and rotated back. Scaled matrices need InvertAffine.
+        constexpr void InvertRigid()
+        {
+            T inverse[3][3] = {};
+            for (int i = 0; i < 3; ++i)
+            {
+                for (int j = 0; j < 3; ++j)
+                {
+                    inverse[i][j] = this->value[j][i];
+                }
+            }
+
+            this->SetInverseTranslation(inverse);
+        }
+
+        constexpr Matrix4 InvertedRigid() const
+        {
+            Matrix4 result(*this);
+            result.InvertRigid();
+            return result;
+        }
+
+        constexpr Vector3<T> Translation() const
         {
             return Vector3<T>(this->value[3][0], this->value[3][1], this->value[3][2]);
         }
 
-        Vector3<T> X() const
+        constexpr Vector3<T> X() const
         {
             return Vector3<T>(this->value[0][0], this->value[0][1], this->value[0][2]);
         }
 
-        Vector3<T> Y() const
+        constexpr Vector3<T> Y() const
         {
             return Vector3<T>(this->value[1][0], this->value[1][1], this->value[1][2]);
         }
 
-        Vector3<T> Z() const
+        constexpr Vector3<T> Z() const
         {
             return Vector3<T>(this->value[2][0], this->value[2][1], this->value[2][2]);
         }
 
-        Vector3<T> W() const
+        constexpr Vector3<T> W() const
         {
             return Vector3<T>(this->value[3][0], this->value[3][1], this->value[3][2]);
         }
 
-        Vector3<T> Scale() const
+        constexpr Vector3<T> Scale() const
         {
             return Vector3<T>
                 (
@@ -297,24 +417,27 @@ namespace Dance::Three::Math
                     );
         }
 
-        void Transpose()
+        constexpr void Transpose()
         {
-            std::swap(this->value[0][1], this->value[1][0]);
-            std::swap(this->value[0][2], this->value[2][0]);
-            std::swap(this->value[0][3], this->value[3][0]);
-            std::swap(this->value[1][2], this->value[2][1]);
-            std::swap(this->value[1][3], this->value[3][1]);
-            std::swap(this->value[2][3], this->value[3][2]);
+            // std::swap is only constexpr from C++20
+            for (int i = 0; i < 4; ++i)
+            {
+                for (int j = i + 1; j < 4; ++j)
+                {
+                    const T swap = this->value[i][j];
+                    this->value[i][j] = this->value[j][i];
+                    this->value[j][i] = swap;
+                }
+            }
         }
 
-        Matrix4 Transposed() const
+        constexpr Matrix4 Transposed() const
         {
             Matrix4 result(*this);
             result.Transpose();
             return result;
         }
 
-        template<typename T>
         static constexpr Matrix4<T> Scale(T x, T y, T z)
         {
             return Matrix4<T>
@@ -326,55 +449,58 @@ namespace Dance::Three::Math
                     );
         }
 
-        template<typename T>
         static constexpr Matrix4<T> Scale(const Vector3<T>& v)
         {
             return Matrix4<T>::Scale(v.x, v.y, v.z);
         }
 
-        template<typename T>
         static constexpr Matrix4<T> Scale(T s)
         {
             return Matrix4<T>::Scale(s, s, s);
         }
 
-        template<typename T>
         static constexpr Matrix4<T> XRotation(T theta)
         {
+            T s = 0;
+            T c = 0;
+            Fast::SinCos(theta, s, c);
             return Matrix4<T>
                 (
                     1, 0, 0, 0,
-                    0, std::cos(theta), std::sin(theta), 0,
-                    0, -std::sin(theta), std::cos(theta), 0,
+                    0, c, s, 0,
+                    0, -s, c, 0,
                     0, 0, 0, 1
                     );
         }
 
-        template<typename T>
         static constexpr Matrix4<T> YRotation(T theta)
         {
+            T s = 0;
+            T c = 0;
+            Fast::SinCos(theta, s, c);
             return Matrix4<T>
                 (
-                    std::cos(theta), 0, -std::sin(theta), 0,
+                    c, 0, -s, 0,
                     0, 1, 0, 0,
-                    std::sin(theta), 0, std::cos(theta), 0,
+                    s, 0, c, 0,
                     0, 0, 0, 1
                     );
         }
 
-        template<typename T>
         static constexpr Matrix4<T> ZRotation(T theta)
         {
+            T s = 0;
+            T c = 0;
+            Fast::SinCos(theta, s, c);
             return Matrix4<T>
                 (
-                    std::cos(theta), std::sin(theta), 0, 0,
-                    -std::sin(theta), std::cos(theta), 0, 0,
+                    c, s, 0, 0,
+                    -s, c, 0, 0,
                     0, 0, 1, 0,
                     0, 0, 0, 1
                     );
         }
 
-        template<typename T>
         static constexpr Matrix4<T> From(const Quaternion<T>& q)
         {
             Matrix4<T> m;
@@ -402,7 +528,6 @@ namespace Dance::Three::Math
             return m;
         }
 
-        template<typename T>
         static constexpr Matrix4<T> Translation(T x, T y, T z)
         {
             return Matrix4<T>
@@ -414,7 +539,6 @@ namespace Dance::Three::Math
                     );
         }
 
-        template<typename T>
         static constexpr Matrix4<T> Translation(const Vector3<T>& v)
         {
             return Matrix4<T>
@@ -426,12 +550,11 @@ namespace Dance::Three::Math
                     );
         }
 
-        template<typename T>
         static constexpr Matrix4<T> Look(const Vector3<T>& eye, const Vector3<T>& at, const Vector3<T>& up)
         {
             Vector3<T> forward = (at - eye).Normalized();
-            Vector3<T> left = Vector3::Cross<T>(up, forward).Normalized();
-            Vector3<T> newUp = Vector3::Cross<T>(forward, left).Normalized();
+            Vector3<T> left = Cross(up, forward).Normalized();
+            Vector3<T> newUp = Cross(forward, left).Normalized();
 
             return Matrix4<T>
                 (
@@ -442,7 +565,6 @@ namespace Dance::Three::Math
                     );
         }
 
-        template<typename T>
         static constexpr Matrix4<T> Orthographic(T width, T height, T nearZ, T farZ)
         {
             return Matrix4<T>
@@ -454,7 +576,6 @@ namespace Dance::Three::Math
                     );
         }
 
-        template<typename T>
         static constexpr Matrix4<T> Perspective(T fovY, T width, T height, T nearZ, T farZ)
         {
             T yScale = 1 / std::tan(fovY / 2);
@@ -468,16 +589,30 @@ namespace Dance::Three::Math
                     );
         }
 
-        template<typename T>
         static constexpr Matrix4<T> Identity()
         {
-            return Matrix4<T>
-                (
-                    1, 0, 0, 0,
-                    0, 1, 0, 0,
-                    0, 0, 1, 0,
-                    0, 0, 0, 1
-                    );
+            return Matrix4<T>();
+        }
+
+    private:
+        /// Finish an affine inverse given the inverse of the upper 3x3 block: the translation becomes -t * inverse.
+        constexpr void SetInverseTranslation(const T inverse[3][3])
+        {
+            const T x = this->value[3][0];
+            const T y = this->value[3][1];
+            const T z = this->value[3][2];
+            for (int j = 0; j < 3; ++j)
+            {
+                this->value[0][j] = inverse[0][j];
+                this->value[1][j] = inverse[1][j];
+                this->value[2][j] = inverse[2][j];
+                this->value[3][j] = -(x * inverse[0][j] + y * inverse[1][j] + z * inverse[2][j]);
+            }
+
+            this->value[0][3] = 0;
+            this->value[1][3] = 0;
+            this->value[2][3] = 0;
+            this->value[3][3] = 1;
         }
     };
 
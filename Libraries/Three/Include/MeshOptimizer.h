@@ -0,0 +1,396 @@
+#pragma once
+
+#include "Vector3.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+namespace Dance::Three::Graphics
+{
+    /// How well an index order suits the GPU, from simulating its caches over the indices.
+    struct MeshStatistics
+    {
+        /// Average cache miss ratio: vertices transformed per triangle. Three at worst, around 0.6 for a well ordered
+        /// regular grid.
+        float ACMR;
+
+        /// Vertices transformed per unique vertex. One is ideal.
+        float ATVR;
+
+        /// Bytes read from the vertex buffer per byte it holds, reading whole 64-byte lines. One is ideal.
+        float Overfetch;
+    };
+
+    /// Statistics before and after Optimize.
+    struct MeshReport
+    {
+        MeshStatistics Before;
+        MeshStatistics After;
+    };
+
+    namespace Detail
+    {
+        /// Entries in the post-transform cache assumed by Analyze and the overdraw clustering. Hardware caches differ,
+        /// but orderings good for one size are good for the others.
+        constexpr size_t TRANSFORM_CACHE = 16;
+
+        /// Cache size that Forsyth's scoring models, deliberately larger than the cache we measure against.
+        constexpr size_t FORSYTH_CACHE = 32;
+
+        /// Lines and line size of the simulated vertex fetch cache.
+        constexpr size_t FETCH_LINES = 32;
+        constexpr size_t FETCH_LINE = 64;
+
+        /// Forsyth's vertex score: favour vertices recently used, except those of the very last triangle, which the
+        /// next triangle will share anyway, and boost vertices with few triangles left so that they get finished off
+        /// rather than stranded.
+        inline float VertexScore(int position, uint32_t remaining)
+        {
+            if (remaining == 0)
+            {
+                return -1.0f;
+            }
+
+            float score = 0.0f;
+            if (position >= 0)
+            {
+                score = position < 3
+                    ? 0.75f
+                    : std::pow(1.0f - static_cast<float>(position - 3) / (FORSYTH_CACHE - 3), 1.5f);
+            }
+            return score + 2.0f / std::sqrt(static_cast<float>(remaining));
+        }
+
+        /// A first in, first out cache of keys, which is how post-transform caches behave.
+        class Fifo
+        {
+        public:
+            explicit Fifo(size_t size) : entries(size, UINT64_MAX), next(0) {}
+
+            /// Look up a key, inserting it on a miss.
+            ///
+            /// @returns true on a hit.
+            bool Touch(uint64_t key)
+            {
+                if (std::find(this->entries.begin(), this->entries.end(), key) != this->entries.end())
+                {
+                    return true;
+                }
+                this->entries[this->next] = key;
+                this->next = (this->next + 1) % this->entries.size();
+                return false;
+            }
+
+        private:
+            std::vector<uint64_t> entries;
+            size_t next;
+        };
+    }
+
+    /// Simulate the post-transform and vertex fetch caches over an index list.
+    ///
+    /// @param indices is the triangle list.
+    /// @param count is the number of indices.
+    /// @param vertexCount is the number of vertices the indices refer to.
+    /// @param vertexSize is the size of each vertex in bytes.
+    template<typename I>
+    MeshStatistics Analyze(const I* indices, size_t count, size_t vertexCount, size_t vertexSize)
+    {
+        Detail::Fifo transform(Detail::TRANSFORM_CACHE);
+        Detail::Fifo fetch(Detail::FETCH_LINES);
+        std::vector<bool> used(vertexCount);
+        size_t misses = 0;
+        size_t lines = 0;
+        size_t unique = 0;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const size_t vertex = indices[i];
+            unique += !used[vertex];
+            used[vertex] = true;
+            if (transform.Touch(vertex))
+            {
+                continue;
+            }
+
+            misses += 1;
+            const size_t first = vertex * vertexSize / Detail::FETCH_LINE;
+            const size_t last = ((vertex + 1) * vertexSize - 1) / Detail::FETCH_LINE;
+            for (size_t line = first; line <= last; ++line)
+            {
+                lines += !fetch.Touch(line);
+            }
+        }
+
+        const float triangles = static_cast<float>(count / 3);
+        return MeshStatistics{
+            triangles > 0 ? misses / triangles : 0.0f,
+            unique > 0 ? static_cast<float>(misses) / unique : 0.0f,
+            vertexCount > 0 ? static_cast<float>(lines * Detail::FETCH_LINE) / (vertexCount * vertexSize) : 0.0f,
+        };
+    }
+
+    /// Reorder triangles to reuse recently transformed vertices, using Tom Forsyth's linear-speed greedy algorithm.
+    /// Each step emits the triangle whose vertices score highest, only looking at triangles around vertices in the
+    /// modelled cache, and falls back to the next triangle in the input when none remain there.
+    ///
+    /// @param destination receives the reordered indices and may be the same array as indices.
+    /// @param indices is the triangle list.
+    /// @param count is the number of indices.
+    /// @param vertexCount is the number of vertices the indices refer to.
+    template<typename I>
+    void OptimizeVertexCache(I* destination, const I* indices, size_t count, size_t vertexCount)
+    {
+        const std::vector<I> input(indices, indices + count);
+        const size_t triangles = count / 3;
+
+        // Triangles around each vertex, with the live ones kept at the front of each vertex's range
+        std::vector<uint32_t> remaining(vertexCount);
+        for (const I index : input)
+        {
+            remaining[index] += 1;
+        }
+        std::vector<uint32_t> offsets(vertexCount + 1);
+        std::partial_sum(remaining.begin(), remaining.end(), offsets.begin() + 1);
+        std::vector<uint32_t> adjacency(triangles * 3);
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < triangles * 3; ++i)
+        {
+            adjacency[fill[input[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+
+        std::vector<int> position(vertexCount, -1);
+        std::vector<float> vertexScore(vertexCount);
+        for (size_t v = 0; v < vertexCount; ++v)
+        {
+            vertexScore[v] = Detail::VertexScore(-1, remaining[v]);
+        }
+        std::vector<float> triangleScore(triangles);
+        for (size_t t = 0; t < triangles; ++t)
+        {
+            triangleScore[t] = vertexScore[input[t * 3]] + vertexScore[input[t * 3 + 1]] + vertexScore[input[t * 3 + 2]];
+        }
+
+        std::vector<bool> emitted(triangles);
+        std::vector<uint32_t> cache;
+        std::vector<uint32_t> next;
+        cache.reserve(Detail::FORSYTH_CACHE + 3);
+        next.reserve(Detail::FORSYTH_CACHE + 3);
+        size_t fallback = 0;
+        int64_t best = -1;
+
+        for (size_t out = 0; out < triangles; ++out)
+        {
+            if (best < 0)
+            {
+                while (emitted[fallback])
+                {
+                    fallback += 1;
+                }
+                best = static_cast<int64_t>(fallback);
+            }
+
+            const size_t triangle = static_cast<size_t>(best);
+            emitted[triangle] = true;
+            next.clear();
+            for (size_t corner = 0; corner < 3; ++corner)
+            {
+                const uint32_t vertex = input[triangle * 3 + corner];
+                destination[out * 3 + corner] = static_cast<I>(vertex);
+
+                // Retire the triangle from the vertex's live range
+                uint32_t* begin = adjacency.data() + offsets[vertex];
+                uint32_t* end = begin + remaining[vertex];
+                std::iter_swap(std::find(begin, end, static_cast<uint32_t>(triangle)), end - 1);
+                remaining[vertex] -= 1;
+
+                if (std::find(next.begin(), next.end(), vertex) == next.end())
+                {
+                    next.push_back(vertex);
+                }
+            }
+
+            // The triangle's vertices move to the front of the cache, pushing the rest back and the oldest out
+            for (const uint32_t vertex : cache)
+            {
+                if (std::find(next.begin(), next.end(), vertex) == next.end())
+                {
+                    next.push_back(vertex);
+                }
+            }
+            for (size_t i = 0; i < next.size(); ++i)
+            {
+                position[next[i]] = i < Detail::FORSYTH_CACHE ? static_cast<int>(i) : -1;
+                vertexScore[next[i]] = Detail::VertexScore(position[next[i]], remaining[next[i]]);
+            }
+
+            // Only triangles around vertices whose score changed can have changed score themselves
+            best = -1;
+            float bestScore = -1.0f;
+            for (const uint32_t vertex : next)
+            {
+                for (uint32_t j = offsets[vertex]; j < offsets[vertex] + remaining[vertex]; ++j)
+                {
+                    const uint32_t t = adjacency[j];
+                    const float score = vertexScore[input[t * 3]] + vertexScore[input[t * 3 + 1]] + vertexScore[input[t * 3 + 2]];
+                    triangleScore[t] = score;
+                    if (score > bestScore)
+                    {
+                        best = t;
+                        bestScore = score;
+                    }
+                }
+            }
+
+            next.resize(std::min(next.size(), Detail::FORSYTH_CACHE));
+            cache.swap(next);
+        }
+    }
+
+    /// Reorder clusters of triangles so that those facing away from the middle of the mesh come first, which for
+    /// roughly convex meshes draws occluders before what they hide. Clusters start wherever the cache would have to
+    /// transform all three vertices of a triangle anyway, so moving them around keeps the cache order within them.
+    /// Run it after OptimizeVertexCache.
+    ///
+    /// @param indices is the triangle list, reordered in place.
+    /// @param count is the number of indices.
+    /// @param vertices is the vertex array the indices refer to.
+    /// @param position extracts a Math::Vector3F position from a vertex.
+    template<typename I, typename V, typename P>
+    void OptimizeOverdraw(I* indices, size_t count, const V* vertices, P&& position)
+    {
+        using Math::Vector3F;
+        const size_t triangles = count / 3;
+        if (triangles == 0)
+        {
+            return;
+        }
+
+        Detail::Fifo cache(Detail::TRANSFORM_CACHE);
+        std::vector<size_t> starts;
+        for (size_t t = 0; t < triangles; ++t)
+        {
+            size_t misses = 0;
+            for (size_t corner = 0; corner < 3; ++corner)
+            {
+                misses += !cache.Touch(indices[t * 3 + corner]);
+            }
+            if (t == 0 || misses == 3)
+            {
+                starts.push_back(t);
+            }
+        }
+        starts.push_back(triangles);
+
+        // Area weighted centroids and summed normals; the cross product's length is twice the triangle's area
+        const size_t clusters = starts.size() - 1;
+        std::vector<Vector3F> centroids(clusters);
+        std::vector<Vector3F> normals(clusters);
+        Vector3F middle;
+        float total = 0.0f;
+        for (size_t c = 0; c < clusters; ++c)
+        {
+            float area = 0.0f;
+            for (size_t t = starts[c]; t < starts[c + 1]; ++t)
+            {
+                const Vector3F a = position(vertices[indices[t * 3]]);
+                const Vector3F b = position(vertices[indices[t * 3 + 1]]);
+                const Vector3F d = position(vertices[indices[t * 3 + 2]]);
+                const Vector3F normal = Cross(b - a, d - a);
+                const float weight = normal.Length();
+                centroids[c] += (a + b + d) * (weight / 3.0f);
+                normals[c] += normal;
+                area += weight;
+            }
+            middle += centroids[c];
+            total += area;
+            centroids[c] = area > 0.0f ? centroids[c] / area : centroids[c];
+        }
+        middle = total > 0.0f ? middle / total : middle;
+
+        std::vector<float> keys(clusters);
+        for (size_t c = 0; c < clusters; ++c)
+        {
+            const float length = normals[c].Length();
+            keys[c] = length > 0.0f ? Dot(centroids[c] - middle, normals[c]) / length : 0.0f;
+        }
+
+        std::vector<size_t> order(clusters);
+        std::iota(order.begin(), order.end(), size_t(0));
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b)
+        {
+            return keys[a] > keys[b];
+        });
+
+        const std::vector<I> input(indices, indices + triangles * 3);
+        size_t out = 0;
+        for (const size_t c : order)
+        {
+            for (size_t i = starts[c] * 3; i < starts[c + 1] * 3; ++i)
+            {
+                indices[out++] = input[i];
+            }
+        }
+    }
+
+    /// Reorder vertices into the order the indices first use them, rewriting the indices to match, so that the vertex
+    /// fetches walk through memory. Vertices no index uses are dropped.
+    ///
+    /// @param destination receives the reordered vertices and must not overlap vertices.
+    /// @param indices is the triangle list, rewritten in place.
+    /// @param count is the number of indices.
+    /// @param vertices is the original vertex array.
+    /// @param vertexCount is the number of original vertices.
+    /// @returns the number of vertices written to destination.
+    template<typename V, typename I>
+    size_t OptimizeVertexFetch(V* destination, I* indices, size_t count, const V* vertices, size_t vertexCount)
+    {
+        std::vector<uint32_t> remap(vertexCount, UINT32_MAX);
+        uint32_t next = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            uint32_t& target = remap[indices[i]];
+            if (target == UINT32_MAX)
+            {
+                target = next++;
+                destination[target] = vertices[indices[i]];
+            }
+            indices[i] = static_cast<I>(target);
+        }
+        return next;
+    }
+
+    /// Run the whole pipeline on a mesh before uploading it: cache order, then cluster order for overdraw, then vertex
+    /// order for fetches.
+    ///
+    /// @param vertices is the vertex array, reordered and stripped of unused vertices.
+    /// @param indices is the triangle list, reordered and rewritten.
+    /// @param position extracts a Math::Vector3F position from a vertex.
+    /// @returns the statistics before and after.
+    template<typename V, typename I, typename P>
+    MeshReport Optimize(std::vector<V>& vertices, std::vector<I>& indices, P&& position)
+    {
+        MeshReport report;
+        report.Before = Analyze(indices.data(), indices.size(), vertices.size(), sizeof(V));
+
+        OptimizeVertexCache(indices.data(), indices.data(), indices.size(), vertices.size());
+        OptimizeOverdraw(indices.data(), indices.size(), vertices.data(), position);
+
+        std::vector<V> reordered(vertices.size());
+        reordered.resize(OptimizeVertexFetch(reordered.data(), indices.data(), indices.size(), vertices.data(), vertices.size()));
+        vertices.swap(reordered);
+
+        report.After = Analyze(indices.data(), indices.size(), vertices.size(), sizeof(V));
+        return report;
+    }
+
+    /// Same as above, for vertices with a Position member like SimpleVertex::Structure.
+    template<typename V, typename I>
+    MeshReport Optimize(std::vector<V>& vertices, std::vector<I>& indices)
+    {
+        return Optimize(vertices, indices, [](const V& vertex) { return vertex.Position; });
+    }
+}
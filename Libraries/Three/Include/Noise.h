@@ -0,0 +1,390 @@
+#pragma once
+
+#include "Lanes.h"
+
+#include <cstddef>
+
+namespace Dance::Three::Math::Noise
+{
+    // Coherent noise for procedural visuals, written against the lane types in Lanes.h like FastMath.h so that the
+    // same code evaluates one, four or eight points at a time. Lattice points are hashed with the permutation
+    // polynomial from Gustavson and McEwan's "Efficient computational noise in GLSL", which stays in float
+    // arithmetic and so vectorizes without integer gathers from a permutation table. The pattern repeats every 289
+    // units along each axis. Unlike that paper, the 3D and 4D corners fall off within a squared radius of 0.5 rather
+    // than 0.6, which reaches past the neighboring simplices and leaves small seams where cells meet.
+
+    namespace Detail
+    {
+        /// Offsets of the elements in the widest lane, for stepping across a row.
+        alignas(32) inline constexpr float RAMP[8] = { 0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f };
+
+        /// x modulo 289 in [0, 289) for integral x. The reciprocal can round a multiple of 289 just under the next
+        /// integer, so that case is folded back in.
+        template<typename L>
+        inline L Mod289(L x)
+        {
+            const L reduced = x - Floor(x * L::Broadcast(1.0f / 289.0f)) * L::Broadcast(289.0f);
+            return Select(reduced >= L::Broadcast(289.0f), reduced - L::Broadcast(289.0f), reduced);
+        }
+
+        /// Permute the integers modulo 289 by (34x^2 + x) mod 289. For x below 578, which covers a hash plus a
+        /// reduced coordinate plus one, every intermediate is an integer below 2^24 and so exact in float.
+        template<typename L>
+        inline L Permute(L x)
+        {
+            return Mod289((x * L::Broadcast(34.0f) + L::Broadcast(1.0f)) * x);
+        }
+
+        template<typename L>
+        inline L Fract(L x)
+        {
+            return x - Floor(x);
+        }
+
+        /// First order approximation of 1 / sqrt(r) around the squared length of the unnormalized gradients.
+        template<typename L>
+        inline L InverseSqrt(L r)
+        {
+            return L::Broadcast(1.79284291400159f) - L::Broadcast(0.85373472095314f) * r;
+        }
+
+        /// One where x >= edge and zero elsewhere, GLSL's step.
+        template<typename L>
+        inline L Step(L edge, L x)
+        {
+            return Select(x >= edge, L::Broadcast(1.0f), L::Broadcast(0.0f));
+        }
+
+        /// Contribution of one corner of a 2D simplex, with its gradient picked from 41 directions on a line folded
+        /// into a diamond.
+        template<typename L>
+        inline L Corner(L hash, L x, L y)
+        {
+            const L gx = Fract(hash * L::Broadcast(1.0f / 41.0f)) * L::Broadcast(2.0f) - L::Broadcast(1.0f);
+            const L gy = Abs(gx) - L::Broadcast(0.5f);
+            const L ax = gx - Floor(gx + L::Broadcast(0.5f));
+
+            L m = Max(L::Broadcast(0.5f) - x * x - y * y, L::Broadcast(0.0f));
+            m = m * m;
+            return m * m * InverseSqrt(ax * ax + gy * gy) * (ax * x + gy * y);
+        }
+
+        /// Contribution of one corner of a 3D simplex, with its gradient picked from a 7 by 7 grid on an octahedron.
+        template<typename L>
+        inline L Corner(L hash, L x, L y, L z)
+        {
+            const L j = hash - L::Broadcast(49.0f) * Floor(hash * L::Broadcast(1.0f / 49.0f));
+            const L column = Floor(j * L::Broadcast(1.0f / 7.0f));
+            const L row = Floor(j - L::Broadcast(7.0f) * column);
+            L gx = column * L::Broadcast(2.0f / 7.0f) - L::Broadcast(13.0f / 14.0f);
+            L gy = row * L::Broadcast(2.0f / 7.0f) - L::Broadcast(13.0f / 14.0f);
+            const L gz = L::Broadcast(1.0f) - Abs(gx) - Abs(gy);
+
+            // Fold the points outside the octahedron back over its faces
+            const auto outside = gz <= L::Broadcast(0.0f);
+            gx = Select(outside, gx - (Floor(gx) * L::Broadcast(2.0f) + L::Broadcast(1.0f)), gx);
+            gy = Select(outside, gy - (Floor(gy) * L::Broadcast(2.0f) + L::Broadcast(1.0f)), gy);
+
+            L m = Max(L::Broadcast(0.5f) - x * x - y * y - z * z, L::Broadcast(0.0f));
+            m = m * m;
+            return m * m * InverseSqrt(gx * gx + gy * gy + gz * gz) * (gx * x + gy * y + gz * z);
+        }
+
+        /// Contribution of one corner of a 4D simplex, with its gradient picked from a 7 by 7 by 7 grid on the
+        /// surface of a cross-polytope.
+        template<typename L>
+        inline L Corner(L hash, L x, L y, L z, L w)
+        {
+            const L seven = L::Broadcast(7.0f);
+            const L one = L::Broadcast(1.0f);
+            L gx = Floor(Fract(hash * L::Broadcast(1.0f / 294.0f)) * seven) * L::Broadcast(1.0f / 7.0f) - one;
+            L gy = Floor(Fract(hash * L::Broadcast(1.0f / 49.0f)) * seven) * L::Broadcast(1.0f / 7.0f) - one;
+            L gz = Floor(Fract(hash * L::Broadcast(1.0f / 7.0f)) * seven) * L::Broadcast(1.0f / 7.0f) - one;
+            const L gw = L::Broadcast(1.5f) - Abs(gx) - Abs(gy) - Abs(gz);
+
+            const auto outside = gw < L::Broadcast(0.0f);
+            const L zero = L::Broadcast(0.0f);
+            gx = Select(outside, gx + Select(gx < zero, one, -one), gx);
+            gy = Select(outside, gy + Select(gy < zero, one, -one), gy);
+            gz = Select(outside, gz + Select(gz < zero, one, -one), gz);
+
+            L m = Max(L::Broadcast(0.5f) - x * x - y * y - z * z - w * w, zero);
+            m = m * m;
+            return m * m * InverseSqrt(gx * gx + gy * gy + gz * gz + gw * gw) * (gx * x + gy * y + gz * z + gw * w);
+        }
+
+        /// Value noise in N dimensions: a hash in [-1, 1] at every lattice point, blended across each cell with the
+        /// quintic fade so that the result has continuous first and second derivatives.
+        template<typename L, size_t N>
+        inline L Value(const L (&point)[N])
+        {
+            L cell[N];
+            L fade[N];
+            for (size_t d = 0; d < N; ++d)
+            {
+                const L floor = Floor(point[d]);
+                const L f = point[d] - floor;
+                fade[d] = f * f * f * (f * (f * L::Broadcast(6.0f) - L::Broadcast(15.0f)) + L::Broadcast(10.0f));
+                cell[d] = Mod289(floor);
+            }
+
+            // Each corner's weight is the product of fade or one minus fade along every axis
+            L sum = L::Broadcast(0.0f);
+            for (size_t corner = 0; corner < (size_t(1) << N); ++corner)
+            {
+                L weight = L::Broadcast(1.0f);
+                L hash = L::Broadcast(0.0f);
+                for (size_t d = N; d-- > 0;)
+                {
+                    const bool upper = (corner >> d) & 1;
+                    const L offset = L::Broadcast(upper ? 1.0f : 0.0f);
+                    hash = Permute(hash + cell[d] + offset);
+                    weight = weight * (upper ? fade[d] : L::Broadcast(1.0f) - fade[d]);
+                }
+                sum = sum + weight * hash;
+            }
+            return sum * L::Broadcast(2.0f / 288.0f) - L::Broadcast(1.0f);
+        }
+    }
+
+    /// 2D simplex noise in roughly [-1, 1].
+    template<typename L>
+    inline L Simplex(L x, L y)
+    {
+        using namespace Detail;
+        const L one = L::Broadcast(1.0f);
+        const L g = L::Broadcast(0.211324865405187f);
+
+        // Skew onto the grid of simplices to find the cell, then unskew for the offset from its first corner
+        const L s = (x + y) * L::Broadcast(0.366025403784439f);
+        const L i = Floor(x + s);
+        const L j = Floor(y + s);
+        const L t = (i + j) * g;
+        const L x0 = x - i + t;
+        const L y0 = y - j + t;
+
+        // The middle corner steps along whichever axis the point is further along
+        const L i1 = Step(y0, x0);
+        const L j1 = one - i1;
+        const L x1 = x0 - i1 + g;
+        const L y1 = y0 - j1 + g;
+        const L x2 = x0 - one + g * L::Broadcast(2.0f);
+        const L y2 = y0 - one + g * L::Broadcast(2.0f);
+
+        const L ci = Mod289(i);
+        const L cj = Mod289(j);
+        const L sum
+            = Corner(Permute(Permute(cj) + ci), x0, y0)
+            + Corner(Permute(Permute(cj + j1) + ci + i1), x1, y1)
+            + Corner(Permute(Permute(cj + one) + ci + one), x2, y2);
+        return sum * L::Broadcast(130.0f);
+    }
+
+    /// 3D simplex noise in roughly [-1, 1].
+    template<typename L>
+    inline L Simplex(L x, L y, L z)
+    {
+        using namespace Detail;
+        const L one = L::Broadcast(1.0f);
+        const L g = L::Broadcast(1.0f / 6.0f);
+
+        const L s = (x + y + z) * L::Broadcast(1.0f / 3.0f);
+        const L i = Floor(x + s);
+        const L j = Floor(y + s);
+        const L k = Floor(z + s);
+        const L t = (i + j + k) * g;
+        const L x0 = x - i + t;
+        const L y0 = y - j + t;
+        const L z0 = z - k + t;
+
+        // Order the axes by how far the point is along each, and step along the largest, then the two largest
+        const L gx = Step(y0, x0);
+        const L gy = Step(z0, y0);
+        const L gz = Step(x0, z0);
+        const L i1 = Min(gx, one - gz);
+        const L j1 = Min(gy, one - gx);
+        const L k1 = Min(gz, one - gy);
+        const L i2 = Max(gx, one - gz);
+        const L j2 = Max(gy, one - gx);
+        const L k2 = Max(gz, one - gy);
+
+        const L ci = Mod289(i);
+        const L cj = Mod289(j);
+        const L ck = Mod289(k);
+        const auto hash = [&](L di, L dj, L dk)
+        {
+            return Permute(Permute(Permute(ck + dk) + cj + dj) + ci + di);
+        };
+
+        const L zero = L::Broadcast(0.0f);
+        const L g2 = g * L::Broadcast(2.0f);
+        const L half = L::Broadcast(0.5f);
+        const L sum
+            = Corner(hash(zero, zero, zero), x0, y0, z0)
+            + Corner(hash(i1, j1, k1), x0 - i1 + g, y0 - j1 + g, z0 - k1 + g)
+            + Corner(hash(i2, j2, k2), x0 - i2 + g2, y0 - j2 + g2, z0 - k2 + g2)
+            + Corner(hash(one, one, one), x0 - half, y0 - half, z0 - half);
+        return sum * L::Broadcast(105.0f);
+    }
+
+    /// 4D simplex noise in roughly [-1, 1], for animating 3D noise along the fourth axis without it visibly sliding.
+    template<typename L>
+    inline L Simplex(L x, L y, L z, L w)
+    {
+        using namespace Detail;
+        const L one = L::Broadcast(1.0f);
+        const L g = L::Broadcast(0.138196601125011f);
+
+        const L s = (x + y + z + w) * L::Broadcast(0.309016994374947451f);
+        const L i = Floor(x + s);
+        const L j = Floor(y + s);
+        const L k = Floor(z + s);
+        const L l = Floor(w + s);
+        const L t = (i + j + k + l) * g;
+        const L x0 = x - i + t;
+        const L y0 = y - j + t;
+        const L z0 = z - k + t;
+        const L w0 = w - l + t;
+
+        // Rank each axis by how many others the point is further along; the first step goes along rank three, the
+        // second along ranks two and three and the third along all but rank zero
+        const L xy = Step(y0, x0);
+        const L xz = Step(z0, x0);
+        const L xw = Step(w0, x0);
+        const L yz = Step(z0, y0);
+        const L yw = Step(w0, y0);
+        const L zw = Step(w0, z0);
+        const L rx = xy + xz + xw;
+        const L ry = one - xy + yz + yw;
+        const L rz = (one - xz) + (one - yz) + zw;
+        const L rw = (one - xw) + (one - yw) + (one - zw);
+
+        const L two = L::Broadcast(2.0f);
+        const L three = L::Broadcast(3.0f);
+        const L i1 = Step(three, rx), j1 = Step(three, ry), k1 = Step(three, rz), l1 = Step(three, rw);
+        const L i2 = Step(two, rx), j2 = Step(two, ry), k2 = Step(two, rz), l2 = Step(two, rw);
+        const L i3 = Step(one, rx), j3 = Step(one, ry), k3 = Step(one, rz), l3 = Step(one, rw);
+
+        const L ci = Mod289(i);
+        const L cj = Mod289(j);
+        const L ck = Mod289(k);
+        const L cl = Mod289(l);
+        const auto hash = [&](L di, L dj, L dk, L dl)
+        {
+            return Permute(Permute(Permute(Permute(cl + dl) + ck + dk) + cj + dj) + ci + di);
+        };
+
+        const L zero = L::Broadcast(0.0f);
+        const L g2 = g * two;
+        const L g3 = g * three;
+        const L g4 = g * L::Broadcast(4.0f) - one;
+        const L sum
+            = Corner(hash(zero, zero, zero, zero), x0, y0, z0, w0)
+            + Corner(hash(i1, j1, k1, l1), x0 - i1 + g, y0 - j1 + g, z0 - k1 + g, w0 - l1 + g)
+            + Corner(hash(i2, j2, k2, l2), x0 - i2 + g2, y0 - j2 + g2, z0 - k2 + g2, w0 - l2 + g2)
+            + Corner(hash(i3, j3, k3, l3), x0 - i3 + g3, y0 - j3 + g3, z0 - k3 + g3, w0 - l3 + g3)
+            + Corner(hash(one, one, one, one), x0 + g4, y0 + g4, z0 + g4, w0 + g4);
+        return sum * L::Broadcast(105.0f);
+    }
+
+    /// 2D value noise in [-1, 1]. Cheaper than simplex noise but blockier, with its features lined up on the axes.
+    template<typename L>
+    inline L Value(L x, L y)
+    {
+        const L point[] = { x, y };
+        return Detail::Value(point);
+    }
+
+    /// 3D value noise in [-1, 1].
+    template<typename L>
+    inline L Value(L x, L y, L z)
+    {
+        const L point[] = { x, y, z };
+        return Detail::Value(point);
+    }
+
+    /// 4D value noise in [-1, 1].
+    template<typename L>
+    inline L Value(L x, L y, L z, L w)
+    {
+        const L point[] = { x, y, z, w };
+        return Detail::Value(point);
+    }
+
+    /// How Fractal layers octaves of noise.
+    struct Octaves
+    {
+        /// Number of layers.
+        int count = 5;
+
+        /// Frequency of each layer relative to the one before.
+        float lacunarity = 2.0f;
+
+        /// Amplitude of each layer relative to the one before.
+        float gain = 0.5f;
+    };
+
+    /// Fractal Brownian motion: the sum of octaves of a noise function, each at a higher frequency and lower
+    /// amplitude than the last, normalized by the total amplitude so that it stays in the range of a single octave.
+    ///
+    /// @param octaves configures the layers.
+    /// @param noise is called with the scaled coordinates, for example [](auto... p) { return Simplex(p...); }.
+    /// @param x and the rest are the coordinates.
+    template<typename F, typename L, typename... Ls>
+    inline L Fractal(const Octaves& octaves, F&& noise, L x, Ls... rest)
+    {
+        L sum = L::Broadcast(0.0f);
+        float amplitude = 1.0f;
+        float frequency = 1.0f;
+        float total = 0.0f;
+        for (int octave = 0; octave < octaves.count; ++octave)
+        {
+            const L scale = L::Broadcast(frequency);
+            sum = sum + L::Broadcast(amplitude) * noise(x * scale, (rest * scale)...);
+            total += amplitude;
+            amplitude *= octaves.gain;
+            frequency *= octaves.lacunarity;
+        }
+        return total > 0.0f ? sum * L::Broadcast(1.0f / total) : sum;
+    }
+
+    /// Fractal noise at a single point, for which the noise function is called with Simd::Float1 coordinates.
+    template<typename F, typename... Fs>
+    inline float Fractal(const Octaves& octaves, F&& noise, float x, Fs... rest)
+    {
+        return Fractal(octaves, noise, Simd::Float1(x), Simd::Float1(rest)...).value;
+    }
+
+    /// Evaluate noise over a width by height grid into out, row by row, as many points at a time as the build allows:
+    /// eight with AVX. The point in a column and row is at (x + column * step, y + row * step), and the noise function
+    /// is called with lanes of those coordinates. It can add its own, such as time as a third axis:
+    ///
+    ///     Grid(out, width, height, 0.0f, 0.0f, 0.01f, [&](auto x, auto y)
+    ///     {
+    ///         return Simplex(x, y, decltype(x)::Broadcast(time));
+    ///     });
+    template<typename F>
+    inline void Grid(float* out, size_t width, size_t height, float x, float y, float step, F&& noise)
+    {
+        for (size_t row = 0; row < height; ++row)
+        {
+            float* line = out + row * width;
+            const float py = y + static_cast<float>(row) * step;
+            Simd::Sweep(width, [&](auto lane, size_t i)
+            {
+                using L = decltype(lane);
+                const L px = L::Broadcast(x + static_cast<float>(i) * step) + L::Load(Detail::RAMP) * L::Broadcast(step);
+                noise(px, L::Broadcast(py)).Store(line + i);
+            });
+        }
+    }
+
+    // Plain float overloads, which run the same code one point at a time
+
+    inline float Simplex(float x, float y) { return Simplex(Simd::Float1(x), Simd::Float1(y)).value; }
+    inline float Simplex(float x, float y, float z) { return Simplex(Simd::Float1(x), Simd::Float1(y), Simd::Float1(z)).value; }
+    inline float Simplex(float x, float y, float z, float w) { return Simplex(Simd::Float1(x), Simd::Float1(y), Simd::Float1(z), Simd::Float1(w)).value; }
+    inline float Value(float x, float y) { return Value(Simd::Float1(x), Simd::Float1(y)).value; }
+    inline float Value(float x, float y, float z) { return Value(Simd::Float1(x), Simd::Float1(y), Simd::Float1(z)).value; }
+    inline float Value(float x, float y, float z, float w) { return Value(Simd::Float1(x), Simd::Float1(y), Simd::Float1(z), Simd::Float1(w)).value; }
+}
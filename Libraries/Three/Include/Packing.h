@@ -0,0 +1,150 @@
+#pragma once
+
+#include "Vector3.h"
+#include "Vector4.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace Dance::Three::Math
+{
+    /// Convert a float to the nearest IEEE half precision value, ties to even, the way DXGI_FORMAT_R16_FLOAT reads it.
+    /// Values beyond the half range become infinity, and those below half the smallest subnormal become zero.
+    inline uint16_t ToHalf(float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        const uint32_t sign = (bits >> 16) & 0x8000;
+        const uint32_t magnitude = bits & 0x7FFFFFFF;
+
+        // Infinity and NaN keep their class, with NaNs quieted
+        if (magnitude >= 0x7F800000)
+        {
+            return static_cast<uint16_t>(sign | 0x7C00 | (magnitude > 0x7F800000 ? 0x200 : 0));
+        }
+
+        // Halfway between the largest half, 65504, and the next power of two rounds up to infinity
+        if (magnitude >= 0x477FF000)
+        {
+            return static_cast<uint16_t>(sign | 0x7C00);
+        }
+
+        uint32_t shift = 13;
+        uint32_t mantissa = magnitude - 0x38000000;
+        if (magnitude < 0x38800000)
+        {
+            // Below the smallest normal half, in units of the smallest subnormal, 2^-24
+            shift = 126 - (magnitude >> 23);
+            if (shift > 24)
+            {
+                return static_cast<uint16_t>(sign);
+            }
+            mantissa = (magnitude & 0x7FFFFF) | 0x800000;
+        }
+
+        uint32_t half = mantissa >> shift;
+        const uint32_t remainder = mantissa & ((1u << shift) - 1);
+        const uint32_t halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (half & 1)))
+        {
+            half += 1;
+        }
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    /// Expand a half precision value to a float, which is always exact.
+    inline float FromHalf(uint16_t half)
+    {
+        const uint32_t sign = static_cast<uint32_t>(half & 0x8000) << 16;
+        const uint32_t exponent = (half >> 10) & 0x1F;
+        const uint32_t mantissa = half & 0x3FF;
+
+        uint32_t bits;
+        if (exponent == 0x1F)
+        {
+            bits = sign | 0x7F800000 | (mantissa << 13);
+        }
+        else if (exponent != 0)
+        {
+            bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+        }
+        else
+        {
+            // Zero or subnormal, mantissa * 2^-24, which a float holds exactly
+            const float value = static_cast<float>(mantissa) * 5.9604644775390625e-8f;
+            return sign ? -value : value;
+        }
+
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    /// Convert a float in [-1, 1] to a 16-bit signed normalized integer, the way DXGI_FORMAT_R16_SNORM reads it.
+    inline int16_t ToSnorm16(float value)
+    {
+        const float clamped = value < -1.0f ? -1.0f : value > 1.0f ? 1.0f : value;
+        return static_cast<int16_t>(std::lround(clamped * 32767.0f));
+    }
+
+    /// Expand a 16-bit signed normalized integer to a float. Both -32768 and -32767 are -1.
+    inline float FromSnorm16(int16_t value)
+    {
+        const float scaled = static_cast<float>(value) / 32767.0f;
+        return scaled < -1.0f ? -1.0f : scaled;
+    }
+
+    /// Pack four floats in [0, 1] into bytes, the first in the lowest, the way DXGI_FORMAT_R8G8B8A8_UNORM reads them.
+    inline uint32_t ToUnorm8(const Vector4<float>& value)
+    {
+        const auto byte = [](float channel)
+        {
+            const float clamped = channel < 0.0f ? 0.0f : channel > 1.0f ? 1.0f : channel;
+            return static_cast<uint32_t>(std::lround(clamped * 255.0f));
+        };
+        return byte(value.x) | byte(value.y) << 8 | byte(value.z) << 16 | byte(value.w) << 24;
+    }
+
+    /// Expand four packed bytes to floats in [0, 1].
+    inline Vector4<float> FromUnorm8(uint32_t packed)
+    {
+        return Vector4<float>(
+            static_cast<float>(packed & 0xFF) / 255.0f,
+            static_cast<float>((packed >> 8) & 0xFF) / 255.0f,
+            static_cast<float>((packed >> 16) & 0xFF) / 255.0f,
+            static_cast<float>(packed >> 24) / 255.0f);
+    }
+
+    /// Encode a unit vector in 32 bits by projecting it onto an octahedron and unfolding the octahedron into a square,
+    /// stored as two 16-bit signed normalized coordinates, x in the low half, for DXGI_FORMAT_R16G16_SNORM. The angular
+    /// error stays under a hundredth of a degree, and the shader undoes it in a few instructions.
+    ///
+    /// @param normal should have unit length.
+    inline uint32_t ToOctahedral(const Vector3<float>& normal)
+    {
+        const float sum = std::fabs(normal.x) + std::fabs(normal.y) + std::fabs(normal.z);
+        float x = normal.x / sum;
+        float y = normal.y / sum;
+
+        // Fold the lower hemisphere over the diagonals onto the corners of the square
+        if (normal.z < 0.0f)
+        {
+            const float folded = (1.0f - std::fabs(y)) * (x < 0.0f ? -1.0f : 1.0f);
+            y = (1.0f - std::fabs(x)) * (y < 0.0f ? -1.0f : 1.0f);
+            x = folded;
+        }
+
+        return static_cast<uint16_t>(ToSnorm16(x)) | static_cast<uint32_t>(static_cast<uint16_t>(ToSnorm16(y))) << 16;
+    }
+
+    /// Decode a unit vector packed by ToOctahedral.
+    inline Vector3<float> FromOctahedral(uint32_t packed)
+    {
+        const float x = FromSnorm16(static_cast<int16_t>(packed & 0xFFFF));
+        const float y = FromSnorm16(static_cast<int16_t>(packed >> 16));
+        const float z = 1.0f - std::fabs(x) - std::fabs(y);
+        const float t = z < 0.0f ? -z : 0.0f;
+        return Vector3<float>(x + (x < 0.0f ? t : -t), y + (y < 0.0f ? t : -t), z).Normalized();
+    }
+}
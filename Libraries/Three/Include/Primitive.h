@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Vector3.h"
+#include "Matrix4.h"
 
 namespace Dance::Three::Graphics
 {
@@ -16,7 +17,7 @@ namespace Dance::Three::Graphics
         T a;
 
         /// Default construct as black with opacity 1.
-        Color4() : r(0), g(0), b(0), a(1) {}
+        constexpr Color4() : r(0), g(0), b(0), a(1) {}
 
         /// Construct exact color, optional opacity defaults to 1.
         /// 
@@ -24,7 +25,7 @@ namespace Dance::Three::Graphics
         /// @param g is the green value.
         /// @param b is the blue value.
         /// @param a is the transparency value.
-        Color4(T r, T g, T b, T a = static_cast<T>(1)) : r(r), g(g), b(b), a(a) {}
+        constexpr Color4(T r, T g, T b, T a = static_cast<T>(1)) : r(r), g(g), b(b), a(a) {}
     };
 
     /// Float color is what we'll use by default.
@@ -51,4 +52,28 @@ namespace Dance::Three::Graphics
             { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT,		 0, offsetof(Structure, UV),       D3D11_INPUT_PER_VERTEX_DATA, 0 },
         };
     }
+
+    namespace InstancedVertex
+    {
+        /// Per-instance data read alongside each SimpleVertex::Structure by an instanced draw.
+        struct Instance
+        {
+            Dance::Three::Math::Matrix4F Transform;
+            Color4F Color;
+        };
+
+        /// SimpleVertex's elements from input slot 0 followed by the instance data from slot 1, which advances once per
+        /// instance. The transform is passed as four rows since an element can be at most four floats wide.
+        const static D3D11_INPUT_ELEMENT_DESC LAYOUT[] = {
+            { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT,    0, offsetof(SimpleVertex::Structure, Position), D3D11_INPUT_PER_VERTEX_DATA,   0 },
+            { "NORMAL",   0, DXGI_FORMAT_R32G32B32_FLOAT,    0, offsetof(SimpleVertex::Structure, Normal),   D3D11_INPUT_PER_VERTEX_DATA,   0 },
+            { "COLOR",    0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, offsetof(SimpleVertex::Structure, Color),    D3D11_INPUT_PER_VERTEX_DATA,   0 },
+            { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT,       0, offsetof(SimpleVertex::Structure, UV),       D3D11_INPUT_PER_VERTEX_DATA,   0 },
+            { "WORLD",    0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, offsetof(Instance, Transform) + 0,           D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+            { "WORLD",    1, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, offsetof(Instance, Transform) + 16,          D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+            { "WORLD",    2, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, offsetof(Instance, Transform) + 32,          D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+            { "WORLD",    3, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, offsetof(Instance, Transform) + 48,          D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+            { "COLOR",    1, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, offsetof(Instance, Color),                   D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+        };
+    }
 }
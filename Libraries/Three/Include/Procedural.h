@@ -0,0 +1,504 @@
+#pragma once
+
+#include "Vector3.h"
+#include "FastMath.h"
+#include "Utility.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace Dance::Three::Graphics
+{
+    // Runtime counterparts to the generators in Geometry.h, for meshes whose size or shape is only known while
+    // running, or that change every frame. Each generator has a matching *Size function giving the number of vertices
+    // and indices it writes, so that storage can be set aside once, whether a std::vector or a MappedSpan from a
+    // streaming buffer, and refilled without allocating.
+    //
+    // Generators fill in a vertex type V with Position and Normal members convertible from Math::Vector3F and a
+    // float UV[2], such as SimpleVertex::Structure. Every other member is copied from a prototype vertex. Triangles
+    // wind clockwise seen from the side the normals point to, as in Geometry.h.
+
+    /// Numbers of vertices and indices in a generated mesh.
+    struct MeshSize
+    {
+        size_t Vertices;
+        size_t Indices;
+    };
+
+    /// Check whether index type I can address every vertex of a mesh.
+    template<typename I>
+    constexpr bool Addresses(const MeshSize& size)
+    {
+        return size.Vertices <= static_cast<size_t>(std::numeric_limits<I>::max()) + 1;
+    }
+
+    /// Call a function with a value of the narrowest index type that addresses every vertex of a mesh, uint16_t where
+    /// possible and uint32_t otherwise. Paired with a generic lambda, the type picks the generator's I and the buffer's
+    /// I, whose format follows from it through INDEX_FORMAT:
+    ///
+    ///     WithIndexType(TorusSize(64, 32), [&](auto index) { using I = decltype(index); ... });
+    ///
+    /// @param size is the size of the mesh about to be generated.
+    /// @param function is called once and must return the same type for either index type.
+    template<typename F>
+    decltype(auto) WithIndexType(const MeshSize& size, F&& function)
+    {
+        if (Addresses<uint16_t>(size))
+        {
+            return function(uint16_t{});
+        }
+        return function(uint32_t{});
+    }
+
+    namespace Detail
+    {
+        /// Write a vertex from the prototype.
+        template<typename V>
+        void Emit(V& vertex, const V& prototype, const Math::Vector3F& position, const Math::Vector3F& normal, float s, float t)
+        {
+            vertex = prototype;
+            vertex.Position = position;
+            vertex.Normal = normal;
+            vertex.UV[0] = s;
+            vertex.UV[1] = t;
+        }
+
+        /// Write the triangles between two rows of a grid of vertices, where a to b steps along the rows and a to c
+        /// steps along the columns, so that the normal points along Cross(c - a, b - a).
+        ///
+        /// @param first skips the triangle touching a and c, for a row that collapses to a point there.
+        /// @param second skips the triangle touching b and d, likewise.
+        template<typename I>
+        I* Quad(I* out, size_t a, size_t b, size_t c, size_t d, bool first = true, bool second = true)
+        {
+            if (first)
+            {
+                *out++ = static_cast<I>(a);
+                *out++ = static_cast<I>(c);
+                *out++ = static_cast<I>(b);
+            }
+            if (second)
+            {
+                *out++ = static_cast<I>(c);
+                *out++ = static_cast<I>(d);
+                *out++ = static_cast<I>(b);
+            }
+            return out;
+        }
+
+        /// Reverse the winding of every triangle written so far, for meshes seen from inside.
+        template<typename I>
+        void Flip(I* indices, size_t count)
+        {
+            for (size_t i = 0; i + 2 < count; i += 3)
+            {
+                const I swap = indices[i + 1];
+                indices[i + 1] = indices[i + 2];
+                indices[i + 2] = swap;
+            }
+        }
+    }
+
+    /// Size of an Icosphere.
+    inline MeshSize IcosphereSize(size_t frequency)
+    {
+        return MeshSize{ 20 * (frequency + 1) * (frequency + 2) / 2, 20 * frequency * frequency * 3 };
+    }
+
+    /// A sphere made by splitting each face of an icosahedron into frequency by frequency triangles and pushing the
+    /// vertices out to the radius. Rounder for its triangle count than SphereMesh's octahedron. Faces don't share
+    /// vertices, and their texture coordinates span each face.
+    ///
+    /// @param vertices receives IcosphereSize(frequency).Vertices vertices.
+    /// @param indices receives IcosphereSize(frequency).Indices indices.
+    /// @param frequency is the number of subdivisions along each icosahedron edge, at least one.
+    /// @param radius is the radius of the sphere.
+    /// @param prototype provides every member other than the position, normal and texture coordinates.
+    /// @returns the size written, or nothing if I can't address the vertices.
+    template<typename V, typename I>
+    MeshSize Icosphere(V* vertices, I* indices, size_t frequency, float radius = 1.0f, const V& prototype = V{})
+    {
+        using Math::Vector3F;
+        const MeshSize size = IcosphereSize(frequency);
+        if (!Addresses<I>(size))
+        {
+            return MeshSize{};
+        }
+
+        // Three rectangles in the golden ratio, one in each axis plane
+        const float g = 1.6180339887f;
+        const Vector3F corners[12] =
+        {
+            Vector3F(-1.0f, g, 0.0f), Vector3F(1.0f, g, 0.0f), Vector3F(-1.0f, -g, 0.0f), Vector3F(1.0f, -g, 0.0f),
+            Vector3F(0.0f, -1.0f, g), Vector3F(0.0f, 1.0f, g), Vector3F(0.0f, -1.0f, -g), Vector3F(0.0f, 1.0f, -g),
+            Vector3F(g, 0.0f, -1.0f), Vector3F(g, 0.0f, 1.0f), Vector3F(-g, 0.0f, -1.0f), Vector3F(-g, 0.0f, 1.0f),
+        };
+        const uint8_t faces[20][3] =
+        {
+            { 0, 11, 5 }, { 0, 5, 1 }, { 0, 1, 7 }, { 0, 7, 10 }, { 0, 10, 11 },
+            { 1, 5, 9 }, { 5, 11, 4 }, { 11, 10, 2 }, { 10, 7, 6 }, { 7, 1, 8 },
+            { 3, 9, 4 }, { 3, 4, 2 }, { 3, 2, 6 }, { 3, 6, 8 }, { 3, 8, 9 },
+            { 4, 9, 5 }, { 2, 4, 11 }, { 6, 2, 10 }, { 8, 6, 7 }, { 9, 8, 1 },
+        };
+
+        const size_t perFace = (frequency + 1) * (frequency + 2) / 2;
+        I* out = indices;
+        for (size_t f = 0; f < 20; ++f)
+        {
+            const Vector3F& a = corners[faces[f][0]];
+            Vector3F b = corners[faces[f][1]];
+            Vector3F c = corners[faces[f][2]];
+            if (!(Dot(Cross(b - a, c - a), a + b + c) > 0.0f))
+            {
+                const Vector3F swap = b;
+                b = c;
+                c = swap;
+            }
+
+            // Row i steps from a toward b and column j from a toward c, with i + j <= frequency
+            const size_t base = f * perFace;
+            const auto at = [base, frequency](size_t i, size_t j)
+            {
+                return base + i * (frequency + 1) - i * (i - (i > 0 ? 1 : 0)) / 2 + j;
+            };
+
+            for (size_t i = 0; i <= frequency; ++i)
+            {
+                for (size_t j = 0; i + j <= frequency; ++j)
+                {
+                    const float s = static_cast<float>(i) / frequency;
+                    const float t = static_cast<float>(j) / frequency;
+                    const Vector3F normal = (a + (b - a) * s + (c - a) * t).Normalized();
+                    Detail::Emit(vertices[at(i, j)], prototype, normal * radius, normal, s, t);
+                }
+            }
+
+            for (size_t i = 0; i < frequency; ++i)
+            {
+                for (size_t j = 0; i + j < frequency; ++j)
+                {
+                    *out++ = static_cast<I>(at(i, j));
+                    *out++ = static_cast<I>(at(i + 1, j));
+                    *out++ = static_cast<I>(at(i, j + 1));
+                    if (i + j + 1 < frequency)
+                    {
+                        *out++ = static_cast<I>(at(i + 1, j));
+                        *out++ = static_cast<I>(at(i + 1, j + 1));
+                        *out++ = static_cast<I>(at(i, j + 1));
+                    }
+                }
+            }
+        }
+        return size;
+    }
+
+    /// Size of a UVSphere.
+    inline MeshSize UVSphereSize(size_t rings, size_t segments)
+    {
+        return MeshSize{ (rings + 1) * (segments + 1), (rings - 1) * segments * 6 };
+    }
+
+    /// A sphere of rings of latitude from +Y down to -Y, split into segments of longitude. Texture coordinates run
+    /// around the equator and down from the top once, with the seam duplicated so they can.
+    ///
+    /// @param vertices receives UVSphereSize(rings, segments).Vertices vertices.
+    /// @param indices receives UVSphereSize(rings, segments).Indices indices.
+    /// @param rings is the number of bands of latitude, at least two.
+    /// @param segments is the number of slices of longitude, at least three.
+    /// @param radius is the radius of the sphere.
+    /// @param prototype provides every member other than the position, normal and texture coordinates.
+    /// @returns the size written, or nothing if I can't address the vertices.
+    template<typename V, typename I>
+    MeshSize UVSphere(V* vertices, I* indices, size_t rings, size_t segments, float radius = 1.0f, const V& prototype = V{})
+    {
+        using Math::Vector3F;
+        const MeshSize size = UVSphereSize(rings, segments);
+        if (!Addresses<I>(size))
+        {
+            return MeshSize{};
+        }
+
+        for (size_t r = 0; r <= rings; ++r)
+        {
+            const float t = static_cast<float>(r) / rings;
+            float sinTheta = 0.0f;
+            float cosTheta = 0.0f;
+            Math::Fast::SinCos(Math::Pi * t, sinTheta, cosTheta);
+            for (size_t k = 0; k <= segments; ++k)
+            {
+                const float s = static_cast<float>(k) / segments;
+                float sinPhi = 0.0f;
+                float cosPhi = 0.0f;
+                Math::Fast::SinCos(Math::TwoPi * s, sinPhi, cosPhi);
+                const Vector3F normal(sinTheta * cosPhi, cosTheta, sinTheta * sinPhi);
+                Detail::Emit(vertices[r * (segments + 1) + k], prototype, normal * radius, normal, s, t);
+            }
+        }
+
+        // The first and last rings are points, so their quads are single triangles
+        I* out = indices;
+        for (size_t r = 0; r < rings; ++r)
+        {
+            for (size_t k = 0; k < segments; ++k)
+            {
+                const size_t a = r * (segments + 1) + k;
+                out = Detail::Quad(out, a, a + segments + 1, a + 1, a + segments + 2, r > 0, r + 1 < rings);
+            }
+        }
+        return size;
+    }
+
+    /// Size of a Torus.
+    inline MeshSize TorusSize(size_t segments, size_t sides)
+    {
+        return MeshSize{ (segments + 1) * (sides + 1), segments * sides * 6 };
+    }
+
+    /// A torus around the Y axis. Texture coordinates run once around the ring and once around the tube.
+    ///
+    /// @param vertices receives TorusSize(segments, sides).Vertices vertices.
+    /// @param indices receives TorusSize(segments, sides).Indices indices.
+    /// @param segments is the number of steps around the ring, at least three.
+    /// @param sides is the number of steps around the tube, at least three.
+    /// @param major is the distance from the center to the middle of the tube.
+    /// @param minor is the radius of the tube.
+    /// @param prototype provides every member other than the position, normal and texture coordinates.
+    /// @returns the size written, or nothing if I can't address the vertices.
+    template<typename V, typename I>
+    MeshSize Torus(V* vertices, I* indices, size_t segments, size_t sides, float major = 1.0f, float minor = 0.25f, const V& prototype = V{})
+    {
+        using Math::Vector3F;
+        const MeshSize size = TorusSize(segments, sides);
+        if (!Addresses<I>(size))
+        {
+            return MeshSize{};
+        }
+
+        for (size_t k = 0; k <= segments; ++k)
+        {
+            const float s = static_cast<float>(k) / segments;
+            float sinU = 0.0f;
+            float cosU = 0.0f;
+            Math::Fast::SinCos(Math::TwoPi * s, sinU, cosU);
+            const Vector3F center(cosU * major, 0.0f, sinU * major);
+            for (size_t j = 0; j <= sides; ++j)
+            {
+                const float t = static_cast<float>(j) / sides;
+                float sinV = 0.0f;
+                float cosV = 0.0f;
+                Math::Fast::SinCos(Math::TwoPi * t, sinV, cosV);
+                const Vector3F normal(cosV * cosU, sinV, cosV * sinU);
+                Detail::Emit(vertices[k * (sides + 1) + j], prototype, center + normal * minor, normal, s, t);
+            }
+        }
+
+        I* out = indices;
+        for (size_t k = 0; k < segments; ++k)
+        {
+            for (size_t j = 0; j < sides; ++j)
+            {
+                const size_t a = k * (sides + 1) + j;
+                out = Detail::Quad(out, a, a + sides + 1, a + 1, a + sides + 2);
+            }
+        }
+        return size;
+    }
+
+    /// Size of a Tube.
+    inline MeshSize TubeSize(size_t points, size_t samples, size_t sides)
+    {
+        const size_t rings = (points - 1) * samples + 1;
+        return MeshSize{ rings * (sides + 1), (rings - 1) * sides * 6 };
+    }
+
+    /// An open tube swept along a Catmull-Rom spline through a list of points, such as a tunnel. The cross section is
+    /// carried along by projecting the previous ring's orientation onto each new one, so it doesn't twist where the
+    /// spline turns. Texture coordinates run around the tube and once along it.
+    ///
+    /// @param vertices receives TubeSize(count, samples, sides).Vertices vertices.
+    /// @param indices receives TubeSize(count, samples, sides).Indices indices.
+    /// @param points are the points the spline passes through, no two consecutive ones the same.
+    /// @param count is the number of points, at least two.
+    /// @param samples is the number of rings between consecutive points, at least one.
+    /// @param sides is the number of steps around the tube, at least three.
+    /// @param radius is the radius of the tube.
+    /// @param inside faces the triangles and normals inward, for a camera inside the tube.
+    /// @param prototype provides every member other than the position, normal and texture coordinates.
+    /// @returns the size written, or nothing if I can't address the vertices.
+    template<typename V, typename I>
+    MeshSize Tube
+    (
+        V* vertices,
+        I* indices,
+        const Math::Vector3F* points,
+        size_t count,
+        size_t samples,
+        size_t sides,
+        float radius = 1.0f,
+        bool inside = false,
+        const V& prototype = V{}
+    )
+    {
+        using Math::Vector3F;
+        const MeshSize size = TubeSize(count, samples, sides);
+        if (!Addresses<I>(size))
+        {
+            return MeshSize{};
+        }
+
+        const size_t rings = (count - 1) * samples + 1;
+        Vector3F normal;
+        for (size_t r = 0; r < rings; ++r)
+        {
+            // The span this ring lies on, with the points past either end repeated
+            const size_t span = r / samples < count - 1 ? r / samples : count - 2;
+            const float u = static_cast<float>(r - span * samples) / samples;
+            const Vector3F& p0 = points[span > 0 ? span - 1 : 0];
+            const Vector3F& p1 = points[span];
+            const Vector3F& p2 = points[span + 1];
+            const Vector3F& p3 = points[span + 2 < count ? span + 2 : count - 1];
+
+            const Vector3F b = p2 - p0;
+            const Vector3F c = p0 * 2.0f - p1 * 5.0f + p2 * 4.0f - p3;
+            const Vector3F d = (p1 - p2) * 3.0f + p3 - p0;
+            const Vector3F center = p1 + (b + (c + d * u) * u) * (0.5f * u);
+            const Vector3F tangent = (b + (c * 2.0f + d * (3.0f * u)) * u).Normalized();
+
+            // Start from whichever axis is least along the tangent, then carry the previous normal along
+            if (r == 0)
+            {
+                const Vector3F absolute(std::fabs(tangent.x), std::fabs(tangent.y), std::fabs(tangent.z));
+                normal = absolute.x <= absolute.y && absolute.x <= absolute.z
+                    ? Vector3F(1.0f, 0.0f, 0.0f)
+                    : absolute.y <= absolute.z ? Vector3F(0.0f, 1.0f, 0.0f) : Vector3F(0.0f, 0.0f, 1.0f);
+            }
+            normal = (normal - tangent * Dot(normal, tangent)).Normalized();
+            const Vector3F binormal = Cross(tangent, normal);
+
+            const float t = static_cast<float>(r) / (rings - 1);
+            for (size_t j = 0; j <= sides; ++j)
+            {
+                const float s = static_cast<float>(j) / sides;
+                float sine = 0.0f;
+                float cosine = 0.0f;
+                Math::Fast::SinCos(Math::TwoPi * s, sine, cosine);
+                const Vector3F direction = normal * cosine + binormal * sine;
+                Detail::Emit(vertices[r * (sides + 1) + j], prototype, center + direction * radius, inside ? direction * -1.0f : direction, s, t);
+            }
+        }
+
+        I* out = indices;
+        for (size_t r = 0; r + 1 < rings; ++r)
+        {
+            for (size_t j = 0; j < sides; ++j)
+            {
+                const size_t a = r * (sides + 1) + j;
+                out = Detail::Quad(out, a, a + sides + 1, a + 1, a + sides + 2);
+            }
+        }
+        if (inside)
+        {
+            Detail::Flip(indices, size.Indices);
+        }
+        return size;
+    }
+
+    /// Size of a Heightfield.
+    inline MeshSize HeightfieldSize(size_t columns, size_t rows)
+    {
+        return MeshSize{ (columns + 1) * (rows + 1), columns * rows * 6 };
+    }
+
+    /// A grid in the XZ plane centered on the origin, like GridMesh, with each vertex raised to a height given by a
+    /// function and normals following the surface. Texture coordinates span the whole grid once.
+    ///
+    /// @param vertices receives HeightfieldSize(columns, rows).Vertices vertices.
+    /// @param indices receives HeightfieldSize(columns, rows).Indices indices.
+    /// @param columns is the number of cells along X.
+    /// @param rows is the number of cells along Z.
+    /// @param width is the length along X.
+    /// @param depth is the length along Z.
+    /// @param height is called as height(s, t) with s and t from zero to one across X and Z, and returns the Y of
+    /// that point.
+    /// @param prototype provides every member other than the position, normal and texture coordinates.
+    /// @returns the size written, or nothing if I can't address the vertices.
+    template<typename V, typename I, typename F>
+    MeshSize Heightfield(V* vertices, I* indices, size_t columns, size_t rows, float width, float depth, F&& height, const V& prototype = V{})
+    {
+        using Math::Vector3F;
+        const MeshSize size = HeightfieldSize(columns, rows);
+        if (!Addresses<I>(size))
+        {
+            return MeshSize{};
+        }
+
+        for (size_t i = 0; i <= columns; ++i)
+        {
+            for (size_t j = 0; j <= rows; ++j)
+            {
+                const float s = static_cast<float>(i) / columns;
+                const float t = static_cast<float>(j) / rows;
+                const Vector3F position((s - 0.5f) * width, height(s, t), (t - 0.5f) * depth);
+                Detail::Emit(vertices[i * (rows + 1) + j], prototype, position, Vector3F(0.0f, 1.0f, 0.0f), s, t);
+            }
+        }
+
+        // Central differences between neighbors, one-sided along the edges
+        for (size_t i = 0; i <= columns; ++i)
+        {
+            for (size_t j = 0; j <= rows; ++j)
+            {
+                const Vector3F& left = vertices[(i > 0 ? i - 1 : i) * (rows + 1) + j].Position;
+                const Vector3F& right = vertices[(i < columns ? i + 1 : i) * (rows + 1) + j].Position;
+                const Vector3F& front = vertices[i * (rows + 1) + (j > 0 ? j - 1 : j)].Position;
+                const Vector3F& back = vertices[i * (rows + 1) + (j < rows ? j + 1 : j)].Position;
+                vertices[i * (rows + 1) + j].Normal = Cross(back - front, right - left).Normalized();
+            }
+        }
+
+        I* out = indices;
+        for (size_t i = 0; i < columns; ++i)
+        {
+            for (size_t j = 0; j < rows; ++j)
+            {
+                const size_t a = i * (rows + 1) + j;
+                out = Detail::Quad(out, a, a + rows + 1, a + 1, a + rows + 2);
+            }
+        }
+        return size;
+    }
+
+    /// Check that every index addresses a vertex.
+    template<typename I>
+    bool IndicesInRange(const I* indices, size_t count, size_t vertexCount)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (static_cast<size_t>(indices[i]) >= vertexCount)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// Check that every triangle winds clockwise seen from the side its vertex normals point to.
+    template<typename V, typename I>
+    bool FacesOutward(const V* vertices, const I* indices, size_t count)
+    {
+        for (size_t i = 0; i + 2 < count; i += 3)
+        {
+            const V& a = vertices[indices[i]];
+            const V& b = vertices[indices[i + 1]];
+            const V& c = vertices[indices[i + 2]];
+            const Math::Vector3F normal = a.Normal + b.Normal + c.Normal;
+            if (!(Dot(Cross(b.Position - a.Position, c.Position - a.Position), normal) > 0.0f))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
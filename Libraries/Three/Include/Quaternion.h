@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Vector3.h"
+#include "Vector4.h"
+#include "FastMath.h"
 
 namespace Dance::Three::Math
 {
@@ -13,49 +15,50 @@ namespace Dance::Three::Math
         T z;
         T w;
 
-        Quaternion() : x(0), y(0), z(0), w(1) {}
-        explicit Quaternion(T x, T y, T z, T w) : x(x), y(y), z(z), w(w) {}
+        constexpr Quaternion() : x(0), y(0), z(0), w(1) {}
+        explicit constexpr Quaternion(T x, T y, T z, T w) : x(x), y(y), z(z), w(w) {}
 
         // Construct the quaternion from an axis and angle
         // It is assumed that axis is already normalized,
         // and the angle is in radians
-        explicit Quaternion(const Vector3<T>& axis, T angle)
+        explicit constexpr Quaternion(const Vector3<T>& axis, T angle)
+            : x(0), y(0), z(0), w(1)
         {
-            T scalar = std::sin(angle / static_cast<T>(2));
+            T scalar = 0;
+            Fast::SinCos(angle / static_cast<T>(2), scalar, this->w);
             this->x = axis.x * scalar;
             this->y = axis.y * scalar;
             this->z = axis.z * scalar;
-            this->w = std::cos(angle / static_cast<T>(2));
         }
 
-        Vector3<T> Three() const
+        constexpr Vector3<T> Three() const
         {
             return Vector3<T>(this->x, this->y, this->z);
         }
 
-        Vector4<T> Four() const
+        constexpr Vector4<T> Four() const
         {
             return Vector4<T>(this->x, this->y, this->z, this->w);
         }
 
-        void Conjugate()
+        constexpr void Conjugate()
         {
             this->x *= static_cast<T>(-1);
             this->y *= static_cast<T>(-1);
             this->z *= static_cast<T>(-1);
         }
 
-        T Magnitude() const
+        constexpr T Magnitude() const
         {
             return this->x * this->x + this->y * this->y + this->z * this->z + this->w * this->w;
         }
 
-        T Length() const
+        constexpr T Length() const
         {
-            return std::sqrt(this->Magnitude());
+            return Math::Sqrt(this->Magnitude());
         }
 
-        void Normalize()
+        constexpr void Normalize()
         {
             T length = this->Length();
             this->x /= length;
@@ -64,14 +67,14 @@ namespace Dance::Three::Math
             this->w /= length;
         }
 
-        Quaternion Normalized() const
+        constexpr Quaternion Normalized() const
         {
             Quaternion result(*this);
             result.Normalize();
             return result;
         }
 
-        friend Quaternion Lerp(const Quaternion& a, const Quaternion& b, T f)
+        friend constexpr Quaternion Lerp(const Quaternion& a, const Quaternion& b, T f)
         {
             const T dot = a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
             const T bias = dot >= static_cast<T>(0) ? static_cast<T>(-1) : static_cast<T>(1);
@@ -132,7 +135,7 @@ namespace Dance::Three::Math
 
         // Concatenate
         // Rotate by q FOLLOWED BY p
-        friend Quaternion Concatenate(const Quaternion& q, const Quaternion& p)
+        friend constexpr Quaternion Concatenate(const Quaternion& q, const Quaternion& p)
         {
             Quaternion retVal;
 
@@ -153,12 +156,11 @@ namespace Dance::Three::Math
         }
 
         // Dot product between two quaternions
-        friend T Dot(const Quaternion& a, const Quaternion& b)
+        friend constexpr T Dot(const Quaternion& a, const Quaternion& b)
         {
             return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
         }
 
-        template<typename T>
         static constexpr Quaternion Identity()
         {
             return Quaternion(0, 0, 0, 1);
@@ -0,0 +1,586 @@
+#pragma once
+
+#include "Lanes.h"
+#include "Packing.h"
+#include "Vector4.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace Dance::Three::Graphics
+{
+    /// Pack a color with channels in [0, 1] as B8G8R8A8, the layout of the swap chain's back buffer.
+    inline uint32_t ToBgra8(const Math::Vector4F& color)
+    {
+        return Math::ToUnorm8(Math::Vector4F(color.z, color.y, color.x, color.w));
+    }
+
+    /// Color and depth targets in memory, laid out like the ones ThreeVisualizer renders to: B8G8R8A8 color and depth
+    /// from 0 at the near plane to 1 at the far plane, row by row from the top left.
+    class Framebuffer
+    {
+    public:
+        /// Allocate both targets, cleared to transparent black and the far plane.
+        ///
+        /// @param width is the width in pixels.
+        /// @param height is the height in pixels.
+        explicit Framebuffer(uint32_t width = 0, uint32_t height = 0)
+            : width(width)
+            , height(height)
+            , colors(static_cast<size_t>(width) * height, 0)
+            , depths(static_cast<size_t>(width) * height, 1.0f)
+        {}
+
+        uint32_t Width() const
+        {
+            return this->width;
+        }
+
+        uint32_t Height() const
+        {
+            return this->height;
+        }
+
+        /// Fill both targets, like ClearRenderTargetView and ClearDepthStencilView.
+        void Clear(const Math::Vector4F& color, float depth = 1.0f)
+        {
+            std::fill(this->colors.begin(), this->colors.end(), ToBgra8(color));
+            std::fill(this->depths.begin(), this->depths.end(), depth);
+        }
+
+        /// Get the packed color of a pixel.
+        uint32_t Color(uint32_t x, uint32_t y) const
+        {
+            return this->colors[static_cast<size_t>(y) * this->width + x];
+        }
+
+        /// Get the depth of a pixel.
+        float Depth(uint32_t x, uint32_t y) const
+        {
+            return this->depths[static_cast<size_t>(y) * this->width + x];
+        }
+
+        /// Get the color target, width pixels per row.
+        uint32_t* Colors()
+        {
+            return this->colors.data();
+        }
+
+        const uint32_t* Colors() const
+        {
+            return this->colors.data();
+        }
+
+        /// Get the depth target, width values per row.
+        float* Depths()
+        {
+            return this->depths.data();
+        }
+
+        const float* Depths() const
+        {
+            return this->depths.data();
+        }
+
+        /// Count the pixels whose color differs from another framebuffer's by more than a tolerance in any channel,
+        /// for comparing against a golden image that may have been rendered with slightly different rounding.
+        ///
+        /// @param other must have the same size.
+        /// @param tolerance is the largest difference per 8-bit channel that still counts as equal.
+        size_t Differences(const Framebuffer& other, uint32_t tolerance = 0) const
+        {
+            size_t count = 0;
+            for (size_t i = 0; i < this->colors.size(); ++i)
+            {
+                for (uint32_t shift = 0; shift < 32; shift += 8)
+                {
+                    const int a = static_cast<int>((this->colors[i] >> shift) & 0xFF);
+                    const int b = static_cast<int>((other.colors[i] >> shift) & 0xFF);
+                    if (static_cast<uint32_t>(a > b ? a - b : b - a) > tolerance)
+                    {
+                        count += 1;
+                        break;
+                    }
+                }
+            }
+            return count;
+        }
+
+        /// Hash the color target with 64-bit FNV-1a, for golden images kept as a single number.
+        uint64_t Hash() const
+        {
+            uint64_t hash = 14695981039346656037ull;
+            for (const uint32_t color : this->colors)
+            {
+                for (uint32_t shift = 0; shift < 32; shift += 8)
+                {
+                    hash = (hash ^ ((color >> shift) & 0xFF)) * 1099511628211ull;
+                }
+            }
+            return hash;
+        }
+
+    private:
+        uint32_t width;
+        uint32_t height;
+        std::vector<uint32_t> colors;
+        std::vector<float> depths;
+    };
+
+    /// What a vertex stage returns: the clip space position, like SV_POSITION, and N floats to interpolate across each
+    /// triangle for the pixel stage, like the rest of a vertex shader's outputs.
+    template<size_t N>
+    struct RasterVertex
+    {
+        Math::Vector4F Position;
+        std::array<float, N> Varyings;
+    };
+
+    /// Draws indexed triangle lists into a Framebuffer on the CPU, with the pipeline state ThreeVisualizer sets up:
+    /// clockwise front faces with back faces culled, and a less-than depth test that writes depth. Shaders are plain
+    /// C++ callables, so a plugin's HLSL can be mirrored and its output checked pixel for pixel without a GPU.
+    ///
+    /// A draw runs in three parallel passes. Vertices are shaded once each. Triangles are then clipped against the
+    /// near plane and guard band, culled, set up and sorted into bins by the TILE by TILE screen tiles they overlap,
+    /// each thread working on its own run of triangles. Finally threads take whole tiles at a time and rasterize the
+    /// tile's bins in submission order, so no two threads touch the same pixel and the result doesn't depend on the
+    /// thread count.
+    ///
+    /// Corners are snapped to Direct3D's subpixel grid and coverage follows its top-left rule exactly, so triangles
+    /// sharing an edge or corner cover each pixel on it exactly once. Depth is tested as many pixels at a time as the
+    /// build's lanes allow.
+    class Rasterizer
+    {
+    public:
+        /// Width and height of a screen tile in pixels. Small enough for a tile's depth to stay in cache.
+        static constexpr uint32_t TILE = 64;
+
+        /// Corners are snapped to 1 / SUBPIXEL of a pixel, the eight bits of precision Direct3D requires.
+        static constexpr uint32_t SUBPIXEL_BITS = 8;
+        static constexpr uint32_t SUBPIXEL = 1u << SUBPIXEL_BITS;
+
+        /// Pixels past each side of the target that triangles can reach before they're clipped, as in Direct3D's
+        /// viewport range, keeping snapped corners and edge functions well inside 64 bits.
+        static constexpr float GUARD_BAND = 32768.0f;
+
+        /// What a draw did.
+        struct Statistics
+        {
+            /// Triangles submitted.
+            uint64_t Triangles;
+
+            /// Triangles dropped as back-facing, degenerate, behind the near plane, or off screen.
+            uint64_t Culled;
+
+            /// Pixels that passed the depth test and were shaded.
+            uint64_t Pixels;
+        };
+
+        /// Initialize with a number of threads to split each draw over.
+        ///
+        /// @param threads is the number of threads, including the calling one, with zero meaning one per core.
+        explicit Rasterizer(unsigned threads = 0)
+            : threads(threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency()))
+            , bins(this->threads)
+        {}
+
+        /// Get the number of threads each draw is split over.
+        unsigned Threads() const
+        {
+            return this->threads;
+        }
+
+        /// Draw a triangle list, like IndexedVertexBuffer::Draw with a vertex and pixel shader bound.
+        ///
+        /// @typeparam N is the number of floats the vertex stage passes to the pixel stage.
+        /// @param target receives the color and depth of every pixel that passes the depth test.
+        /// @param vertices is the vertex array.
+        /// @param vertexCount is the number of vertices.
+        /// @param indices is the triangle list.
+        /// @param indexCount is the number of indices, three per triangle.
+        /// @param vertexStage is called as vertexStage(vertex) and returns a RasterVertex<N>. It is called once per
+        /// vertex, from several threads at once.
+        /// @param pixelStage is called as pixelStage(varyings) with the perspective-correct interpolation of the
+        /// vertex stage's varyings, and returns a Math::Vector4F color. It is called from several threads at once.
+        /// @returns what the draw did.
+        template<size_t N, typename V, typename I, typename VS, typename PS>
+        Statistics Draw
+        (
+            Framebuffer& target,
+            const V* vertices,
+            size_t vertexCount,
+            const I* indices,
+            size_t indexCount,
+            VS&& vertexStage,
+            PS&& pixelStage
+        )
+        {
+            std::vector<RasterVertex<N>> shaded(vertexCount);
+            this->Parallel([&](unsigned thread)
+            {
+                const size_t first = vertexCount * thread / this->threads;
+                const size_t last = vertexCount * (thread + 1) / this->threads;
+                for (size_t i = first; i < last; ++i)
+                {
+                    shaded[i] = vertexStage(vertices[i]);
+                }
+            });
+
+            const uint32_t columns = (target.Width() + TILE - 1) / TILE;
+            const uint32_t rows = (target.Height() + TILE - 1) / TILE;
+            const size_t triangles = indexCount / 3;
+            std::vector<std::vector<Setup<N>>> setups(this->threads);
+            std::vector<Statistics> statistics(this->threads, Statistics{});
+            this->Parallel([&](unsigned thread)
+            {
+                std::vector<std::vector<uint32_t>>& bins = this->bins[thread];
+                bins.resize(static_cast<size_t>(columns) * rows);
+                for (std::vector<uint32_t>& bin : bins)
+                {
+                    bin.clear();
+                }
+
+                const size_t first = triangles * thread / this->threads;
+                const size_t last = triangles * (thread + 1) / this->threads;
+                for (size_t t = first; t < last; ++t)
+                {
+                    const RasterVertex<N> corners[3] = { shaded[indices[t * 3]], shaded[indices[t * 3 + 1]], shaded[indices[t * 3 + 2]] };
+                    const size_t before = setups[thread].size();
+                    Clip(corners, target.Width(), target.Height(), setups[thread]);
+                    statistics[thread].Triangles += 1;
+                    statistics[thread].Culled += setups[thread].size() == before;
+
+                    for (size_t s = before; s < setups[thread].size(); ++s)
+                    {
+                        const Setup<N>& setup = setups[thread][s];
+                        for (int32_t y = setup.minY / static_cast<int32_t>(TILE); y <= setup.maxY / static_cast<int32_t>(TILE); ++y)
+                        {
+                            for (int32_t x = setup.minX / static_cast<int32_t>(TILE); x <= setup.maxX / static_cast<int32_t>(TILE); ++x)
+                            {
+                                bins[static_cast<size_t>(y) * columns + x].push_back(static_cast<uint32_t>(s));
+                            }
+                        }
+                    }
+                }
+            });
+
+            std::atomic<uint32_t> next(0);
+            this->Parallel([&](unsigned thread)
+            {
+                for (uint32_t tile = next++; tile < columns * rows; tile = next++)
+                {
+                    const int32_t x0 = static_cast<int32_t>(tile % columns * TILE);
+                    const int32_t y0 = static_cast<int32_t>(tile / columns * TILE);
+                    for (unsigned source = 0; source < this->threads; ++source)
+                    {
+                        for (const uint32_t s : this->bins[source][tile])
+                        {
+                            statistics[thread].Pixels += Rasterize(target, setups[source][s], x0, y0, pixelStage);
+                        }
+                    }
+                }
+            });
+
+            Statistics total{};
+            for (const Statistics& part : statistics)
+            {
+                total.Triangles += part.Triangles;
+                total.Culled += part.Culled;
+                total.Pixels += part.Pixels;
+            }
+            return total;
+        }
+
+    private:
+        /// A triangle ready to rasterize, with corners snapped to SUBPIXEL steps of a pixel.
+        template<size_t N>
+        struct Setup
+        {
+            /// Edge functions a x + b y + c for the edges opposite each corner, positive inside, in subpixel steps. They
+            /// are exact, so a shared edge or corner gives its triangles exactly opposite values at every pixel.
+            int64_t a[3];
+            int64_t b[3];
+            int64_t c[3];
+
+            /// Whether each edge is a top or left edge, which owns the pixels exactly on it.
+            bool owns[3];
+
+            /// Depth, reciprocal w, and varyings over w at each corner, which are all linear in screen space.
+            float z[3];
+            float w[3];
+            std::array<float, N> varyings[3];
+
+            /// One over twice the area, to turn edge functions into barycentric coordinates.
+            float scale;
+
+            /// Pixel bounds, inclusive and clamped to the target.
+            int32_t minX;
+            int32_t minY;
+            int32_t maxX;
+            int32_t maxY;
+        };
+
+        /// Run a function on every thread, passing each its index. The calling thread does the first share.
+        template<typename F>
+        void Parallel(F&& function) const
+        {
+            std::vector<std::thread> workers;
+            workers.reserve(this->threads - 1);
+            for (unsigned thread = 1; thread < this->threads; ++thread)
+            {
+                workers.emplace_back([&function, thread]() { function(thread); });
+            }
+            function(0);
+            for (std::thread& worker : workers)
+            {
+                worker.join();
+            }
+        }
+
+        /// Signed distance of a clip space position from each clipping plane, positive inside: the near plane, z = 0,
+        /// then the guard band's left, right, top and bottom.
+        static float Distance(size_t plane, const Math::Vector4F& position, float guardX, float guardY)
+        {
+            switch (plane)
+            {
+            case 0: return position.z;
+            case 1: return guardX * position.w + position.x;
+            case 2: return guardX * position.w - position.x;
+            case 3: return guardY * position.w - position.y;
+            default: return guardY * position.w + position.y;
+            }
+        }
+
+        /// Clip a triangle against the near plane and the guard band, GUARD_BAND pixels around the target, and set
+        /// up whatever is left. Only triangles reaching past the guard band are cut; everything else off screen is
+        /// handled by clamping the bounds.
+        template<size_t N>
+        static void Clip(const RasterVertex<N> (&corners)[3], uint32_t width, uint32_t height, std::vector<Setup<N>>& out)
+        {
+            const float guardX = 1.0f + 2.0f * GUARD_BAND / static_cast<float>(width);
+            const float guardY = 1.0f + 2.0f * GUARD_BAND / static_cast<float>(height);
+
+            bool inside = true;
+            for (size_t plane = 0; plane < PLANES && inside; ++plane)
+            {
+                for (size_t i = 0; i < 3; ++i)
+                {
+                    inside = inside && Distance(plane, corners[i].Position, guardX, guardY) >= 0.0f;
+                }
+            }
+            if (inside)
+            {
+                Prepare(corners[0], corners[1], corners[2], width, height, out);
+                return;
+            }
+
+            // Walk the edges against each plane in turn, keeping the corners inside and adding one where an edge
+            // crosses. Each plane adds at most one corner, and what's left is convex, so it fans into triangles
+            RasterVertex<N> buffers[2][3 + PLANES];
+            std::copy(corners, corners + 3, buffers[0]);
+            size_t count = 3;
+            for (size_t plane = 0; plane < PLANES && count >= 3; ++plane)
+            {
+                const RasterVertex<N>* polygon = buffers[plane % 2];
+                RasterVertex<N>* clipped = buffers[(plane + 1) % 2];
+                size_t kept = 0;
+                for (size_t i = 0; i < count; ++i)
+                {
+                    const RasterVertex<N>& from = polygon[i];
+                    const RasterVertex<N>& to = polygon[(i + 1) % count];
+                    const float start = Distance(plane, from.Position, guardX, guardY);
+                    const float end = Distance(plane, to.Position, guardX, guardY);
+                    if (start >= 0.0f)
+                    {
+                        clipped[kept++] = from;
+                    }
+                    if ((start >= 0.0f) != (end >= 0.0f))
+                    {
+                        const float t = start / (start - end);
+                        RasterVertex<N>& crossing = clipped[kept++];
+                        crossing.Position = from.Position + (to.Position - from.Position) * t;
+                        for (size_t k = 0; k < N; ++k)
+                        {
+                            crossing.Varyings[k] = from.Varyings[k] + (to.Varyings[k] - from.Varyings[k]) * t;
+                        }
+                    }
+                }
+                count = kept;
+            }
+
+            const RasterVertex<N>* polygon = buffers[PLANES % 2];
+            for (size_t i = 2; i < count; ++i)
+            {
+                Prepare(polygon[0], polygon[i - 1], polygon[i], width, height, out);
+            }
+        }
+
+        /// Project a clipped triangle to pixels, snap it to the subpixel grid and set it up, unless it faces away, has
+        /// no area, or lies off screen.
+        template<size_t N>
+        static void Prepare(const RasterVertex<N>& v0, const RasterVertex<N>& v1, const RasterVertex<N>& v2, uint32_t width, uint32_t height, std::vector<Setup<N>>& out)
+        {
+            const RasterVertex<N>* corners[3] = { &v0, &v1, &v2 };
+            Setup<N> setup;
+            int64_t x[3];
+            int64_t y[3];
+            for (size_t i = 0; i < 3; ++i)
+            {
+                const Math::Vector4F& position = corners[i]->Position;
+                if (!(position.w > 0.0f))
+                {
+                    return;
+                }
+
+                // Clipping leaves corners within rounding of the guard band, so the clamp only guards the conversion
+                const float w = 1.0f / position.w;
+                const float limit = 2.0f * GUARD_BAND + static_cast<float>(std::max(width, height));
+                const float px = std::clamp((position.x * w * 0.5f + 0.5f) * width, -limit, limit);
+                const float py = std::clamp((0.5f - position.y * w * 0.5f) * height, -limit, limit);
+                x[i] = std::llround(px * SUBPIXEL);
+                y[i] = std::llround(py * SUBPIXEL);
+                setup.z[i] = position.z * w;
+                setup.w[i] = w;
+                for (size_t k = 0; k < N; ++k)
+                {
+                    setup.varyings[i][k] = corners[i]->Varyings[k] * w;
+                }
+            }
+
+            // Twice the signed area, positive when clockwise on screen with y pointing down
+            const int64_t area = (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+            if (area <= 0)
+            {
+                return;
+            }
+
+            // Pixels whose centers could be inside, the shifts rounding toward negative infinity
+            const int64_t step = static_cast<int64_t>(SUBPIXEL);
+            const int64_t left = std::max<int64_t>(0, (std::min({ x[0], x[1], x[2] }) - step / 2) >> SUBPIXEL_BITS);
+            const int64_t top = std::max<int64_t>(0, (std::min({ y[0], y[1], y[2] }) - step / 2) >> SUBPIXEL_BITS);
+            const int64_t right = std::min<int64_t>(width - 1, (std::max({ x[0], x[1], x[2] }) - step / 2) >> SUBPIXEL_BITS);
+            const int64_t bottom = std::min<int64_t>(height - 1, (std::max({ y[0], y[1], y[2] }) - step / 2) >> SUBPIXEL_BITS);
+            if (left > right || top > bottom)
+            {
+                return;
+            }
+            setup.minX = static_cast<int32_t>(left);
+            setup.minY = static_cast<int32_t>(top);
+            setup.maxX = static_cast<int32_t>(right);
+            setup.maxY = static_cast<int32_t>(bottom);
+
+            for (size_t i = 0; i < 3; ++i)
+            {
+                const size_t p = (i + 1) % 3;
+                const size_t q = (i + 2) % 3;
+                setup.a[i] = y[p] - y[q];
+                setup.b[i] = x[q] - x[p];
+                setup.c[i] = x[p] * y[q] - y[p] * x[q];
+                setup.owns[i] = y[q] < y[p] || (y[q] == y[p] && x[q] > x[p]);
+            }
+            setup.scale = 1.0f / static_cast<float>(area);
+            out.push_back(setup);
+        }
+
+        /// Rasterize the part of a triangle inside one tile, returning the number of pixels shaded. Edge functions are
+        /// stepped exactly in integers and only then converted, which keeps their signs, so coverage is decided exactly
+        /// while depth and interpolation run in lanes.
+        template<size_t N, typename PS>
+        static uint64_t Rasterize(Framebuffer& target, const Setup<N>& setup, int32_t x0, int32_t y0, PS& pixelStage)
+        {
+            const int32_t width = static_cast<int32_t>(target.Width());
+            const int32_t left = std::max(setup.minX, x0);
+            const int32_t right = std::min(setup.maxX + 1, x0 + static_cast<int32_t>(TILE));
+            const int32_t top = std::max(setup.minY, y0);
+            const int32_t bottom = std::min(setup.maxY, y0 + static_cast<int32_t>(TILE) - 1);
+            const int64_t step = static_cast<int64_t>(SUBPIXEL);
+            uint64_t shaded = 0;
+
+            for (int32_t y = top; y <= bottom; ++y)
+            {
+                float* depths = target.Depths() + static_cast<size_t>(y) * width;
+                uint32_t* colors = target.Colors() + static_cast<size_t>(y) * width;
+
+                // Edge functions at the first pixel center of the row
+                int64_t starts[3];
+                for (size_t e = 0; e < 3; ++e)
+                {
+                    starts[e] = setup.a[e] * (left * step + step / 2) + setup.b[e] * (y * step + step / 2) + setup.c[e];
+                }
+
+                Math::Simd::Sweep(static_cast<size_t>(right - left), [&](auto lane, size_t i)
+                {
+                    using L = decltype(lane);
+                    const int32_t x = left + static_cast<int32_t>(i);
+                    const L zero = L::Broadcast(0.0f);
+
+                    L edges[3];
+                    int covered = (1 << L::Width) - 1;
+                    for (size_t e = 0; e < 3; ++e)
+                    {
+                        float values[8];
+                        for (size_t j = 0; j < L::Width; ++j)
+                        {
+                            values[j] = static_cast<float>(starts[e] + setup.a[e] * step * static_cast<int64_t>(i + j));
+                        }
+                        edges[e] = L::Load(values);
+                        covered &= Bits(edges[e] > zero) | (setup.owns[e] ? Bits(edges[e] >= zero) : 0);
+                    }
+                    if (covered == 0)
+                    {
+                        return;
+                    }
+
+                    const L scale = L::Broadcast(setup.scale);
+                    const L z = (edges[0] * L::Broadcast(setup.z[0]) + edges[1] * L::Broadcast(setup.z[1]) + edges[2] * L::Broadcast(setup.z[2])) * scale;
+                    covered &= Bits(z < L::Load(depths + x));
+                    if (covered == 0)
+                    {
+                        return;
+                    }
+
+                    float weights[3][8];
+                    float depth[8];
+                    for (size_t e = 0; e < 3; ++e)
+                    {
+                        (edges[e] * scale).Store(weights[e]);
+                    }
+                    z.Store(depth);
+
+                    for (size_t j = 0; j < L::Width; ++j)
+                    {
+                        if (!((covered >> j) & 1))
+                        {
+                            continue;
+                        }
+
+                        const float w = 1.0f / (weights[0][j] * setup.w[0] + weights[1][j] * setup.w[1] + weights[2][j] * setup.w[2]);
+                        std::array<float, N> varyings;
+                        for (size_t k = 0; k < N; ++k)
+                        {
+                            varyings[k] = (weights[0][j] * setup.varyings[0][k] + weights[1][j] * setup.varyings[1][k] + weights[2][j] * setup.varyings[2][k]) * w;
+                        }
+                        depths[x + j] = depth[j];
+                        colors[x + j] = ToBgra8(pixelStage(varyings));
+                        shaded += 1;
+                    }
+                });
+            }
+            return shaded;
+        }
+
+        /// Number of clipping planes, the near plane and the four sides of the guard band.
+        static constexpr size_t PLANES = 5;
+
+        unsigned threads;
+
+        /// Per thread, the setups each tile overlaps, kept between draws to avoid reallocating.
+        std::vector<std::vector<std::vector<uint32_t>>> bins;
+    };
+}
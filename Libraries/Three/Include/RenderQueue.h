@@ -0,0 +1,102 @@
+#pragma once
+
+#include "Renderable.h"
+#include "Commands.h"
+
+#include <vector>
+
+namespace Dance::Three::Graphics
+{
+	/// Collects the renderables drawn in a frame and draws them grouped by shader and mesh, front to back within each
+	/// group, so that a shader or mesh shared by consecutive renderables is only bound once. Renderable::Render binds
+	/// everything for every object instead.
+	class RenderQueue
+	{
+	public:
+		/// Empty initialize a queue. Makes no allocations.
+		RenderQueue()
+			: commands()
+			, objects()
+			, shaders()
+			, meshes()
+		{}
+
+		/// Queue a renderable for this frame. It has to stay alive until the queue is submitted.
+		/// 
+		/// @param renderable is the renderable to draw.
+		/// @param depth is its distance from the camera, which orders renderables sharing a shader and mesh.
+		void Add(Renderable& renderable, float depth)
+		{
+			const uint32_t shader = Intern(this->shaders, &renderable.Program());
+			const uint32_t mesh = Intern(this->meshes, &renderable.Mesh());
+			const uint32_t object = static_cast<uint32_t>(this->objects.size());
+			this->objects.push_back(&renderable);
+			this->commands.Add(DrawPacket{ SortKey::Make(shader, mesh, depth), shader, mesh, object });
+		}
+
+		/// Sort and draw everything queued since the last submission, then clear the queue.
+		/// 
+		/// @param index is the constant buffer index each renderable writes to.
+		/// @returns what was bound, drawn, and skipped.
+		CommandBuffer::Statistics Submit(UINT index)
+		{
+			Backend backend{ *this, index };
+			this->commands.Sort();
+			const CommandBuffer::Statistics statistics = this->commands.Submit(backend);
+
+			this->commands.Clear();
+			this->objects.clear();
+			this->shaders.clear();
+			this->meshes.clear();
+			return statistics;
+		}
+
+	private:
+		/// Recorded draws, naming the state below by index.
+		CommandBuffer commands;
+
+		/// Renderables, shaders and meshes referenced by this frame's packets.
+		std::vector<Renderable*> objects;
+		std::vector<const Shader*> shaders;
+		std::vector<const IndexedVertexBuffer<Vertex>*> meshes;
+
+		/// Routes the command buffer's binds and draws to the renderables' state.
+		struct Backend
+		{
+			RenderQueue& queue;
+			UINT index;
+
+			void BindShader(uint32_t shader)
+			{
+				this->queue.shaders[shader]->Apply();
+			}
+
+			void BindMesh(uint32_t mesh)
+			{
+				this->queue.meshes[mesh]->Set();
+			}
+
+			void Draw(const DrawPacket& packet)
+			{
+				this->queue.objects[packet.Object]->Draw(this->index);
+			}
+		};
+
+		/// Find the id of a piece of state, adding it if this frame hasn't seen it. Renderables hold their own copies of
+		/// shaders and meshes, so state is matched by the Direct3D objects it wraps rather than by address. A frame
+		/// only uses a handful of each, so searching beats hashing.
+		template<typename T>
+		static uint32_t Intern(std::vector<const T*>& states, const T* state)
+		{
+			for (size_t i = 0; i < states.size(); ++i)
+			{
+				if (*states[i] == *state)
+				{
+					return static_cast<uint32_t>(i);
+				}
+			}
+			states.push_back(state);
+			return static_cast<uint32_t>(states.size() - 1);
+		}
+	};
+}
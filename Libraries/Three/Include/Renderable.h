@@ -27,6 +27,7 @@ namespace Dance::Three::Graphics
 			, vertices()
 			, constants()
 			, shader()
+			, bounds()
 		{}
 
 		/// Create a new renderable using a device to allocate everything.
@@ -38,11 +39,12 @@ namespace Dance::Three::Graphics
 			, vertices()
 			, constants(device)
 			, shader()
+			, bounds()
 		{
 			device->GetImmediateContext(this->deviceContext.ReleaseAndGetAddressOf());
 		}
 
-		/// Set the constant buffer, write our data, apply the shader, set and draw the vertices.
+		/// Set the constant buffer, write our data if it changed, apply the shader, set and draw the vertices.
 		///
 		/// @param index is the constant buffer index we will write to.
 		virtual void Render(UINT index) {
@@ -53,12 +55,89 @@ namespace Dance::Three::Graphics
 			this->vertices.Draw();
 		}
 
-		/// Get mutable access to the renderable's transform.
+		/// Same as Render, but writing our constants into the frame's shared buffer instead of our own.
+		///
+		/// @param index is the constant buffer index we bind the written range to.
+		/// @param uploads is the shared buffer for the current frame.
+		virtual void Render(UINT index, FrameConstantBuffer& uploads) {
+			this->Render(index, uploads, this->Stage(uploads));
+		}
+
+		/// Same as Render, but binding constants already written by Stage. Staging every renderable before rendering
+		/// any of them writes the frame's constants under a single map.
+		///
+		/// @param index is the constant buffer index we bind the written range to.
+		/// @param uploads is the shared buffer for the current frame.
+		/// @param slice is the range Stage returned this frame.
+		virtual void Render(UINT index, FrameConstantBuffer& uploads, const FrameConstantBuffer::Slice& slice) {
+			uploads.Set(index, slice);
+			this->shader.Apply();
+			this->vertices.Set();
+			this->vertices.Draw();
+		}
+
+		/// Write our constants into the frame's shared buffer without drawing.
+		///
+		/// @param uploads is the shared buffer for the current frame.
+		/// @returns the range written, to pass to Render.
+		FrameConstantBuffer::Slice Stage(FrameConstantBuffer& uploads) const
+		{
+			return uploads.Write(this->constants.Data());
+		}
+
+		/// Set the constant buffer, write our data if it changed, and draw, leaving the shader and vertices to whoever
+		/// bound them, like RenderQueue.
+		///
+		/// @param index is the constant buffer index we will write to.
+		void Draw(UINT index) {
+			this->constants.Set(index);
+			this->constants.Write();
+			this->vertices.Draw();
+		}
+
+		/// Get the shader we draw with, so that draws can be grouped by it.
+		const Shader& Program() const
+		{
+			return this->shader;
+		}
+
+		/// Get the vertices we draw, so that draws can be grouped by them.
+		const IndexedVertexBuffer<Vertex>& Mesh() const
+		{
+			return this->vertices;
+		}
+
+		/// Get mutable access to the renderable's transform, marking our constants to be uploaded on the next render.
 		/// 
-		/// @returns a const reference to the underlying Matrix4F transform in our managed constant buffer.
+		/// @returns a reference to the underlying Matrix4F transform in our managed constant buffer.
 		Matrix4F& Transform()
 		{
-			return this->constants.Data.Transform;
+			return this->constants.Modify().Transform;
+		}
+
+		/// Get read-only access to the renderable's transform, which doesn't cause an upload.
+		/// 
+		/// @returns a const reference to the underlying Matrix4F transform in our managed constant buffer.
+		const Matrix4F& Transform() const
+		{
+			return this->constants.Data().Transform;
+		}
+
+		/// Get mutable access to the renderable's bounds in its own coordinates, before the transform is applied.
+		/// 
+		/// @returns a reference to the box, which is empty until the subclass fills it in from its vertices.
+		Math::AABBF& Bounds()
+		{
+			return this->bounds;
+		}
+
+		/// Check whether any of the renderable may be seen, so that drawing it can be skipped otherwise.
+		/// 
+		/// @param frustum is the camera frustum to test against, usually from Camera::Frustum.
+		/// @returns true if the transformed bounds intersect the frustum, or if no bounds were given.
+		bool Visible(const Math::FrustumF& frustum) const
+		{
+			return this->bounds.Empty() || frustum.Intersects(this->bounds.Transformed(this->constants.Data().Transform));
 		}
 
 	protected:
@@ -73,5 +152,8 @@ namespace Dance::Three::Graphics
 
 		/// The shader with which to draw our vertices.
 		Shader shader;
+
+		/// Box around the vertices in local coordinates.
+		Math::AABBF bounds;
 	};
 }
@@ -76,6 +76,14 @@ namespace Dance::Three::Graphics
             this->deviceContext->IASetInputLayout(this->inputLayout.Get());
         }
 
+        /// Check whether two shaders wrap the same pipeline objects, as copies of one another do.
+        bool operator==(const Shader& other) const
+        {
+            return this->vertexShader == other.vertexShader
+                && this->pixelShader == other.pixelShader
+                && this->inputLayout == other.inputLayout;
+        }
+
         /// Compile a shader file using D3D's builtin GLSL compiler.
         ///
         /// @param path should be a valid file path to the GLSL shader we will compile and use.
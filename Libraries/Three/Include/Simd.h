@@ -0,0 +1,209 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+// Every x64 target has SSE2; on x86 MSVC reports the /arch level through _M_IX86_FP
+#if defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define DANCE_SSE 1
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#else
+#define DANCE_SSE 0
+#endif
+
+// Only enabled when the whole build targets AVX, e.g. with /arch:AVX, since we dispatch at compile time
+#if DANCE_SSE && defined(__AVX__)
+#define DANCE_AVX 1
+#include <immintrin.h>
+#else
+#define DANCE_AVX 0
+#endif
+
+namespace Dance::Three::Math::Simd
+{
+    /// Whether the vectorized kernels below are used for a given scalar type. The math types check this with
+    /// if constexpr and otherwise fall back to their scalar implementations.
+    template<typename T>
+    inline constexpr bool Accelerated = DANCE_SSE && std::is_same_v<T, float>;
+
+#if DANCE_SSE
+    /// Multiply two row-major 4x4 matrices, c = a * b. Each row of the result is the sum of the rows of b scaled by
+    /// the broadcast elements of the matching row of a. The rows are computed and stored separately rather than in a
+    /// loop so that the compiler can keep the result in registers when it's read right away. This stays at SSE width
+    /// in AVX builds: pairing rows in 256-bit registers measured no faster and turned the caller's copy of the result
+    /// into a load that spans both stores, which can't be forwarded.
+    inline void Multiply(const float a[4][4], const float b[4][4], float c[4][4])
+    {
+        const __m128 b0 = _mm_loadu_ps(b[0]);
+        const __m128 b1 = _mm_loadu_ps(b[1]);
+        const __m128 b2 = _mm_loadu_ps(b[2]);
+        const __m128 b3 = _mm_loadu_ps(b[3]);
+        const auto product = [&](const float* row)
+        {
+            const __m128 r = _mm_loadu_ps(row);
+            __m128 result = _mm_mul_ps(_mm_shuffle_ps(r, r, 0x00), b0);
+            result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(r, r, 0x55), b1));
+            result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(r, r, 0xAA), b2));
+            return _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(r, r, 0xFF), b3));
+        };
+        const __m128 c0 = product(a[0]);
+        const __m128 c1 = product(a[1]);
+        const __m128 c2 = product(a[2]);
+        const __m128 c3 = product(a[3]);
+        _mm_storeu_ps(c[0], c0);
+        _mm_storeu_ps(c[1], c1);
+        _mm_storeu_ps(c[2], c2);
+        _mm_storeu_ps(c[3], c3);
+    }
+
+    /// Invert a 4x4 matrix in place by Cramer's rule. This is the vectorized form of the same cofactor expansion
+    /// Matrix4::Invert falls back to (Intel AP-928), computing four cofactors per instruction. The determinant is
+    /// inverted with a full division rather than the reciprocal estimate so results match the scalar path closely.
+    inline void Invert(float m[4][4])
+    {
+        float* src = &m[0][0];
+        __m128 minor0, minor1, minor2, minor3;
+        __m128 row0, row1, row2, row3;
+        __m128 det, tmp1;
+
+        // Load the transpose, with the halves of rows 1 and 3 swapped to suit the pairings below
+        tmp1 = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(src)), reinterpret_cast<const __m64*>(src + 4));
+        row1 = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(src + 8)), reinterpret_cast<const __m64*>(src + 12));
+        row0 = _mm_shuffle_ps(tmp1, row1, 0x88);
+        row1 = _mm_shuffle_ps(row1, tmp1, 0xDD);
+        tmp1 = _mm_loadh_pi(_mm_loadl_pi(tmp1, reinterpret_cast<const __m64*>(src + 2)), reinterpret_cast<const __m64*>(src + 6));
+        row3 = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(src + 10)), reinterpret_cast<const __m64*>(src + 14));
+        row2 = _mm_shuffle_ps(tmp1, row3, 0x88);
+        row3 = _mm_shuffle_ps(row3, tmp1, 0xDD);
+
+        tmp1 = _mm_mul_ps(row2, row3);
+        tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0xB1);
+        minor0 = _mm_mul_ps(row1, tmp1);
+        minor1 = _mm_mul_ps(row0, tmp1);
+        tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0x4E);
+        minor0 = _mm_sub_ps(_mm_mul_ps(row1, tmp1), minor0);
+        minor1 = _mm_sub_ps(_mm_mul_ps(row0, tmp1), minor1);
+        minor1 = _mm_shuffle_ps(minor1, minor1, 0x4E);
+
+        tmp1 = _mm_mul_ps(row1, row2);
+        tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0xB1);
+        minor0 = _mm_add_ps(_mm_mul_ps(row3, tmp1), minor0);
+        minor3 = _mm_mul_ps(row0, tmp1);
+        tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0x4E);
+        minor0 = _mm_sub_ps(minor0, _mm_mul_ps(row3, tmp1));
+        minor3 = _mm_sub_ps(_mm_mul_ps(row0, tmp1), minor3);
+        minor3 = _mm_shuffle_ps(minor3, minor3, 0x4E);
+
+        tmp1 = _mm_mul_ps(_mm_shuffle_ps(row1, row1, 0x4E), row3);
+        tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0xB1);
+        row2 = _mm_shuffle_ps(row2, row2, 0x4E);
+        minor0 = _mm_add_ps(_mm_mul_ps(row2, tmp1), minor0);
+        minor2 = _mm_mul_ps(row0, tmp1);
+        tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0x4E);
+        minor0 = _mm_sub_ps(minor0, _mm_mul_ps(row2, tmp1));
+        minor2 = _mm_sub_ps(_mm_mul_ps(row0, tmp1), minor2);
+        minor2 = _mm_shuffle_ps(minor2, minor2, 0x4E);
+
+        tmp1 = _mm_mul_ps(row0, row1);
+        tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0xB1);
+        minor2 = _mm_add_ps(_mm_mul_ps(row3, tmp1), minor2);
+        minor3 = _mm_sub_ps(_mm_mul_ps(row2, tmp1), minor3);
+        tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0x4E);
+        minor2 = _mm_sub_ps(_mm_mul_ps(row3, tmp1), minor2);
+        minor3 = _mm_sub_ps(minor3, _mm_mul_ps(row2, tmp1));
+
+        tmp1 = _mm_mul_ps(row0, row3);
+        tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0xB1);
+        minor1 = _mm_sub_ps(minor1, _mm_mul_ps(row2, tmp1));
+        minor2 = _mm_add_ps(_mm_mul_ps(row1, tmp1), minor2);
+        tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0x4E);
+        minor1 = _mm_add_ps(_mm_mul_ps(row2, tmp1), minor1);
+        minor2 = _mm_sub_ps(minor2, _mm_mul_ps(row1, tmp1));
+
+        tmp1 = _mm_mul_ps(row0, row2);
+        tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0xB1);
+        minor1 = _mm_add_ps(_mm_mul_ps(row3, tmp1), minor1);
+        minor3 = _mm_sub_ps(minor3, _mm_mul_ps(row1, tmp1));
+        tmp1 = _mm_shuffle_ps(tmp1, tmp1, 0x4E);
+        minor1 = _mm_sub_ps(minor1, _mm_mul_ps(row3, tmp1));
+        minor3 = _mm_add_ps(_mm_mul_ps(row1, tmp1), minor3);
+
+        // Determinant from the first row and its cofactors, broadcast and inverted
+        det = _mm_mul_ps(row0, minor0);
+        det = _mm_add_ps(_mm_shuffle_ps(det, det, 0x4E), det);
+        det = _mm_add_ss(_mm_shuffle_ps(det, det, 0xB1), det);
+        det = _mm_div_ss(_mm_set_ss(1.0f), det);
+        det = _mm_shuffle_ps(det, det, 0x00);
+
+        _mm_storeu_ps(src, _mm_mul_ps(det, minor0));
+        _mm_storeu_ps(src + 4, _mm_mul_ps(det, minor1));
+        _mm_storeu_ps(src + 8, _mm_mul_ps(det, minor2));
+        _mm_storeu_ps(src + 12, _mm_mul_ps(det, minor3));
+    }
+
+    /// Invert a matrix whose last column is (0, 0, 0, 1) in place. The columns of the inverse of the upper 3x3 block
+    /// are the cross products of pairs of its rows over the determinant, so the block is inverted with three cross
+    /// products and a transpose, after which the translation becomes -t * inverse as in Matrix4::InvertAffine.
+    inline void InvertAffine(float m[4][4])
+    {
+        // a x b with the lanes rotated once instead of twice, relying on the zero fourth lanes of the rows
+        const auto cross = [](__m128 a, __m128 b)
+        {
+            const __m128 c = _mm_sub_ps(
+                _mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1))),
+                _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1)), b));
+            return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+        };
+
+        const __m128 row0 = _mm_loadu_ps(m[0]);
+        const __m128 row1 = _mm_loadu_ps(m[1]);
+        const __m128 row2 = _mm_loadu_ps(m[2]);
+        const __m128 t = _mm_loadu_ps(m[3]);
+
+        __m128 column0 = cross(row1, row2);
+        __m128 column1 = cross(row2, row0);
+        __m128 column2 = cross(row0, row1);
+        __m128 zero = _mm_setzero_ps();
+
+        // Determinant from the first row and its cofactors, broadcast and inverted
+        __m128 det = _mm_mul_ps(row0, column0);
+        det = _mm_add_ps(_mm_shuffle_ps(det, det, 0x4E), det);
+        det = _mm_add_ps(_mm_shuffle_ps(det, det, 0xB1), det);
+        const __m128 invDet = _mm_div_ps(_mm_set1_ps(1.0f), det);
+
+        column0 = _mm_mul_ps(column0, invDet);
+        column1 = _mm_mul_ps(column1, invDet);
+        column2 = _mm_mul_ps(column2, invDet);
+        _MM_TRANSPOSE4_PS(column0, column1, column2, zero);
+
+        __m128 translation = _mm_mul_ps(_mm_shuffle_ps(t, t, 0x00), column0);
+        translation = _mm_add_ps(translation, _mm_mul_ps(_mm_shuffle_ps(t, t, 0x55), column1));
+        translation = _mm_add_ps(translation, _mm_mul_ps(_mm_shuffle_ps(t, t, 0xAA), column2));
+
+        _mm_storeu_ps(m[0], column0);
+        _mm_storeu_ps(m[1], column1);
+        _mm_storeu_ps(m[2], column2);
+        _mm_storeu_ps(m[3], _mm_sub_ps(_mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f), translation));
+    }
+
+    /// Transform an array of four-component row vectors by a row-major matrix, out[i] = in[i] * m. The input and
+    /// output may be the same array. Not used in AVX builds, where the plain loop vectorizes better than this does.
+    inline void Transform(const float m[4][4], const float* in, float* out, size_t count)
+    {
+        const __m128 r0 = _mm_loadu_ps(m[0]);
+        const __m128 r1 = _mm_loadu_ps(m[1]);
+        const __m128 r2 = _mm_loadu_ps(m[2]);
+        const __m128 r3 = _mm_loadu_ps(m[3]);
+        for (size_t i = 0; i < count; ++i)
+        {
+            const __m128 v = _mm_loadu_ps(in + i * 4);
+            __m128 result = _mm_mul_ps(_mm_shuffle_ps(v, v, 0x00), r0);
+            result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(v, v, 0x55), r1));
+            result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(v, v, 0xAA), r2));
+            result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(v, v, 0xFF), r3));
+            _mm_storeu_ps(out + i * 4, result);
+        }
+    }
+#endif
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "Matrix4.h"
+
+#include <algorithm>
+
+namespace Dance::Three::Math
+{
+    /// The narrowest class of transform a matrix is known to belong to, ordered from most to least general.
+    enum class MatrixKind
+    {
+        /// Anything, including projections. Needs the full inverse.
+        General,
+
+        /// A linear transform followed by a translation; the last column is (0, 0, 0, 1).
+        Affine,
+
+        /// A rotation followed by a translation, with orthonormal rotation rows.
+        Rigid,
+    };
+
+    /// A matrix that remembers which class of transform it is, so that inverting it takes the cheapest valid path.
+    /// Building one through the factories below tags it correctly, and products keep the more general of the two kinds.
+    template<typename T>
+    class TaggedMatrix4
+    {
+    public:
+        Matrix4<T> matrix;
+        MatrixKind kind;
+
+        /// The identity, which is rigid.
+        TaggedMatrix4() : matrix(), kind(MatrixKind::Rigid) {}
+
+        /// Tag an existing matrix. Claiming a narrower kind than the matrix actually has gives wrong inverses.
+        explicit TaggedMatrix4(const Matrix4<T>& matrix, MatrixKind kind = MatrixKind::General)
+            : matrix(matrix)
+            , kind(kind)
+        {}
+
+        operator const Matrix4<T>&() const
+        {
+            return this->matrix;
+        }
+
+        const T* Flatten() const
+        {
+            return this->matrix.Flatten();
+        }
+
+        Vector3<T> Translation() const
+        {
+            return this->matrix.Translation();
+        }
+
+        void Invert()
+        {
+            switch (this->kind)
+            {
+            case MatrixKind::Rigid:
+                this->matrix.InvertRigid();
+                break;
+            case MatrixKind::Affine:
+                this->matrix.InvertAffine();
+                break;
+            default:
+                this->matrix.Invert();
+                break;
+            }
+        }
+
+        TaggedMatrix4 Inverted() const
+        {
+            TaggedMatrix4 result(*this);
+            result.Invert();
+            return result;
+        }
+
+        friend TaggedMatrix4 operator*(const TaggedMatrix4& a, const TaggedMatrix4& b)
+        {
+            return TaggedMatrix4(a.matrix * b.matrix, std::min(a.kind, b.kind));
+        }
+
+        TaggedMatrix4& operator*=(const TaggedMatrix4& right)
+        {
+            *this = *this * right;
+            return *this;
+        }
+
+        friend Matrix4<T> operator*(const TaggedMatrix4& a, const Matrix4<T>& b)
+        {
+            return a.matrix * b;
+        }
+
+        friend Matrix4<T> operator*(const Matrix4<T>& a, const TaggedMatrix4& b)
+        {
+            return a * b.matrix;
+        }
+
+        static TaggedMatrix4 Translation(T x, T y, T z)
+        {
+            return TaggedMatrix4(Matrix4<T>::Translation(x, y, z), MatrixKind::Rigid);
+        }
+
+        static TaggedMatrix4 Translation(const Vector3<T>& v)
+        {
+            return TaggedMatrix4(Matrix4<T>::Translation(v), MatrixKind::Rigid);
+        }
+
+        static TaggedMatrix4 XRotation(T theta)
+        {
+            return TaggedMatrix4(Matrix4<T>::XRotation(theta), MatrixKind::Rigid);
+        }
+
+        static TaggedMatrix4 YRotation(T theta)
+        {
+            return TaggedMatrix4(Matrix4<T>::YRotation(theta), MatrixKind::Rigid);
+        }
+
+        static TaggedMatrix4 ZRotation(T theta)
+        {
+            return TaggedMatrix4(Matrix4<T>::ZRotation(theta), MatrixKind::Rigid);
+        }
+
+        /// Rotation by a unit quaternion.
+        static TaggedMatrix4 From(const Quaternion<T>& q)
+        {
+            return TaggedMatrix4(Matrix4<T>::From(q), MatrixKind::Rigid);
+        }
+
+        static TaggedMatrix4 Look(const Vector3<T>& eye, const Vector3<T>& at, const Vector3<T>& up)
+        {
+            return TaggedMatrix4(Matrix4<T>::Look(eye, at, up), MatrixKind::Rigid);
+        }
+
+        static TaggedMatrix4 Scale(T x, T y, T z)
+        {
+            return TaggedMatrix4(Matrix4<T>::Scale(x, y, z), MatrixKind::Affine);
+        }
+
+        static TaggedMatrix4 Scale(T s)
+        {
+            return TaggedMatrix4(Matrix4<T>::Scale(s), MatrixKind::Affine);
+        }
+    };
+
+    using TaggedMatrix4F = TaggedMatrix4<float>;
+    using TaggedMatrix4D = TaggedMatrix4<double>;
+}
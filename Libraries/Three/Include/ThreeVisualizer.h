@@ -10,6 +10,9 @@ namespace Dance::Three
     public:
         ThreeVisualizer(const Dependencies& dependencies);
 
+        /// Report how many constant uploads dirty tracking skipped while this plugin was loaded.
+        virtual ~ThreeVisualizer();
+
         virtual HRESULT Unsize();
         virtual HRESULT Resize(const RECT& size);
 
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "Vector3.h"
+#include "Quaternion.h"
+#include "Matrix4.h"
+
+namespace Dance::Three::Math
+{
+    /// A scale, then a rotation, then a translation, kept as separate components rather than a matrix. Composing
+    /// and animating these is cheaper than multiplying chains of 4x4 matrices, and Transformation::Matrix builds the
+    /// equivalent of Scale * From(rotation) * Translation in a single pass when a matrix is finally needed.
+    template<typename T>
+    class Transformation
+    {
+    public:
+        Vector3<T> translation;
+        Quaternion<T> rotation;
+        Vector3<T> scale;
+
+        Transformation()
+            : translation()
+            , rotation()
+            , scale(1, 1, 1)
+        {}
+
+        explicit Transformation(const Vector3<T>& translation, const Quaternion<T>& rotation, const Vector3<T>& scale)
+            : translation(translation)
+            , rotation(rotation)
+            , scale(scale)
+        {}
+
+        explicit Transformation(const Vector3<T>& translation, const Quaternion<T>& rotation, T scale)
+            : translation(translation)
+            , rotation(rotation)
+            , scale(scale, scale, scale)
+        {}
+
+        /// Rotate a vector by the rotation component alone.
+        Vector3<T> Rotate(const Vector3<T>& v) const
+        {
+            const Vector3<T> axis = this->rotation.Three();
+            return v + static_cast<T>(2) * Cross(axis, Cross(axis, v) + this->rotation.w * v);
+        }
+
+        /// Transform a point, equivalent to transforming it by Transformation::Matrix with w = 1.
+        Vector3<T> Apply(const Vector3<T>& point) const
+        {
+            return this->Rotate(point * this->scale) + this->translation;
+        }
+
+        /// Apply a followed by b. Exact when b's scale is uniform; a non-uniform scale after a rotation would need shear,
+        /// which this representation can't hold, so the scales are simply multiplied.
+        friend Transformation operator*(const Transformation& a, const Transformation& b)
+        {
+            return Transformation(
+                b.Apply(a.translation),
+                Concatenate(a.rotation, b.rotation),
+                a.scale * b.scale);
+        }
+
+        Transformation& operator*=(const Transformation& right)
+        {
+            *this = *this * right;
+            return *this;
+        }
+
+        /// The inverse transformation. Exact for uniform scales, see operator*.
+        Transformation Inverted() const
+        {
+            Quaternion<T> inverse(this->rotation);
+            inverse.Conjugate();
+
+            const Vector3<T> scale(1 / this->scale.x, 1 / this->scale.y, 1 / this->scale.z);
+            const Transformation rotation(Vector3<T>(), inverse, scale);
+            return Transformation(rotation.Apply(this->translation * static_cast<T>(-1)), inverse, scale);
+        }
+
+        /// Build the row-vector matrix for this transformation directly from the components: the rotation rows scaled
+        /// by their axis, with the translation in the last row.
+        Matrix4<T> Matrix() const
+        {
+            const Quaternion<T>& q = this->rotation;
+            const T x2 = q.x + q.x;
+            const T y2 = q.y + q.y;
+            const T z2 = q.z + q.z;
+            const T xx = q.x * x2;
+            const T yy = q.y * y2;
+            const T zz = q.z * z2;
+            const T xy = q.x * y2;
+            const T xz = q.x * z2;
+            const T yz = q.y * z2;
+            const T wx = q.w * x2;
+            const T wy = q.w * y2;
+            const T wz = q.w * z2;
+
+            const T sx = this->scale.x;
+            const T sy = this->scale.y;
+            const T sz = this->scale.z;
+            return Matrix4<T>
+                (
+                    (1 - yy - zz) * sx, (xy + wz) * sx, (xz - wy) * sx, 0,
+                    (xy - wz) * sy, (1 - xx - zz) * sy, (yz + wx) * sy, 0,
+                    (xz + wy) * sz, (yz - wx) * sz, (1 - xx - yy) * sz, 0,
+                    this->translation.x, this->translation.y, this->translation.z, 1
+                    );
+        }
+    };
+
+    using TransformationF = Transformation<float>;
+    using TransformationD = Transformation<double>;
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+namespace Dance::Three::Graphics
+{
+    /// Hands out aligned ranges of one large buffer front to back, wrapping around to the start once the end is
+    /// reached. Ranges are grouped by frame; when a frame is finished it is tagged with a fence value, and its ranges
+    /// only become reusable once that fence is retired, meaning the GPU has read everything the frame wrote. Only the
+    /// offsets are tracked here, so the same logic can sit behind any mapped buffer and be checked without a device.
+    class UploadRing
+    {
+    public:
+        /// Constant buffer offsets bound through *SetConstantBuffers1 have to be multiples of 16 constants of 16 bytes.
+        static constexpr size_t ALIGNMENT = 256;
+
+        /// A range handed out by Allocate.
+        struct Allocation
+        {
+            /// Byte offset of the range from the start of the buffer, a multiple of the alignment.
+            size_t Offset;
+
+            /// Bytes reserved, which is the requested size rounded up to the alignment.
+            size_t Size;
+        };
+
+        /// Initialize an empty ring.
+        ///
+        /// @param capacity is the size of the underlying buffer in bytes.
+        /// @param alignment is what every offset and size are rounded to, which must be a power of two.
+        explicit UploadRing(size_t capacity = 0, size_t alignment = ALIGNMENT)
+            : capacity(capacity)
+            , alignment(alignment)
+            , head(0)
+            , used(0)
+            , pending(0)
+            , frames()
+        {}
+
+        /// Reserve a range for the current frame.
+        ///
+        /// @param size is the number of bytes needed.
+        /// @param allocation receives the range on success.
+        /// @returns false if the range doesn't fit around what earlier frames still hold, in which case nothing changes
+        /// and the caller should wait for the oldest frame to retire before trying again.
+        bool Allocate(size_t size, Allocation& allocation)
+        {
+            const size_t aligned = (size + this->alignment - 1) & ~(this->alignment - 1);
+
+            // A range can't straddle the end, so skipping to the start spends whatever is left past the head
+            const bool wrap = this->head + aligned > this->capacity;
+            const size_t skipped = wrap ? this->capacity - this->head : 0;
+            if (aligned == 0 || this->used + skipped + aligned > this->capacity)
+            {
+                return false;
+            }
+
+            const size_t offset = wrap ? 0 : this->head;
+            this->head = offset + aligned;
+            this->used += skipped + aligned;
+            this->pending += skipped + aligned;
+            allocation = Allocation{ offset, aligned };
+            return true;
+        }
+
+        /// Close the current frame, holding on to everything it allocated until the fence is retired.
+        ///
+        /// @param fence identifies the frame, and must increase from one frame to the next.
+        void Finish(uint64_t fence)
+        {
+            this->frames.push_back(Frame{ fence, this->pending });
+            this->pending = 0;
+        }
+
+        /// Release every finished frame up to and including a fence.
+        ///
+        /// @param fence is the latest frame the GPU is known to have completed.
+        void Retire(uint64_t fence)
+        {
+            while (!this->frames.empty() && this->frames.front().fence <= fence)
+            {
+                this->used -= this->frames.front().bytes;
+                this->frames.pop_front();
+            }
+        }
+
+        /// Get the fence of the oldest frame still holding space.
+        ///
+        /// @returns the fence to wait on, only meaningful if InFlight is nonzero.
+        uint64_t Oldest() const
+        {
+            return this->frames.front().fence;
+        }
+
+        /// Get the number of finished frames not yet retired.
+        size_t InFlight() const
+        {
+            return this->frames.size();
+        }
+
+        /// Get the bytes held by unretired frames and the current one, including any skipped at the end.
+        size_t Used() const
+        {
+            return this->used;
+        }
+
+        /// Get the size of the underlying buffer in bytes.
+        size_t Capacity() const
+        {
+            return this->capacity;
+        }
+
+    private:
+        /// Bytes consumed by one finished frame, freed together when its fence retires.
+        struct Frame
+        {
+            uint64_t fence;
+            size_t bytes;
+        };
+
+        size_t capacity;
+        size_t alignment;
+
+        /// Where the next range starts, unless it has to wrap.
+        size_t head;
+
+        /// Bytes currently unavailable, which always lie in one run ending at the head.
+        size_t used;
+
+        /// Bytes consumed by the current, unfinished frame.
+        size_t pending;
+
+        /// Finished frames, oldest first.
+        std::deque<Frame> frames;
+    };
+}
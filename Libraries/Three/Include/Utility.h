@@ -1,51 +1,94 @@
+#pragma once
+
 #include <cmath>
+#include <limits>
 
 namespace Dance::Three::Math
 {
-    const float Pi = 3.1415926535f;
-    const float TwoPi = Pi * 2.0f;
-    const float PiOver2 = Pi / 2.0f;
+    constexpr float Pi = 3.1415926535f;
+    constexpr float TwoPi = Pi * 2.0f;
+    constexpr float PiOver2 = Pi / 2.0f;
+
+    /// Whether the caller is running, as opposed to being evaluated by the compiler, where intrinsics and most of
+    /// <cmath> aren't allowed. MSVC, GCC and Clang all provide the builtin behind C++20's std::is_constant_evaluated
+    /// in C++17 as well.
+    constexpr bool Runtime()
+    {
+        return !__builtin_is_constant_evaluated();
+    }
+
+    /// Square root that also works in constant expressions, by Newton's method when evaluated at compile time.
+    /// Starting above the root, the iterates fall monotonically until rounding stops them, within an ulp of it.
+    template<typename T>
+    constexpr T Sqrt(T value)
+    {
+        if (Runtime())
+        {
+            return std::sqrt(value);
+        }
 
-    inline float ToRadians(float degrees)
+        if (!(value > 0))
+        {
+            return value == 0 ? value : std::numeric_limits<T>::quiet_NaN();
+        }
+
+        T x = value > 1 ? value : 1;
+        while (true)
+        {
+            const T next = (x + value / x) / 2;
+            if (!(next < x))
+            {
+                return x;
+            }
+            x = next;
+        }
+    }
+
+    constexpr float ToRadians(float degrees)
     {
         return degrees * Pi / 180.0f;
     }
 
-    inline float ToDegrees(float radians)
+    constexpr float ToDegrees(float radians)
     {
         return radians * 180.0f / Pi;
     }
 
     template <typename T>
-    inline T Max(const T& a, const T& b)
+    constexpr T Max(const T& a, const T& b)
     {
         return (a < b ? b : a);
     }
 
     template <typename T>
-    inline T Min(const T& a, const T& b)
+    constexpr T Min(const T& a, const T& b)
     {
         return (a < b ? a : b);
     }
 
     template <typename T>
-    inline T Clamp(const T& value, const T& lower, const T& upper)
+    constexpr T Clamp(const T& value, const T& lower, const T& upper)
     {
         return Min(upper, Max(lower, value));
     }
 
-    inline float Lerp(float a, float b, float f)
+    constexpr float Lerp(float a, float b, float f)
     {
         return a + f * (b - a);
     }
 
-    inline bool IsZero(float val, float epsilon = 0.001f)
+    constexpr float Abs(float val)
+    {
+        return val < 0.0f ? -val : val;
+    }
+
+    constexpr bool IsZero(float val, float epsilon = 0.001f)
     {
-        return fabs(val) <= epsilon;
+        return Abs(val) <= epsilon;
     }
 
-    inline bool IsNear(float a, float b, float epsilon = 0.001f)
+    constexpr bool IsNear(float a, float b, float epsilon = 0.001f)
     {
-        return fabsf(a - b) <= epsilon * Max(Max(1.0f, fabsf(a)), fabsf(b));
+        return Abs(a - b) <= epsilon * Max(Max(1.0f, Abs(a)), Abs(b));
     }
 }
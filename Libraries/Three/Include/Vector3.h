@@ -15,23 +15,20 @@ namespace Dance::Three::Math
         T y;
         T z;
 
-        Vector3() : x(0), y(0), z(0) {}
-        explicit Vector3(T x, T y, T z) : x(x), y(y), z(z) {}
+        constexpr Vector3() : x(0), y(0), z(0) {}
+        explicit constexpr Vector3(T x, T y, T z) : x(x), y(y), z(z) {}
 
-#pragma warning(push)
-#pragma warning(disable : 26495)
-        explicit Vector3(__m128 value)
+        explicit Vector3(__m128 value) : x(0), y(0), z(0)
         {
             memcpy(this, &value, sizeof(T) * 3);
         }
-#pragma warning(pop)
 
-        friend Vector3 operator+(const Vector3& a, const Vector3& b)
+        friend constexpr Vector3 operator+(const Vector3& a, const Vector3& b)
         {
             return Vector3(a.x + b.x, a.y + b.y, a.z + b.z);
         }
 
-        Vector3& operator+=(const Vector3& v)
+        constexpr Vector3& operator+=(const Vector3& v)
         {
             this->x += v.x;
             this->y += v.y;
@@ -39,12 +36,12 @@ namespace Dance::Three::Math
             return *this;
         }
 
-        friend Vector3 operator-(const Vector3& a, const Vector3& b)
+        friend constexpr Vector3 operator-(const Vector3& a, const Vector3& b)
         {
             return Vector3(a.x - b.x, a.y - b.y, a.z - b.z);
         }
 
-        Vector3& operator-=(const Vector3& v)
+        constexpr Vector3& operator-=(const Vector3& v)
         {
             this->x -= v.x;
             this->y -= v.y;
@@ -52,22 +49,22 @@ namespace Dance::Three::Math
             return *this;
         }
 
-        friend Vector3 operator*(const Vector3& a, const Vector3& b)
+        friend constexpr Vector3 operator*(const Vector3& a, const Vector3& b)
         {
             return Vector3(a.x * b.x, a.y * b.y, a.z * b.z);
         }
 
-        friend Vector3 operator*(const Vector3& v, T s)
+        friend constexpr Vector3 operator*(const Vector3& v, T s)
         {
             return Vector3(v.x * s, v.y * s, v.z * s);
         }
 
-        friend Vector3 operator*(T s, const Vector3& v)
+        friend constexpr Vector3 operator*(T s, const Vector3& v)
         {
             return Vector3(v.x * s, v.y * s, v.z * s);
         }
 
-        Vector3& operator*=(T s)
+        constexpr Vector3& operator*=(T s)
         {
             this->x *= s;
             this->y *= s;
@@ -75,12 +72,12 @@ namespace Dance::Three::Math
             return *this;
         }
 
-        friend Vector3 operator/(const Vector3& v, T s)
+        friend constexpr Vector3 operator/(const Vector3& v, T s)
         {
             return Vector3(v.x / s, v.y / s, v.z / s);
         }
 
-        Vector3& operator/=(T s)
+        constexpr Vector3& operator/=(T s)
         {
             this->x /= s;
             this->y /= s;
@@ -88,56 +85,51 @@ namespace Dance::Three::Math
             return *this;
         }
 
-        T Magnitude() const
+        constexpr T Magnitude() const
         {
             return this->x * this->x + this->y * this->y + this->z * this->z;
         }
 
-        T Length() const
+        constexpr T Length() const
         {
-            return std::sqrt(this->Magnitude());
+            return Math::Sqrt(this->Magnitude());
         }
 
-        void Normalize()
+        constexpr void Normalize()
         {
             *this /= this->Length();
         }
 
-        Vector3 Normalized() const
+        constexpr Vector3 Normalized() const
         {
             Vector3 result(*this);
             result.Normalize();
             return result;
         }
 
-        friend T Dot(const Vector3& a, const Vector3& b)
+        friend constexpr T Dot(const Vector3& a, const Vector3& b)
         {
             return a.x * b.x + a.y * b.y + a.z * b.z;
         }
 
-        friend Vector3 Cross(const Vector3& a, const Vector3& b)
+        friend constexpr Vector3 Cross(const Vector3& a, const Vector3& b)
         {
             return Vector3(a.y * b.z - a.z * b.y, -(a.x * b.z - a.z * b.x), a.x * b.y - a.y * b.x);
         }
 
-        friend Vector3 Lerp(const Vector3& a, const Vector3& b, T f)
+        friend constexpr Vector3 Lerp(const Vector3& a, const Vector3& b, T f)
         {
             return a + f * (b - a);
         }
 
-        template<typename T>
         static constexpr Vector3<T> Zero() { return Vector3<T>(0, 0, 0); }
 
-        template<typename T>
         static constexpr Vector3<T> One() { return Vector3<T>(1, 1, 1); }
 
-        template<typename T>
         static constexpr Vector3<T> X() { return Vector3<T>(1, 0, 0); }
 
-        template<typename T>
         static constexpr Vector3<T> Y() { return Vector3<T>(0, 1, 0); }
 
-        template<typename T>
         static constexpr Vector3<T> Z() { return Vector3<T>(0, 0, 1); }
     };
 
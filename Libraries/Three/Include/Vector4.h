@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Utility.h"
+
 #include <cstring>
 #include <cmath>
 #include <xmmintrin.h>
@@ -15,23 +17,20 @@ namespace Dance::Three::Math
         T z;
         T w;
 
-        Vector4() : x(0), y(0), z(0), w(0) {}
-        explicit Vector4(T x, T y, T z, T w) : x(x), y(y), z(z), w(w) {}
+        constexpr Vector4() : x(0), y(0), z(0), w(0) {}
+        explicit constexpr Vector4(T x, T y, T z, T w) : x(x), y(y), z(z), w(w) {}
 
-#pragma warning(push)
-#pragma warning(disable : 26495)
-        explicit Vector4(__m128 value)
+        explicit Vector4(__m128 value) : x(0), y(0), z(0), w(0)
         {
             memcpy(this, &value, sizeof(T) * 4);
         }
-#pragma warning(pop)
 
-        friend Vector4 operator+(const Vector4& a, const Vector4& b)
+        friend constexpr Vector4 operator+(const Vector4& a, const Vector4& b)
         {
             return Vector4(a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w);
         }
 
-        Vector4& operator+=(const Vector4& v)
+        constexpr Vector4& operator+=(const Vector4& v)
         {
             this->x += v.x;
             this->y += v.y;
@@ -40,12 +39,12 @@ namespace Dance::Three::Math
             return *this;
         }
 
-        friend Vector4 operator-(const Vector4& a, const Vector4& b)
+        friend constexpr Vector4 operator-(const Vector4& a, const Vector4& b)
         {
             return Vector4(a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w);
         }
 
-        Vector4& operator-=(const Vector4& v)
+        constexpr Vector4& operator-=(const Vector4& v)
         {
             this->x -= v.x;
             this->y -= v.y;
@@ -54,22 +53,22 @@ namespace Dance::Three::Math
             return *this;
         }
 
-        friend Vector4 operator*(const Vector4& a, const Vector4& b)
+        friend constexpr Vector4 operator*(const Vector4& a, const Vector4& b)
         {
             return Vector4(a.x * b.x, a.y * b.y, a.z * b.z, a.w * b.w);
         }
 
-        friend Vector4 operator*(const Vector4& v, T s)
+        friend constexpr Vector4 operator*(const Vector4& v, T s)
         {
             return Vector4(v.x * s, v.y * s, v.z * s, v.w * s);
         }
 
-        friend Vector4 operator*(T s, const Vector4& v)
+        friend constexpr Vector4 operator*(T s, const Vector4& v)
         {
             return Vector4(v.x * s, v.y * s, v.z * s, v.w * s);
         }
 
-        Vector4& operator*=(T s)
+        constexpr Vector4& operator*=(T s)
         {
             this->x *= s;
             this->y *= s;
@@ -78,12 +77,12 @@ namespace Dance::Three::Math
             return *this;
         }
 
-        friend Vector4 operator/(const Vector4& v, T s)
+        friend constexpr Vector4 operator/(const Vector4& v, T s)
         {
             return Vector4(v.x / s, v.y / s, v.z / s, v.w / s);
         }
 
-        Vector4& operator/=(T s)
+        constexpr Vector4& operator/=(T s)
         {
             this->x /= s;
             this->y /= s;
@@ -92,49 +91,43 @@ namespace Dance::Three::Math
             return *this;
         }
 
-        T Magnitude() const
+        constexpr T Magnitude() const
         {
             return this->x * this->x + this->y * this->y + this->z * this->z + this->w * this->w;
         }
 
-        T Length() const
+        constexpr T Length() const
         {
-            return std::sqrt(this->Magnitude());
+            return Math::Sqrt(this->Magnitude());
         }
 
-        void Normalize()
+        constexpr void Normalize()
         {
             *this /= this->Length();
         }
 
-        Vector4 Normalized() const
+        constexpr Vector4 Normalized() const
         {
             Vector4 result(*this);
             result.Normalize();
             return result;
         }
 
-        friend Vector4 Lerp(const Vector4& a, const Vector4& b, T f)
+        friend constexpr Vector4 Lerp(const Vector4& a, const Vector4& b, T f)
         {
             return a + f * (b - a);
         }
 
-        template<typename T>
         static constexpr Vector4<T> Zero() { return Vector4<T>(0, 0, 0, 0); }
 
-        template<typename T>
         static constexpr Vector4<T> One() { return Vector4<T>(1, 1, 1, 1); }
 
-        template<typename T>
         static constexpr Vector4<T> X() { return Vector4<T>(1, 0, 0, 0); }
 
-        template<typename T>
         static constexpr Vector4<T> Y() { return Vector4<T>(0, 1, 0, 0); }
 
-        template<typename T>
         static constexpr Vector4<T> Z() { return Vector4<T>(0, 0, 1, 0); }
 
-        template<typename T>
         static constexpr Vector4<T> W() { return Vector4<T>(0, 0, 0, 1); }
     };
 
@@ -1,4 +1,5 @@
 #include "ThreeVisualizer.h"
+#include "Buffer.h"
 #include "Macro.h"
 
 namespace Dance::Three
@@ -21,6 +22,13 @@ namespace Dance::Three
 		this->d3dDeviceContext->OMSetDepthStencilState(depthStencilState.Get(), 0);
 	}
 
+	ThreeVisualizer::~ThreeVisualizer()
+	{
+		const Graphics::ConstantStatistics& statistics = Graphics::ConstantUploads;
+		TRACE("uploaded " << statistics.Uploaded << " constant buffers and skipped " << statistics.Skipped
+			<< " that hadn't changed");
+	}
+
 	HRESULT ThreeVisualizer::CreateRenderTarget()
 	{
 		// Build the backbuffer
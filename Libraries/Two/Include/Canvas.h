@@ -0,0 +1,248 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace Dance::Two
+{
+    /// A color with straight alpha and channels in [0, 1], like D2D1_COLOR_F.
+    struct Color
+    {
+        float R;
+        float G;
+        float B;
+        float A;
+    };
+
+    /// A position in pixels from the top left of the target, like D2D1_POINT_2F.
+    struct Point
+    {
+        float X;
+        float Y;
+    };
+
+    /// An axis-aligned rectangle in pixels, like D2D1_RECT_F.
+    struct Rect
+    {
+        float Left;
+        float Top;
+        float Right;
+        float Bottom;
+    };
+
+    /// A color at a position along a gradient, like D2D1_GRADIENT_STOP.
+    struct GradientStop
+    {
+        float Position;
+        Two::Color Color;
+    };
+
+    /// What a shape is filled with: a single color, or colors blended along the line from Start to End and clamped to
+    /// the end colors past either end, like Direct2D's solid and linear gradient brushes.
+    class Paint
+    {
+    public:
+        /// Paint with a single color.
+        static Paint Solid(const Color& color)
+        {
+            Paint paint;
+            paint.color = color;
+            return paint;
+        }
+
+        /// Paint with a linear gradient.
+        ///
+        /// @param start is where the gradient's position is zero.
+        /// @param end is where the gradient's position is one.
+        /// @param stops are the colors to blend between, in any order.
+        static Paint Linear(const Point& start, const Point& end, std::vector<GradientStop> stops)
+        {
+            std::stable_sort(stops.begin(), stops.end(), [](const GradientStop& a, const GradientStop& b) { return a.Position < b.Position; });
+            Paint paint;
+            paint.start = start;
+            paint.end = end;
+            paint.stops = std::move(stops);
+            return paint;
+        }
+
+        /// Whether this is a gradient rather than a single color.
+        bool Gradient() const
+        {
+            return !this->stops.empty();
+        }
+
+        /// Get the color of a solid paint.
+        const Color& SolidColor() const
+        {
+            return this->color;
+        }
+
+        const Point& Start() const
+        {
+            return this->start;
+        }
+
+        const Point& End() const
+        {
+            return this->end;
+        }
+
+        /// Get a gradient's stops in order of position.
+        const std::vector<GradientStop>& Stops() const
+        {
+            return this->stops;
+        }
+
+    private:
+        Color color{};
+        Point start{};
+        Point end{};
+        std::vector<GradientStop> stops;
+    };
+
+    /// How overlapping parts of a figure are filled, like D2D1_FILL_MODE.
+    enum class FillRule
+    {
+        /// Points are inside if a ray from them crosses the outline an odd number of times, Direct2D's default.
+        EvenOdd,
+
+        /// Points are inside if the outline winds around them at all.
+        NonZero,
+    };
+
+    /// An outline made of straight and curved segments, like an ID2D1PathGeometry built through its sink. Curves are
+    /// flattened into lines as they're added, so every backend fills exactly the same polygon.
+    class Figure
+    {
+    public:
+        /// A connected run of points.
+        struct Contour
+        {
+            std::vector<Point> Points;
+
+            /// Whether the last point joins back to the first when stroked. Filling always closes a contour.
+            bool Closed;
+        };
+
+        /// Initialize an empty figure.
+        ///
+        /// @param rule decides which overlapping regions are inside.
+        explicit Figure(FillRule rule = FillRule::EvenOdd)
+            : rule(rule)
+        {}
+
+        /// Start a new contour.
+        Figure& MoveTo(const Point& point)
+        {
+            this->contours.push_back({ { point }, false });
+            return *this;
+        }
+
+        /// Add a straight segment from the last point, starting a contour if there isn't one.
+        Figure& LineTo(const Point& point)
+        {
+            if (this->contours.empty())
+            {
+                return this->MoveTo(point);
+            }
+            this->contours.back().Points.push_back(point);
+            return *this;
+        }
+
+        /// Add a cubic Bezier curve from the last point, flattened into enough segments that none strays more than
+        /// about a tenth of a pixel from the curve.
+        Figure& BezierTo(const Point& first, const Point& second, const Point& end)
+        {
+            if (this->contours.empty())
+            {
+                this->MoveTo(first);
+            }
+            const Point from = this->contours.back().Points.back();
+
+            // Segments of a curve stray from it by at most an eighth of its largest second derivative over the square of
+            // their number, and the control polygon bounds that derivative
+            const float dx = std::max(std::fabs(from.X - 2.0f * first.X + second.X), std::fabs(first.X - 2.0f * second.X + end.X));
+            const float dy = std::max(std::fabs(from.Y - 2.0f * first.Y + second.Y), std::fabs(first.Y - 2.0f * second.Y + end.Y));
+            const float deviation = std::sqrt(dx * dx + dy * dy) * 0.75f;
+            const size_t segments = std::clamp(static_cast<size_t>(std::ceil(std::sqrt(deviation / TOLERANCE))), size_t{ 1 }, size_t{ 256 });
+
+            for (size_t i = 1; i <= segments; ++i)
+            {
+                const float t = static_cast<float>(i) / segments;
+                const float u = 1.0f - t;
+                const float a = u * u * u;
+                const float b = 3.0f * u * u * t;
+                const float c = 3.0f * u * t * t;
+                const float d = t * t * t;
+                this->contours.back().Points.push_back({
+                    a * from.X + b * first.X + c * second.X + d * end.X,
+                    a * from.Y + b * first.Y + c * second.Y + d * end.Y });
+            }
+            return *this;
+        }
+
+        /// Join the current contour back to its first point.
+        Figure& Close()
+        {
+            if (!this->contours.empty())
+            {
+                this->contours.back().Closed = true;
+            }
+            return *this;
+        }
+
+        FillRule Rule() const
+        {
+            return this->rule;
+        }
+
+        const std::vector<Contour>& Contours() const
+        {
+            return this->contours;
+        }
+
+    private:
+        /// Largest distance in pixels between a flattened curve and the real one.
+        static constexpr float TOLERANCE = 0.1f;
+
+        FillRule rule;
+        std::vector<Contour> contours;
+    };
+
+    /// Draws 2D shapes into whatever target a backend wraps. TwoVisualizer draws through D2dCanvas into the swap chain,
+    /// and CpuCanvas draws the same calls into memory, so a visualizer written against this renders without a GPU.
+    /// Shapes are antialiased and blended over what's already there.
+    class Canvas
+    {
+    public:
+        virtual ~Canvas() = default;
+
+        /// Start a frame, like ID2D1RenderTarget::BeginDraw.
+        virtual void Begin() = 0;
+
+        /// Finish a frame, like ID2D1RenderTarget::EndDraw.
+        virtual void End() = 0;
+
+        /// Replace every pixel with a color.
+        virtual void Clear(const Color& color) = 0;
+
+        /// Fill a rectangle.
+        virtual void FillRectangle(const Rect& rect, const Paint& paint) = 0;
+
+        /// Stroke a straight line with flat ends.
+        ///
+        /// @param width is the thickness of the line in pixels.
+        virtual void DrawLine(const Point& from, const Point& to, const Paint& paint, float width = 1.0f) = 0;
+
+        /// Fill the inside of a figure according to its fill rule.
+        virtual void FillFigure(const Figure& figure, const Paint& paint) = 0;
+
+        /// Stroke the outline of a figure with flat ends and beveled joins.
+        ///
+        /// @param width is the thickness of the outline in pixels.
+        virtual void DrawFigure(const Figure& figure, const Paint& paint, float width = 1.0f) = 0;
+    };
+}
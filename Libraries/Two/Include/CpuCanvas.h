@@ -0,0 +1,616 @@
+#pragma once
+
+#include "Canvas.h"
+#include "Lanes.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace Dance::Two
+{
+    /// Pack a straight alpha color as premultiplied B8G8R8A8, the format TwoVisualizer's target bitmap uses.
+    inline uint32_t ToPremultipliedBgra8(const Color& color)
+    {
+        const auto byte = [](float channel)
+        {
+            const float clamped = channel < 0.0f ? 0.0f : channel > 1.0f ? 1.0f : channel;
+            return static_cast<uint32_t>(clamped * 255.0f + 0.5f);
+        };
+        const float alpha = color.A < 0.0f ? 0.0f : color.A > 1.0f ? 1.0f : color.A;
+        return byte(color.B * alpha) | byte(color.G * alpha) << 8 | byte(color.R * alpha) << 16 | byte(alpha) << 24;
+    }
+
+    /// A premultiplied B8G8R8A8 image in memory, row by row from the top left, like the swap chain surface
+    /// TwoVisualizer draws into.
+    class Surface
+    {
+    public:
+        /// Allocate the image, cleared to transparent black.
+        ///
+        /// @param width is the width in pixels.
+        /// @param height is the height in pixels.
+        explicit Surface(uint32_t width = 0, uint32_t height = 0)
+            : width(width)
+            , height(height)
+            , pixels(static_cast<size_t>(width) * height, 0)
+        {}
+
+        uint32_t Width() const
+        {
+            return this->width;
+        }
+
+        uint32_t Height() const
+        {
+            return this->height;
+        }
+
+        /// Get the packed color of a pixel.
+        uint32_t Pixel(uint32_t x, uint32_t y) const
+        {
+            return this->pixels[static_cast<size_t>(y) * this->width + x];
+        }
+
+        /// Get the pixels, width per row.
+        uint32_t* Pixels()
+        {
+            return this->pixels.data();
+        }
+
+        const uint32_t* Pixels() const
+        {
+            return this->pixels.data();
+        }
+
+        /// Count the pixels that differ from another surface's by more than a tolerance in any channel, for comparing
+        /// against a golden image drawn by another backend, whose antialiasing rounds differently.
+        ///
+        /// @param other must have the same size.
+        /// @param tolerance is the largest difference per 8-bit channel that still counts as equal.
+        size_t Differences(const Surface& other, uint32_t tolerance = 0) const
+        {
+            size_t count = 0;
+            for (size_t i = 0; i < this->pixels.size(); ++i)
+            {
+                for (uint32_t shift = 0; shift < 32; shift += 8)
+                {
+                    const int a = static_cast<int>((this->pixels[i] >> shift) & 0xFF);
+                    const int b = static_cast<int>((other.pixels[i] >> shift) & 0xFF);
+                    if (static_cast<uint32_t>(a > b ? a - b : b - a) > tolerance)
+                    {
+                        count += 1;
+                        break;
+                    }
+                }
+            }
+            return count;
+        }
+
+        /// Hash the pixels with 64-bit FNV-1a, for golden images kept as a single number.
+        uint64_t Hash() const
+        {
+            uint64_t hash = 14695981039346656037ull;
+            for (const uint32_t pixel : this->pixels)
+            {
+                for (uint32_t shift = 0; shift < 32; shift += 8)
+                {
+                    hash = (hash ^ ((pixel >> shift) & 0xFF)) * 1099511628211ull;
+                }
+            }
+            return hash;
+        }
+
+    private:
+        uint32_t width;
+        uint32_t height;
+        std::vector<uint32_t> pixels;
+    };
+
+    /// Draws into a Surface on the CPU with a scanline rasterizer, so 2D visualizers run without Direct2D.
+    ///
+    /// Every shape becomes a set of edges. Each pixel row is crossed by SAMPLES evenly spaced scanlines, and the spans
+    /// between crossings that the fill rule puts inside add their exact horizontal extent to the row's coverage, which
+    /// gives antialiasing good to 1 / SAMPLES vertically and exact horizontally. The covered part of the row is then
+    /// shaded and blended source-over, as many pixels at a time as the build's lanes allow.
+    class CpuCanvas : public Canvas
+    {
+    public:
+        /// Scanlines per pixel row.
+        static constexpr int32_t SAMPLES = 16;
+
+        /// Initialize a canvas drawing into a surface, which must outlive it.
+        explicit CpuCanvas(Surface& target)
+            : target(target)
+        {}
+
+        virtual void Begin()
+        {}
+
+        virtual void End()
+        {}
+
+        virtual void Clear(const Color& color)
+        {
+            std::fill(this->target.Pixels(), this->target.Pixels() + static_cast<size_t>(this->target.Width()) * this->target.Height(), ToPremultipliedBgra8(color));
+        }
+
+        virtual void FillRectangle(const Rect& rect, const Paint& paint)
+        {
+            const Point corners[4] = { { rect.Left, rect.Top }, { rect.Right, rect.Top }, { rect.Right, rect.Bottom }, { rect.Left, rect.Bottom } };
+            this->AddPolygon(corners, 4);
+            this->Fill(FillRule::NonZero, paint);
+        }
+
+        virtual void DrawLine(const Point& from, const Point& to, const Paint& paint, float width = 1.0f)
+        {
+            this->AddSegment(from, to, width);
+            this->Fill(FillRule::NonZero, paint);
+        }
+
+        virtual void FillFigure(const Figure& figure, const Paint& paint)
+        {
+            for (const Figure::Contour& contour : figure.Contours())
+            {
+                const std::vector<Point>& points = contour.Points;
+                for (size_t i = 0; i < points.size(); ++i)
+                {
+                    this->AddEdge(points[i], points[(i + 1) % points.size()]);
+                }
+            }
+            this->Fill(figure.Rule(), paint);
+        }
+
+        virtual void DrawFigure(const Figure& figure, const Paint& paint, float width = 1.0f)
+        {
+            // Every segment and join is added as its own clockwise polygon, so the non-zero rule fills their union
+            for (const Figure::Contour& contour : figure.Contours())
+            {
+                const std::vector<Point>& points = contour.Points;
+                const size_t segments = contour.Closed ? points.size() : points.size() - 1;
+                for (size_t i = 0; i < segments; ++i)
+                {
+                    const Point& from = points[i];
+                    const Point& to = points[(i + 1) % points.size()];
+                    this->AddSegment(from, to, width);
+
+                    // Bevel into the next segment, filling the notch on the outside of the turn
+                    if (i + 1 < segments || contour.Closed)
+                    {
+                        const Point& next = points[(i + 2) % points.size()];
+                        const Point before = Offset(from, to, width);
+                        const Point after = Offset(to, next, width);
+                        const Point bevel[3] = { to, { to.X + before.X, to.Y + before.Y }, { to.X + after.X, to.Y + after.Y } };
+                        const Point opposite[3] = { to, { to.X - before.X, to.Y - before.Y }, { to.X - after.X, to.Y - after.Y } };
+                        this->AddPolygon(bevel, 3);
+                        this->AddPolygon(opposite, 3);
+                    }
+                }
+            }
+            this->Fill(FillRule::NonZero, paint);
+        }
+
+    private:
+        /// A non-horizontal edge, from its top to its bottom.
+        struct Edge
+        {
+            float Top;
+            float Bottom;
+
+            /// Where the edge is at its top, and how far it moves right per pixel down.
+            float X;
+            float Slope;
+
+            /// One if the outline runs down the edge, minus one if it runs up.
+            int Direction;
+
+            /// Where the edge last crossed a scanline, or would have if it reached it.
+            float Crossing;
+        };
+
+        /// A gradient segment over which each premultiplied channel changes linearly.
+        struct Ramp
+        {
+            float Start;
+            float Scale;
+            float Change[4];
+        };
+
+        /// Half a stroke's width, perpendicular to the segment from one point to another, pointing left of it on screen.
+        static Point Offset(const Point& from, const Point& to, float width)
+        {
+            const float dx = to.X - from.X;
+            const float dy = to.Y - from.Y;
+            const float length = std::sqrt(dx * dx + dy * dy);
+            if (!(length > 0.0f))
+            {
+                return { 0.0f, 0.0f };
+            }
+            const float half = width * 0.5f / length;
+            return { dy * half, -dx * half };
+        }
+
+        void AddEdge(const Point& from, const Point& to)
+        {
+            if (from.Y == to.Y || !std::isfinite(from.X) || !std::isfinite(from.Y) || !std::isfinite(to.X) || !std::isfinite(to.Y))
+            {
+                return;
+            }
+            const bool down = to.Y > from.Y;
+            const Point& top = down ? from : to;
+            const Point& bottom = down ? to : from;
+            this->edges.push_back({ top.Y, bottom.Y, top.X, (bottom.X - top.X) / (bottom.Y - top.Y), down ? 1 : -1, top.X });
+        }
+
+        /// Add a closed polygon, turned clockwise on screen so that overlapping polygons add their windings.
+        void AddPolygon(const Point* points, size_t count)
+        {
+            float area = 0.0f;
+            for (size_t i = 0; i < count; ++i)
+            {
+                const Point& a = points[i];
+                const Point& b = points[(i + 1) % count];
+                area += a.X * b.Y - a.Y * b.X;
+            }
+            if (area == 0.0f)
+            {
+                return;
+            }
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (area > 0.0f)
+                {
+                    this->AddEdge(points[i], points[(i + 1) % count]);
+                }
+                else
+                {
+                    this->AddEdge(points[(i + 1) % count], points[i]);
+                }
+            }
+        }
+
+        /// Add the rectangle a stroke of a segment covers, with flat ends.
+        void AddSegment(const Point& from, const Point& to, float width)
+        {
+            const Point offset = Offset(from, to, width);
+            const Point corners[4] =
+            {
+                { from.X + offset.X, from.Y + offset.Y },
+                { to.X + offset.X, to.Y + offset.Y },
+                { to.X - offset.X, to.Y - offset.Y },
+                { from.X - offset.X, from.Y - offset.Y },
+            };
+            this->AddPolygon(corners, 4);
+        }
+
+        /// Rasterize the edges added since the last fill and blend the paint over what they cover.
+        void Fill(FillRule rule, const Paint& paint)
+        {
+            const int32_t width = static_cast<int32_t>(this->target.Width());
+            const int32_t height = static_cast<int32_t>(this->target.Height());
+            if (this->edges.empty() || width == 0 || height == 0)
+            {
+                this->edges.clear();
+                return;
+            }
+
+            float top = this->edges[0].Top;
+            float bottom = this->edges[0].Bottom;
+            float left = this->edges[0].X;
+            float right = this->edges[0].X;
+            for (const Edge& edge : this->edges)
+            {
+                const float end = edge.X + edge.Slope * (edge.Bottom - edge.Top);
+                top = std::min(top, edge.Top);
+                bottom = std::max(bottom, edge.Bottom);
+                left = std::min({ left, edge.X, end });
+                right = std::max({ right, edge.X, end });
+            }
+            const int32_t firstRow = static_cast<int32_t>(std::max(0.0f, std::floor(top)));
+            const int32_t lastRow = static_cast<int32_t>(std::min(static_cast<float>(height), std::ceil(bottom)));
+            const int32_t firstColumn = static_cast<int32_t>(std::max(0.0f, std::floor(left)));
+            const int32_t lastColumn = static_cast<int32_t>(std::min(static_cast<float>(width), std::ceil(right)));
+            if (firstRow >= lastRow || firstColumn >= lastColumn)
+            {
+                this->edges.clear();
+                return;
+            }
+
+            this->Prepare(paint);
+            this->partial.assign(static_cast<size_t>(width) + 1, 0);
+            this->steps.assign(static_cast<size_t>(width) + 1, 0);
+            this->coverage.resize(static_cast<size_t>(width));
+            std::sort(this->edges.begin(), this->edges.end(), [](const Edge& a, const Edge& b) { return a.Top < b.Top; });
+
+            size_t next = 0;
+            bool repeated = false;
+            this->active.clear();
+            for (int32_t row = firstRow; row < lastRow; ++row)
+            {
+                // Keep the edges that reach into this row
+                while (next < this->edges.size() && this->edges[next].Top < static_cast<float>(row + 1))
+                {
+                    this->active.push_back(&this->edges[next++]);
+                }
+                this->active.erase(std::remove_if(this->active.begin(), this->active.end(), [row](const Edge* edge) { return edge->Bottom <= static_cast<float>(row); }), this->active.end());
+
+                // When every edge crossing the row runs straight down through all of it, as a rectangle's do, every
+                // scanline sees the same spans, so one does for all of them, and if it crosses the same places as the
+                // row above, that row's coverage does too
+                bool uniform = true;
+                for (const Edge* edge : this->active)
+                {
+                    uniform = uniform && edge->Slope == 0.0f && edge->Top <= static_cast<float>(row) && edge->Bottom >= static_cast<float>(row + 1);
+                }
+
+                if (uniform)
+                {
+                    this->Cross(static_cast<float>(row) + 0.5f);
+                    if (!repeated || this->crossings != this->previous)
+                    {
+                        this->touched = { width, 0 };
+                        this->Spans(rule, FULL, width);
+                        this->Accumulate(width);
+                        this->previous = this->crossings;
+                        repeated = true;
+                    }
+                }
+                else
+                {
+                    this->touched = { width, 0 };
+                    for (int32_t sample = 0; sample < SAMPLES; ++sample)
+                    {
+                        this->Cross(static_cast<float>(row) + (static_cast<float>(sample) + 0.5f) / SAMPLES);
+                        this->Spans(rule, FULL / SAMPLES, width);
+                    }
+                    this->Accumulate(width);
+                    repeated = false;
+                }
+
+                if (this->touched.first < this->touched.second)
+                {
+                    this->Blend(row, this->touched.first, this->touched.second);
+                }
+            }
+            this->edges.clear();
+        }
+
+        /// Find where the active edges cross a scanline, in order. Edges keep their order from one scanline to the
+        /// next unless they cross, so the active edges are kept sorted by where they last crossed, and an insertion
+        /// sort has little to do.
+        void Cross(float y)
+        {
+            this->crossings.clear();
+            for (size_t i = 0; i < this->active.size(); ++i)
+            {
+                Edge* edge = this->active[i];
+                edge->Crossing = edge->X + (std::clamp(y, edge->Top, edge->Bottom) - edge->Top) * edge->Slope;
+                size_t j = i;
+                for (; j > 0 && this->active[j - 1]->Crossing > edge->Crossing; --j)
+                {
+                    this->active[j] = this->active[j - 1];
+                }
+                this->active[j] = edge;
+            }
+            for (const Edge* edge : this->active)
+            {
+                if (y >= edge->Top && y < edge->Bottom)
+                {
+                    this->crossings.emplace_back(edge->Crossing, edge->Direction);
+                }
+            }
+        }
+
+        /// Add the spans between crossings that the fill rule puts inside to the row's coverage.
+        void Spans(FillRule rule, int32_t weight, int32_t width)
+        {
+            int winding = 0;
+            for (size_t i = 0; i + 1 < this->crossings.size(); ++i)
+            {
+                winding += this->crossings[i].second;
+                const bool inside = rule == FillRule::NonZero ? winding != 0 : (winding & 1) != 0;
+                if (inside)
+                {
+                    this->Span(this->crossings[i].first, this->crossings[i + 1].first, weight, width);
+                }
+            }
+        }
+
+        /// Add a span of one scanline, in pixels, to the row's coverage.
+        void Span(float from, float to, int32_t weight, int32_t width)
+        {
+            from = std::clamp(from, 0.0f, static_cast<float>(width));
+            to = std::clamp(to, 0.0f, static_cast<float>(width));
+            if (!(to > from))
+            {
+                return;
+            }
+
+            const int32_t first = static_cast<int32_t>(from);
+            const int32_t last = static_cast<int32_t>(to);
+            const float scale = static_cast<float>(weight);
+            this->touched.first = std::min(this->touched.first, first);
+            this->touched.second = std::max(this->touched.second, std::min(last + 1, width));
+            if (first == last)
+            {
+                this->partial[first] += static_cast<int32_t>(scale * (to - from) + 0.5f);
+                return;
+            }
+
+            // Partly covered pixels at the ends, and a step up and back down over the fully covered ones between
+            this->partial[first] += static_cast<int32_t>(scale * (static_cast<float>(first + 1) - from) + 0.5f);
+            this->steps[first + 1] += weight;
+            this->steps[last] -= weight;
+            this->partial[last] += static_cast<int32_t>(scale * (to - static_cast<float>(last)) + 0.5f);
+        }
+
+        /// Sum the steps along the touched part of the row into coverage, clearing them and the partial coverage for
+        /// the next row. The sums are integers so that each pixel waits on a one cycle add rather than a float add.
+        void Accumulate(int32_t width)
+        {
+            int32_t running = 0;
+            for (int32_t x = this->touched.first; x < this->touched.second; ++x)
+            {
+                running += this->steps[x];
+                this->coverage[x] = static_cast<float>(running + this->partial[x]) * (1.0f / FULL);
+                this->steps[x] = 0;
+                this->partial[x] = 0;
+            }
+
+            // A span reaching the right side steps down just past it
+            this->steps[width] = 0;
+            this->partial[width] = 0;
+        }
+
+        /// Turn a paint into a base color and the ramps a gradient adds to it, premultiplied.
+        void Prepare(const Paint& paint)
+        {
+            const std::vector<GradientStop>& stops = paint.Stops();
+            const auto premultiply = [](const Color& color, float (&out)[4])
+            {
+                const float alpha = std::clamp(color.A, 0.0f, 1.0f);
+                out[0] = std::clamp(color.B, 0.0f, 1.0f) * alpha;
+                out[1] = std::clamp(color.G, 0.0f, 1.0f) * alpha;
+                out[2] = std::clamp(color.R, 0.0f, 1.0f) * alpha;
+                out[3] = alpha;
+            };
+
+            this->ramps.clear();
+            if (!paint.Gradient())
+            {
+                premultiply(paint.SolidColor(), this->base);
+                this->opaque = this->base[3] == 1.0f;
+                const Three::Math::Simd::Float1 bytes[4] = { this->base[0] * 255.0f, this->base[1] * 255.0f, this->base[2] * 255.0f, this->base[3] * 255.0f };
+                Three::Math::Simd::Float1::Pack(bytes, &this->packed);
+                return;
+            }
+
+            premultiply(stops.front().Color, this->base);
+            this->opaque = std::all_of(stops.begin(), stops.end(), [](const GradientStop& stop) { return stop.Color.A >= 1.0f; });
+            for (size_t i = 1; i < stops.size(); ++i)
+            {
+                float from[4];
+                float to[4];
+                premultiply(stops[i - 1].Color, from);
+                premultiply(stops[i].Color, to);
+
+                // A stop at the same position as the last one is a hard step
+                const float length = stops[i].Position - stops[i - 1].Position;
+                Ramp ramp{ stops[i - 1].Position, length > 0.0f ? 1.0f / length : 1e30f, {} };
+                for (size_t c = 0; c < 4; ++c)
+                {
+                    ramp.Change[c] = to[c] - from[c];
+                }
+                this->ramps.push_back(ramp);
+            }
+
+            // Position along the gradient is the offset from its start projected onto its direction
+            const float dx = paint.End().X - paint.Start().X;
+            const float dy = paint.End().Y - paint.Start().Y;
+            const float length = dx * dx + dy * dy;
+            this->origin = paint.Start();
+            this->direction = length > 0.0f ? Point{ dx / length, dy / length } : Point{ 0.0f, 0.0f };
+        }
+
+        /// Blend the prepared paint over one row wherever it's covered.
+        void Blend(int32_t row, int32_t first, int32_t last)
+        {
+            uint32_t* pixels = this->target.Pixels() + static_cast<size_t>(row) * this->target.Width();
+            const float py = static_cast<float>(row) + 0.5f - this->origin.Y;
+
+            Three::Math::Simd::Sweep(static_cast<size_t>(last - first), [&](auto lane, size_t i)
+            {
+                using L = decltype(lane);
+                const int32_t x = first + static_cast<int32_t>(i);
+                const L zero = L::Broadcast(0.0f);
+                const L one = L::Broadcast(1.0f);
+                const L cover = Min(L::Load(this->coverage.data() + x), one);
+                if (Bits(cover > zero) == 0)
+                {
+                    return;
+                }
+
+                if (this->opaque && this->ramps.empty() && Bits(cover >= one) == (1 << L::Width) - 1)
+                {
+                    std::fill(pixels + x, pixels + x + L::Width, this->packed);
+                    return;
+                }
+
+                L source[4] = { L::Broadcast(this->base[0]), L::Broadcast(this->base[1]), L::Broadcast(this->base[2]), L::Broadcast(this->base[3]) };
+                if (!this->ramps.empty())
+                {
+                    const L px = L::Load(OFFSETS) + L::Broadcast(static_cast<float>(x) + 0.5f - this->origin.X);
+                    const L t = px * L::Broadcast(this->direction.X) + L::Broadcast(py * this->direction.Y);
+                    for (const Ramp& ramp : this->ramps)
+                    {
+                        const L amount = Min(Max((t - L::Broadcast(ramp.Start)) * L::Broadcast(ramp.Scale), zero), one);
+                        for (size_t c = 0; c < 4; ++c)
+                        {
+                            source[c] = source[c] + amount * L::Broadcast(ramp.Change[c]);
+                        }
+                    }
+                }
+
+                // An opaque paint covering every pixel replaces them without reading them, and otherwise it's blended
+                // source over, with premultiplied colors in units of the stored bytes
+                L channels[4];
+                if (this->opaque && Bits(cover >= one) == (1 << L::Width) - 1)
+                {
+                    for (size_t c = 0; c < 4; ++c)
+                    {
+                        channels[c] = source[c] * L::Broadcast(255.0f);
+                    }
+                }
+                else
+                {
+                    L::Unpack(pixels + x, channels);
+                    const L keep = one - source[3] * cover;
+                    const L scale = cover * L::Broadcast(255.0f);
+                    for (size_t c = 0; c < 4; ++c)
+                    {
+                        channels[c] = source[c] * scale + channels[c] * keep;
+                    }
+                }
+                L::Pack(channels, pixels + x);
+            });
+        }
+
+        /// Coverage of a whole pixel, in the units rows are accumulated in.
+        static constexpr int32_t FULL = 4096;
+
+        /// Offsets of each lane's pixel from the first.
+        static constexpr float OFFSETS[8] = { 0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f };
+
+        Surface& target;
+
+        /// Edges of the shape being filled, and those crossing the current row.
+        std::vector<Edge> edges;
+        std::vector<Edge*> active;
+
+        /// Where each edge crosses the current scanline, and its direction.
+        std::vector<std::pair<float, int>> crossings;
+
+        /// Where the edges crossed the last row that every scanline crossed alike.
+        std::vector<std::pair<float, int>> previous;
+
+        /// Coverage of the current row in units of FULL: fractions of partly covered pixels, and steps in the level
+        /// of fully covered runs. Then their total, from zero to one.
+        std::vector<int32_t> partial;
+        std::vector<int32_t> steps;
+        std::vector<float> coverage;
+
+        /// The columns the current row's spans reached, from the first to one past the last.
+        std::pair<int32_t, int32_t> touched;
+
+        /// The prepared paint, whether it's opaque everywhere, and a solid paint's packed color.
+        float base[4] = {};
+        bool opaque = false;
+        uint32_t packed = 0;
+        std::vector<Ramp> ramps;
+        Point origin{};
+        Point direction{};
+    };
+}
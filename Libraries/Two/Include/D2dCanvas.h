@@ -0,0 +1,40 @@
+#pragma once
+
+#include <windows.h>
+#include <d2d1_2.h>
+
+#include "Canvas.h"
+#include "Pointer.h"
+
+namespace Dance::Two
+{
+    /// Draws through a Direct2D device context into whatever target it has set, which is how TwoVisualizer draws into
+    /// the swap chain. Brushes and the stroke style are made once and reused, except gradient brushes, which are made
+    /// for each shape that uses one.
+    class D2dCanvas : public Canvas
+    {
+    public:
+        /// Initialize a canvas drawing through a device context.
+        D2dCanvas(ComPtr<ID2D1DeviceContext> context);
+
+        virtual void Begin();
+        virtual void End();
+        virtual void Clear(const Color& color);
+        virtual void FillRectangle(const Rect& rect, const Paint& paint);
+        virtual void DrawLine(const Point& from, const Point& to, const Paint& paint, float width = 1.0f);
+        virtual void FillFigure(const Figure& figure, const Paint& paint);
+        virtual void DrawFigure(const Figure& figure, const Paint& paint, float width = 1.0f);
+
+    protected:
+        ComPtr<ID2D1DeviceContext> context;
+        ComPtr<ID2D1Factory> factory;
+        ComPtr<ID2D1SolidColorBrush> solid;
+        ComPtr<ID2D1StrokeStyle> stroke;
+
+        /// Get a brush for a paint.
+        ComPtr<ID2D1Brush> Brush(const Paint& paint);
+
+        /// Build a path geometry from a figure's flattened contours.
+        ComPtr<ID2D1PathGeometry> Geometry(const Figure& figure);
+    };
+}
@@ -2,6 +2,9 @@
 
 #include "Visualizer.h"
 #include "Pointer.h"
+#include "D2dCanvas.h"
+
+#include <memory>
 
 namespace Dance::Two
 {
@@ -20,6 +23,10 @@ namespace Dance::Two
         ComPtr<ID2D1Bitmap1> d2dBitmap;
         ComPtr<ID2D1DeviceContext> d2dDeviceContext;
 
+        /// Draws through the device context into the swap chain. Draw through this rather than the device context so
+        /// the same code can render into a CpuCanvas.
+        std::unique_ptr<Canvas> canvas;
+
         HRESULT CreateSurface();
         HRESULT ReleaseSurface();
         HRESULT CreateBitmap();
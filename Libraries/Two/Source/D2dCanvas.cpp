@@ -0,0 +1,127 @@
+#include "D2dCanvas.h"
+#include "Macro.h"
+
+#include <vector>
+
+namespace Dance::Two
+{
+	static_assert(sizeof(Point) == sizeof(D2D1_POINT_2F), "points are passed to Direct2D as they are");
+
+	static D2D1_COLOR_F ToD2d(const Color& color)
+	{
+		return D2D1::ColorF(color.R, color.G, color.B, color.A);
+	}
+
+	static D2D1_POINT_2F ToD2d(const Point& point)
+	{
+		return D2D1::Point2F(point.X, point.Y);
+	}
+
+	D2dCanvas::D2dCanvas(ComPtr<ID2D1DeviceContext> context)
+		: context(context)
+	{
+		this->context->GetFactory(this->factory.ReleaseAndGetAddressOf());
+		OKE(this->context->CreateSolidColorBrush(D2D1::ColorF(0.0f, 0.0f, 0.0f, 0.0f), this->solid.ReleaseAndGetAddressOf()));
+
+		// Flat ends and beveled joins, the outline CpuCanvas strokes
+		OKE(this->factory->CreateStrokeStyle(
+			D2D1::StrokeStyleProperties(D2D1_CAP_STYLE_FLAT, D2D1_CAP_STYLE_FLAT, D2D1_CAP_STYLE_FLAT, D2D1_LINE_JOIN_BEVEL),
+			nullptr,
+			0,
+			this->stroke.ReleaseAndGetAddressOf()));
+	}
+
+	void D2dCanvas::Begin()
+	{
+		this->context->BeginDraw();
+	}
+
+	void D2dCanvas::End()
+	{
+		GUARD(this->context->EndDraw(), result)
+		{
+			TRACE("failed to end drawing: " << std::hex << result);
+		}
+	}
+
+	void D2dCanvas::Clear(const Color& color)
+	{
+		this->context->Clear(ToD2d(color));
+	}
+
+	void D2dCanvas::FillRectangle(const Rect& rect, const Paint& paint)
+	{
+		this->context->FillRectangle(D2D1::RectF(rect.Left, rect.Top, rect.Right, rect.Bottom), this->Brush(paint).Get());
+	}
+
+	void D2dCanvas::DrawLine(const Point& from, const Point& to, const Paint& paint, float width)
+	{
+		this->context->DrawLine(ToD2d(from), ToD2d(to), this->Brush(paint).Get(), width, this->stroke.Get());
+	}
+
+	void D2dCanvas::FillFigure(const Figure& figure, const Paint& paint)
+	{
+		this->context->FillGeometry(this->Geometry(figure).Get(), this->Brush(paint).Get());
+	}
+
+	void D2dCanvas::DrawFigure(const Figure& figure, const Paint& paint, float width)
+	{
+		this->context->DrawGeometry(this->Geometry(figure).Get(), this->Brush(paint).Get(), width, this->stroke.Get());
+	}
+
+	ComPtr<ID2D1Brush> D2dCanvas::Brush(const Paint& paint)
+	{
+		if (!paint.Gradient())
+		{
+			this->solid->SetColor(ToD2d(paint.SolidColor()));
+			return this->solid;
+		}
+
+		std::vector<D2D1_GRADIENT_STOP> stops;
+		stops.reserve(paint.Stops().size());
+		for (const GradientStop& stop : paint.Stops())
+		{
+			stops.push_back(D2D1::GradientStop(stop.Position, ToD2d(stop.Color)));
+		}
+
+		// Blend premultiplied colors as they're stored, clamping past the ends, the way CpuCanvas does
+		ComPtr<ID2D1GradientStopCollection1> collection;
+		OKE(this->context->CreateGradientStopCollection(
+			stops.data(),
+			static_cast<UINT32>(stops.size()),
+			D2D1_COLOR_SPACE_SRGB,
+			D2D1_COLOR_SPACE_SRGB,
+			D2D1_BUFFER_PRECISION_8BPC_UNORM,
+			D2D1_EXTEND_MODE_CLAMP,
+			D2D1_COLOR_INTERPOLATION_MODE_PREMULTIPLIED,
+			collection.ReleaseAndGetAddressOf()));
+
+		ComPtr<ID2D1LinearGradientBrush> brush;
+		OKE(this->context->CreateLinearGradientBrush(
+			D2D1::LinearGradientBrushProperties(ToD2d(paint.Start()), ToD2d(paint.End())),
+			collection.Get(),
+			brush.ReleaseAndGetAddressOf()));
+		return brush;
+	}
+
+	ComPtr<ID2D1PathGeometry> D2dCanvas::Geometry(const Figure& figure)
+	{
+		ComPtr<ID2D1PathGeometry> geometry;
+		OKE(this->factory->CreatePathGeometry(geometry.ReleaseAndGetAddressOf()));
+
+		ComPtr<ID2D1GeometrySink> sink;
+		OKE(geometry->Open(sink.ReleaseAndGetAddressOf()));
+		sink->SetFillMode(figure.Rule() == FillRule::NonZero ? D2D1_FILL_MODE_WINDING : D2D1_FILL_MODE_ALTERNATE);
+		for (const Figure::Contour& contour : figure.Contours())
+		{
+			// Curves were flattened as they were added, so both backends see the same lines
+			const std::vector<Point>& points = contour.Points;
+			sink->BeginFigure(ToD2d(points.front()), D2D1_FIGURE_BEGIN_FILLED);
+			sink->AddLines(reinterpret_cast<const D2D1_POINT_2F*>(points.data() + 1), static_cast<UINT32>(points.size() - 1));
+			sink->EndFigure(contour.Closed ? D2D1_FIGURE_END_CLOSED : D2D1_FIGURE_END_OPEN);
+		}
+		OKE(sink->Close());
+
+		return geometry;
+	}
+}
@@ -10,6 +10,7 @@ namespace Dance::Two
 		OKE(this->d2dDevice->CreateDeviceContext(
 			D2D1_DEVICE_CONTEXT_OPTIONS_NONE,
 			this->d2dDeviceContext.ReleaseAndGetAddressOf()));
+		this->canvas = std::make_unique<D2dCanvas>(this->d2dDeviceContext);
 	}
 
 	HRESULT TwoVisualizer::CreateSurface()
@@ -6,18 +6,21 @@
 #include <cmath>
 #include <filesystem>
 
-#include "AudioVisualizer.h"
 #include "TwoVisualizer.h"
+#include "Macro.h"
 
 #define SMOOTHING 10
 
 using Dance::API::Visualizer;
 using Dance::Two::TwoVisualizer;
-using Dance::Audio::AudioVisualizer;
+using Dance::Two::Canvas;
+using Dance::Two::Color;
+using Dance::Two::Paint;
+using Dance::Two::Rect;
 
 static std::filesystem::path DllPath;
 
-class BarsVisualizer : public TwoVisualizer, public AudioVisualizer
+class BarsVisualizer : public TwoVisualizer
 {
 public:
 	BarsVisualizer(const Visualizer::Dependencies& dependencies);
@@ -29,6 +32,9 @@ public:
 	virtual void Update(double delta);
 
 protected:
+	// Spectrum analyzed by the host, shared with any other visualizers
+	const DanceFeatures* features;
+
 	RECT size;
 	size_t barCount;
 	size_t sampleStart;
@@ -37,6 +43,4 @@ protected:
 
 	std::vector<std::array<float, SMOOTHING>> levels;
 	size_t levelIndex = 0;
-
-	ComPtr<ID2D1SolidColorBrush> brush;
 };
@@ -3,46 +3,8 @@
 
 using Vertex = SimpleVertex::Structure;
 
-const static Vertex VERTICES[] = {
-	{ Vector3F(-0.5f, -0.5f, -0.5f), Vector3F(0, 0, -1.0f), Color4F(0.0f, 1.0f, 1.0f, 1.0f), { 0.0f, 0.0f } },
-	{ Vector3F(-0.5f, 0.5f, -0.5f), Vector3F(0, 0, -1.0f), Color4F(0.0f, 1.0f, 1.0f, 1.0f), { 0.0f, 1.0f } },
-	{ Vector3F(0.5f, 0.5f, -0.5f), Vector3F(0, 0, -1.0f), Color4F(0.0f, 1.0f, 1.0f, 1.0f), { 1.0f, 1.0f } },
-	{ Vector3F(0.5f, -0.5f, -0.5f), Vector3F(0, 0, -1.0f), Color4F(0.0f, 1.0f, 1.0f, 1.0f), { 1.0f, 0.0f } },
-
-	{ Vector3F(-0.5f, -0.5f, 0.5f), Vector3F(0, 0, 1.0f), Color4F(1.0f, 0.0f, 0.0f, 1.0f), { 0.0f, 0.0f } },
-	{ Vector3F(-0.5f, 0.5f, 0.5f), Vector3F(0, 0, 1.0f), Color4F(1.0f, 0.0f, 0.0f, 1.0f), { 0.0f, 1.0f } },
-	{ Vector3F(0.5f, 0.5f, 0.5f), Vector3F(0, 0, 1.0f), Color4F(1.0f, 0.0f, 0.0f, 1.0f), { 1.0f, 1.0f } },
-	{ Vector3F(0.5f, -0.5f, 0.5f), Vector3F(0, 0, 1.0f), Color4F(1.0f, 0.0f, 0.0f, 1.0f), { 1.0f, 0.0f } },
-
-	{ Vector3F(-0.5f, 0.5f, -0.5f), Vector3F(0, 1.0f, 0), Color4F(1.0f, 0.0f, 1.0f, 1.0f), { 0.0f, 0.0f } },
-	{ Vector3F(-0.5f, 0.5f, 0.5f), Vector3F(0, 1.0f, 0), Color4F(1.0f, 0.0f, 1.0f, 1.0f), { 0.0f, 1.0f } },
-	{ Vector3F(0.5f, 0.5f, 0.5f), Vector3F(0, 1.0f, 0), Color4F(1.0f, 0.0f, 1.0f, 1.0f), { 1.0f, 1.0f } },
-	{ Vector3F(0.5f, 0.5f, -0.5f), Vector3F(0, 1.0f, 0), Color4F(1.0f, 0.0f, 1.0f, 1.0f), { 1.0f, 0.0f } },
-
-	{ Vector3F(-0.5f, -0.5f, -0.5f), Vector3F(0, -1.0f, 0), Color4F(0.0f, 1.0f, 0.0f, 1.0f), { 0.0f, 0.0f } },
-	{ Vector3F(-0.5f, -0.5f, 0.5f), Vector3F(0, -1.0f, 0), Color4F(0.0f, 1.0f, 0.0f, 1.0f), { 0.0f, 1.0f } },
-	{ Vector3F(0.5f, -0.5f, 0.5f), Vector3F(0, -1.0f, 0), Color4F(0.0f, 1.0f, 0.0f, 1.0f), { 1.0f, 1.0f } },
-	{ Vector3F(0.5f, -0.5f, -0.5f), Vector3F(0, -1.0f, 0), Color4F(0.0f, 1.0f, 0.0f, 1.0f), { 1.0f, 0.0f } },
-
-	{ Vector3F(-0.5f, -0.5f, -0.5f), Vector3F(-1.0f, 0, 0), Color4F(0.0f, 0.0f, 1.0f, 1.0f), { 0.0f, 0.0f } },
-	{ Vector3F(-0.5f, -0.5f, 0.5f), Vector3F(-1.0f, 0, 0), Color4F(0.0f, 0.0f, 1.0f, 1.0f), { 0.0f, 1.0f } },
-	{ Vector3F(-0.5f, 0.5f, 0.5f), Vector3F(-1.0f, 0, 0), Color4F(0.0f, 0.0f, 1.0f, 1.0f), { 1.0f, 1.0f } },
-	{ Vector3F(-0.5f, 0.5f, -0.5f), Vector3F(-1.0f, 0, 0), Color4F(0.0f, 0.0f, 1.0f, 1.0f), { 1.0f, 0.0f } },
-
-	{ Vector3F(0.5f, -0.5f, -0.5f), Vector3F(1.0f, 0, 0), Color4F(1.0f, 1.0f, 0.0f, 1.0f), { 0.0f, 0.0f } },
-	{ Vector3F(0.5f, -0.5f, 0.5f), Vector3F(1.0f, 0, 0), Color4F(1.0f, 1.0f, 0.0f, 1.0f), { 0.0f, 1.0f } },
-	{ Vector3F(0.5f, 0.5f, 0.5f), Vector3F(1.0f, 0, 0), Color4F(1.0f, 1.0f, 0.0f, 1.0f), { 1.0f, 1.0f } },
-	{ Vector3F(0.5f, 0.5f, -0.5f), Vector3F(1.0f, 0, 0), Color4F(1.0f, 1.0f, 0.0f, 1.0f), { 1.0f, 0.0f } },
-};
-
-const static uint16_t INDICES[] = {
-	2 , 0 , 1 , 3 , 0 , 2 ,
-	6 , 5 , 4 , 7 , 6 , 4 ,
-	10, 8 , 9 , 11, 8 , 10,
-	14, 13, 12, 15, 14, 12,
-	18, 16, 17, 19, 16, 18,
-	22, 21, 20, 23, 22, 20,
-};
+// Generated by the compiler and emitted as read-only data, so nothing runs when the plugin loads
+constexpr static auto CUBE = CubeMesh();
 
 Cube::Cube() : Renderable() 
 {
@@ -51,8 +13,12 @@ Cube::Cube() : Renderable()
 
 Cube::Cube(ComPtr<ID3D11Device> device, const std::wstring& shaderPath) : Renderable(device)
 {
-	this->vertices = IndexedVertexBuffer(device, lengthof(VERTICES), VERTICES, lengthof(INDICES), INDICES);
+	this->vertices = IndexedVertexBuffer(device, CUBE.vertices.size(), CUBE.vertices.data(), CUBE.indices.size(), CUBE.indices.data());
 	this->shader = Shader(device, shaderPath.c_str(), SimpleVertex::LAYOUT, lengthof(SimpleVertex::LAYOUT));
+	for (const Vertex& vertex : CUBE.vertices)
+	{
+		this->bounds.Include(vertex.Position);
+	}
 }
 
 CubeVisualizer::CubeVisualizer(const Visualizer::Dependencies& dependencies)
@@ -62,7 +28,7 @@ CubeVisualizer::CubeVisualizer(const Visualizer::Dependencies& dependencies)
 {
 	this->d3dDeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 	this->cube = Cube(this->d3dDevice, (DllPath.parent_path() / "Shader" / "Mesh.hlsl").wstring());
-	this->camera = Camera(this->d3dDevice, Matrix4F(), Matrix4F());
+	this->camera = Camera(this->d3dDevice, TaggedMatrix4F(), Matrix4F());
 	this->theta = 0.0f;
 
 	RECT size;
@@ -103,7 +69,10 @@ void CubeVisualizer::Render()
 		this->d3dDepthStencilView.Get());
 
 	this->camera.Activate(CONSTANT_BUFFER_CAMERA);
-	this->cube.Render(CONSTANT_BUFFER_RENDERABLE);
+	if (this->cube.Visible(this->camera.Frustum()))
+	{
+		this->cube.Render(CONSTANT_BUFFER_RENDERABLE);
+	}
 	this->dxgiSwapChain->Present(1, 0);
 }
 
@@ -119,10 +88,29 @@ void CubeVisualizer::Update(double delta)
 	}
 
 	this->theta += delta;
-	this->cube.Transform() = Matrix4F::Scale(200.0f * level + 100.0f)
-		* Matrix4F::YRotation(this->theta)
-		* Matrix4F::XRotation(0.45f * this->theta)
-		* Matrix4F::ZRotation(0.85f * this->theta);
+
+	// Same as Scale * YRotation * XRotation * ZRotation, but composed as quaternions and expanded into a matrix once
+	const QuaternionF rotation = Concatenate(
+		Concatenate(
+			QuaternionF(Vector3F(0.0f, 1.0f, 0.0f), this->theta),
+			QuaternionF(Vector3F(1.0f, 0.0f, 0.0f), 0.45f * this->theta)),
+		QuaternionF(Vector3F(0.0f, 0.0f, 1.0f), 0.85f * this->theta));
+	this->cube.Transform() = TransformationF(Vector3F(), rotation, 200.0f * level + 100.0f).Matrix();
+}
+
+std::vector<uint8_t> CubeVisualizer::Serialize() const
+{
+	const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&this->theta);
+	return std::vector<uint8_t>(bytes, bytes + sizeof(this->theta));
+}
+
+void CubeVisualizer::Restore(const std::vector<uint8_t>& state)
+{
+	// Ignore state from an incompatible build
+	if (state.size() == sizeof(this->theta))
+	{
+		memcpy(&this->theta, state.data(), sizeof(this->theta));
+	}
 }
 
 HRESULT CubeVisualizer::SetViewport(const RECT& size)
@@ -150,7 +138,7 @@ HRESULT CubeVisualizer::SetProjection(const RECT& size)
 			(FLOAT)(size.bottom - size.top),
 			25.0f,
 			10000.0f);
-	this->camera.WorldToCamera = Matrix4F::Translation(Vector3(500.0f, 0.0f, 0.0f));
+	this->camera.WorldToCamera = TaggedMatrix4F::Translation(Vector3(500.0f, 0.0f, 0.0f));
 	return S_OK;
 }
 
@@ -3,6 +3,7 @@
 #include "Renderable.h"
 #include "Buffer.h"
 #include "Primitive.h"
+#include "Geometry.h"
 #include "Shader.h"
 #include "Camera.h"
 #include "Mathematics.h"
@@ -43,6 +44,9 @@ public:
 	virtual void Render();
 	virtual void Update(double delta);
 
+	virtual std::vector<uint8_t> Serialize() const;
+	virtual void Restore(const std::vector<uint8_t>& state);
+
 protected:
 	RECT size;
 	Cube cube;
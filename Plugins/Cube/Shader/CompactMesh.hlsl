@@ -0,0 +1,44 @@
+#include "Constants.hlsl"
+
+// Matches CompactVertex::LAYOUT, where the input assembler has already expanded the half floats and bytes
+struct VIn
+{
+    float2 normal : NORMAL0;
+    float4 color : COLOR0;
+    float4 position : POSITION0;
+    float2 textureUV : TEXCOORD0;
+};
+
+struct VOut
+{
+    float4 position : SV_POSITION;
+    float4 color : COLOR0;
+    float2 textureUV : TEXCOORD0;
+    float4 normal : NORMAL0;
+    float4 worldPosition : TEXCOORD1;
+};
+
+// Inverse of Math::ToOctahedral, unfolding the lower hemisphere back off the corners of the square
+float3 Octahedral(float2 folded)
+{
+    float3 normal = float3(folded, 1.0 - abs(folded.x) - abs(folded.y));
+    float t = saturate(-normal.z);
+    normal.xy += (normal.xy >= 0.0) ? -t : t;
+    return normalize(normal);
+}
+
+VOut VS(VIn vIn)
+{
+    VOut output;
+    output.worldPosition = mul(float4(vIn.position.xyz, 1.0), c_modelToWorld);
+    output.position = mul(output.worldPosition, c_viewProj);
+    output.normal = mul(float4(Octahedral(vIn.normal), 0.0), c_modelToWorld);
+    output.color = vIn.color;
+    output.textureUV = vIn.textureUV;
+    return output;
+}
+
+float4 PS(VOut pIn) : SV_TARGET
+{
+    return pIn.color;
+}
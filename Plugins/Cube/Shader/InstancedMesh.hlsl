@@ -0,0 +1,42 @@
+#include "Constants.hlsl"
+
+struct VIn
+{
+    float3 position : POSITION0;
+    float3 normal : NORMAL0;
+    float4 color : COLOR0;
+    float2 textureUV : TEXCOORD0;
+    float4 world0 : WORLD0;
+    float4 world1 : WORLD1;
+    float4 world2 : WORLD2;
+    float4 world3 : WORLD3;
+    float4 tint : COLOR1;
+};
+
+struct VOut
+{
+    float4 position : SV_POSITION;
+    float4 color : COLOR0;
+    float2 textureUV : TEXCOORD0;
+    float4 normal : NORMAL0;
+    float4 worldPosition : TEXCOORD1;
+};
+
+VOut VS(VIn vIn)
+{
+    // The per-instance transform arrives as its four rows, which are the rows of the matrix under row_major packing
+    float4x4 modelToWorld = float4x4(vIn.world0, vIn.world1, vIn.world2, vIn.world3);
+
+    VOut output;
+    output.worldPosition = mul(float4(vIn.position, 1.0), modelToWorld);
+    output.position = mul(output.worldPosition, c_viewProj);
+    output.normal = mul(float4(vIn.normal, 0.0), modelToWorld);
+    output.color = vIn.color * vIn.tint;
+    output.textureUV = vIn.textureUV;
+    return output;
+}
+
+float4 PS(VOut pIn) : SV_TARGET
+{
+    return pIn.color;
+}
@@ -1,3 +1,5 @@
+#pragma once
+
 #include <stdexcept>
 #include <string>
 #include <winnt.h>
@@ -13,6 +15,11 @@ public:
         : result(result)
         , std::runtime_error(what) {}
 
+    HRESULT Result() const
+    {
+        return this->result;
+    }
+
 private:
     const HRESULT result;
 };
@@ -0,0 +1,174 @@
+#pragma once
+
+// The plugin ABI. Everything that crosses the boundary between the runtime and a plugin built against this header is
+// a plain C struct, a function pointer, or a COM interface, so plugins are free to use a different compiler, runtime
+// library, or language than the executable. Visualizer.h layers the C++ convenience API on top of it.
+//
+// Versioning follows the usual rules: the major version changes when a struct or signature changes incompatibly, and
+// the minor version changes when fields are appended. Every struct leads with its size so that either side can tell
+// which fields the other was built with.
+
+#include "Options.h"
+
+#include <windows.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#define DANCE_ABI_MAJOR 1
+#define DANCE_ABI_MINOR 1
+
+#ifdef __cplusplus
+struct ID3D11Device;
+struct IDXGIDevice;
+struct IDXGISwapChain1;
+struct ID2D1Device1;
+extern "C" {
+#else
+typedef struct ID3D11Device ID3D11Device;
+typedef struct IDXGIDevice IDXGIDevice;
+typedef struct IDXGISwapChain1 IDXGISwapChain1;
+typedef struct ID2D1Device1 ID2D1Device1;
+#endif
+
+/// Version triple exchanged between the runtime and its plugins.
+typedef struct DanceVersion
+{
+    uint16_t Major;
+    uint16_t Minor;
+    uint32_t Patch;
+} DanceVersion;
+
+/// What the runtime reports about itself via _Dance.
+typedef struct DanceAbout
+{
+    /// The plugin ABI the runtime implements.
+    DanceVersion Version;
+} DanceAbout;
+
+/// Audio features computed once per frame by the runtime and shared read-only with every visualizer. The block and
+/// the arrays it points to are owned by the runtime and stay at the same address for the lifetime of a visualizer, so
+/// plugins may hold onto the pointer, but the contents are only consistent for the duration of an Update call.
+typedef struct DanceFeatures
+{
+    /// sizeof(DanceFeatures) as compiled into the runtime.
+    uint32_t Size;
+
+    /// Incremented every time the features are recomputed.
+    uint64_t Frame;
+
+    /// Sample rate of the analyzed audio in frames per second.
+    uint32_t SampleRate;
+
+    /// Number of linearly spaced bins in Spectrum, from 0 Hz up to the Nyquist frequency.
+    uint32_t SpectrumSize;
+
+    /// FFT magnitudes, each divided by SpectrumSize.
+    const float* Spectrum;
+
+    /// Number of logarithmically spaced bands in Bands.
+    uint32_t BandCount;
+
+    /// Mean spectrum magnitude within each band, from the lowest frequency band to the highest.
+    const float* Bands;
+
+    /// Root mean square of the samples in the analysis window.
+    float Level;
+
+    /// Largest absolute sample in the analysis window.
+    float Peak;
+} DanceFeatures;
+
+/// Graphics resources a visualizer renders with. Interfaces are borrowed, so a visualizer that keeps one must AddRef.
+typedef struct DanceDependencies
+{
+    /// sizeof(DanceDependencies) as compiled into the runtime.
+    uint32_t Size;
+
+    HINSTANCE Instance;
+    HWND Window;
+    ID3D11Device* D3dDevice;
+    IDXGIDevice* DxgiDevice;
+    IDXGISwapChain1* DxgiSwapChain;
+    ID2D1Device1* D2dDevice;
+
+    /// The shared feature block, or null if the runtime isn't analyzing audio.
+    const DanceFeatures* Features;
+} DanceDependencies;
+
+/// Function table implementing a visualizer. The opaque pointer returned by Create is passed back to every other
+/// entry. None of these may let an exception escape; entries that can't return an HRESULT report failure through
+/// Failure instead.
+typedef struct DanceVisualizerTable
+{
+    /// sizeof(DanceVisualizerTable) as compiled into the plugin.
+    uint32_t Size;
+
+    /// Construct a visualizer, returning null on failure.
+    void* (*Create)(const DanceDependencies* dependencies);
+
+    /// Destroy a visualizer returned by Create.
+    void (*Destroy)(void* visualizer);
+
+    /// Release size-dependent resources before the swap chain is resized.
+    HRESULT (*Unsize)(void* visualizer);
+
+    /// Reallocate size-dependent resources after the swap chain is resized.
+    HRESULT (*Resize)(void* visualizer, const RECT* size);
+
+    /// Advance the visualizer by delta seconds. The features are the same block passed in the dependencies.
+    void (*Update)(void* visualizer, double delta, const DanceFeatures* features);
+
+    /// Draw and present a frame.
+    void (*Render)(void* visualizer);
+
+    /// Optionally write state to carry across a hot reload. Returns the number of bytes needed, writing them only if
+    /// they fit in capacity. May be null.
+    size_t (*Serialize)(const void* visualizer, uint8_t* data, size_t capacity);
+
+    /// Optionally restore state written by Serialize in the previous build of the plugin. May be null.
+    void (*Restore)(void* visualizer, const uint8_t* data, size_t size);
+
+    /// Report why an Update, Render, or Restore call has failed since the last time this was called, and forget it.
+    /// Returns S_OK if none did. Added in 1.1; may be null, in which case those calls are assumed to succeed.
+    HRESULT (*Failure)(void* visualizer);
+} DanceVisualizerTable;
+
+/// A visualizer registration, passed to the runtime's _RegisterTable export.
+typedef struct DancePlugin
+{
+    /// sizeof(DancePlugin) as compiled into the plugin.
+    uint32_t Size;
+
+    /// The ABI the plugin was built against.
+    DanceVersion Version;
+
+    /// The user-facing name of the visualizer. Copied by the runtime.
+    const wchar_t* Name;
+
+    /// Entry points of the visualizer. Must outlive the plugin module's registration, so it's typically static.
+    const DanceVisualizerTable* Table;
+} DancePlugin;
+
+typedef DanceAbout (__cdecl DanceAboutFunction)(void);
+typedef int32_t (__cdecl DanceRegisterTableFunction)(const DancePlugin* plugin);
+
+/// Check that the runtime speaks a compatible ABI and register a visualizer with it. Safe to call from DllMain.
+///
+/// @param plugin describes the visualizer to register.
+/// @returns nonzero if the runtime accepted the registration.
+static inline int32_t DanceRegister(const DancePlugin* plugin)
+{
+    HMODULE runtime = GetModuleHandleW(NULL);
+    DanceAboutFunction* about = (DanceAboutFunction*)GetProcAddress(runtime, "_Dance");
+    DanceRegisterTableFunction* registerTable = (DanceRegisterTableFunction*)GetProcAddress(runtime, "_RegisterTable");
+    if (about == NULL || registerTable == NULL || about().Version.Major != plugin->Version.Major)
+    {
+        return 0;
+    }
+
+    return registerTable(plugin);
+}
+
+#ifdef __cplusplus
+}
+#endif
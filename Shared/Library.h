@@ -1,19 +1,108 @@
 #pragma once
 
+#include <filesystem>
+#include <string>
+
+#ifdef _WIN32
+
 #define WIN32_LEAN_AND_MEAN
 #define NOMINMAX
 #define NOMCX
 #define NOSERVICE
 #define NOHELP
 
-#include <string>
 #include <windows.h>
 
 namespace Dance::Library
 {
+    /// Platform handle to a loaded dynamic library.
+    using Handle = HMODULE;
+
+    /// Load a dynamic library, running its initialization (DllMain on Windows, constructors elsewhere).
+    ///
+    /// @param path is the path of the library to load.
+    /// @returns a handle to the library or nullptr on failure, in which case Library::Error describes why.
+    static inline Handle Open(const std::filesystem::path& path)
+    {
+        return ::LoadLibraryW(path.wstring().c_str());
+    }
+
+    /// Release a dynamic library opened by Library::Open.
+    ///
+    /// @param library is the handle to release.
+    static inline void Close(Handle library)
+    {
+        ::FreeLibrary(library);
+    }
+
+    /// Describe the last failure of Library::Open or Library::Find on this thread.
+    ///
+    /// @returns a human readable error string.
+    static inline std::string Error()
+    {
+        return "error " + std::to_string(::GetLastError());
+    }
+
+    /// Look up an exported symbol in a loaded library.
+    ///
+    /// @typeparam T is the type of the symbol, typically a function signature.
+    /// @param library is the handle to search.
+    /// @param symbol is the undecorated name of the export.
+    /// @returns a pointer to the symbol or nullptr if it isn't exported.
     template<typename T>
-    static inline T* Find(HMODULE library, const std::string& symbol)
+    static inline T* Find(Handle library, const std::string& symbol)
     {
         return reinterpret_cast<T*>(::GetProcAddress(library, symbol.c_str()));
     }
 }
+
+#else
+
+#include <dlfcn.h>
+
+namespace Dance::Library
+{
+    /// Platform handle to a loaded dynamic library.
+    using Handle = void*;
+
+    /// Load a dynamic library, running its initialization (DllMain on Windows, constructors elsewhere). Symbols are
+    /// resolved immediately and kept local so that plugins can't clash with one another.
+    ///
+    /// @param path is the path of the library to load.
+    /// @returns a handle to the library or nullptr on failure, in which case Library::Error describes why.
+    static inline Handle Open(const std::filesystem::path& path)
+    {
+        return ::dlopen(path.string().c_str(), RTLD_NOW | RTLD_LOCAL);
+    }
+
+    /// Release a dynamic library opened by Library::Open.
+    ///
+    /// @param library is the handle to release.
+    static inline void Close(Handle library)
+    {
+        ::dlclose(library);
+    }
+
+    /// Describe the last failure of Library::Open or Library::Find on this thread.
+    ///
+    /// @returns a human readable error string.
+    static inline std::string Error()
+    {
+        const char* error = ::dlerror();
+        return error != nullptr ? error : "unknown error";
+    }
+
+    /// Look up an exported symbol in a loaded library.
+    ///
+    /// @typeparam T is the type of the symbol, typically a function signature.
+    /// @param library is the handle to search.
+    /// @param symbol is the undecorated name of the export.
+    /// @returns a pointer to the symbol or nullptr if it isn't exported.
+    template<typename T>
+    static inline T* Find(Handle library, const std::string& symbol)
+    {
+        return reinterpret_cast<T*>(::dlsym(library, symbol.c_str()));
+    }
+}
+
+#endif
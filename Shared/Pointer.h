@@ -31,3 +31,27 @@ struct LibraryDeleter
 };
 
 using LibraryHandle = std::unique_ptr<HINSTANCE__, LibraryDeleter>;
+
+/// Deletion struct for a kernel object handle, e.g. an event, process, or file mapping.
+struct KernelDeleter
+{
+	using pointer = HANDLE;
+
+	void operator()(HANDLE handle) const
+	{
+		::CloseHandle(handle);
+	}
+};
+
+using KernelHandle = std::unique_ptr<void, KernelDeleter>;
+
+/// Deletion struct for a view of a file mapping.
+struct ViewDeleter
+{
+	void operator()(void* view) const
+	{
+		::UnmapViewOfFile(view);
+	}
+};
+
+using MappedView = std::unique_ptr<void, ViewDeleter>;
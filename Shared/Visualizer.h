@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Options.h"
+#include "Interface.h"
+#include "Exception.h"
 
 #include <windows.h>
 #include <wrl.h>
@@ -9,7 +11,13 @@
 #include <d2d1_2.h>
 
 #include <string>
+#include <vector>
 #include <functional>
+#include <memory>
+#include <new>
+#include <utility>
+#include <cstdint>
+#include <algorithm>
 
 namespace Dance::API
 {
@@ -28,6 +36,16 @@ namespace Dance::API
             Microsoft::WRL::ComPtr<IDXGIDevice> DxgiDevice;
             Microsoft::WRL::ComPtr<IDXGISwapChain1> DxgiSwapChain;
             Microsoft::WRL::ComPtr<ID2D1Device1> D2dDevice;
+
+            // Optional stand-in for loopback capture, provided by headless hosts. When set, audio visualizers read
+            // interleaved stereo float frames at AudioSampleRate from here instead of opening the output device. The
+            // callback points frames at the audio received since the last call and returns the number of frames.
+            std::function<size_t(const float*& frames)> AudioSource{};
+            uint32_t AudioSampleRate{ 0 };
+
+            // Audio features shared by the host, only provided to visualizers registered through the C ABI. The
+            // pointer is stable for the lifetime of the visualizer and refreshed before every Update.
+            const DanceFeatures* Features{ nullptr };
         };
 
         // Make destructor virtual for children classes.
@@ -41,6 +59,11 @@ namespace Dance::API
         virtual void Render() = 0;
         virtual void Update(double delta) = 0;
 
+        // Optional state handoff across a hot reload of the plugin binary. The host calls Serialize on the outgoing
+        // visualizer and passes the result to Restore on its replacement, which is built by the freshly loaded module.
+        virtual std::vector<uint8_t> Serialize() const { return {}; }
+        virtual void Restore(const std::vector<uint8_t>& state) {}
+
         // Signatures
         using Constructor = std::function<Visualizer* (const Visualizer::Dependencies&)>;
         using Destructor = std::function<void(Visualizer*)>;
@@ -58,13 +81,134 @@ namespace Dance::API
         }
     };
 
-    struct About
+    // Defined in Interface.h so that it has the same layout on both sides of the C ABI
+    using About = DanceAbout;
+
+    // Adapts a C++ visualizer to the C ABI function table. The visualizer is constructed and destroyed inside the
+    // plugin, so none of the C++ types in Visualizer::Dependencies ever cross the module boundary. Every entry catches
+    // what the visualizer throws, e.g. ComError from OKE, and turns it into an HRESULT.
+    template<typename T>
+    struct Table
     {
-        struct {
-            uint16_t Major;
-            uint16_t Minor;
-            uint32_t Patch;
-        } Version;
+        // The opaque pointer handed to the runtime. Update, Render, and Restore can't return an HRESULT, so they keep
+        // their first failure here until the runtime collects it through Failure.
+        struct Instance
+        {
+            std::unique_ptr<Visualizer> Target;
+            HRESULT Failed{ S_OK };
+        };
+
+        static void* Create(const DanceDependencies* dependencies)
+        {
+            try
+            {
+                Visualizer::Dependencies converted{
+                    dependencies->Instance,
+                    dependencies->Window,
+                    dependencies->D3dDevice,
+                    dependencies->DxgiDevice,
+                    dependencies->DxgiSwapChain,
+                    dependencies->D2dDevice
+                };
+                converted.Features = dependencies->Features;
+                return new Instance{ std::make_unique<T>(converted) };
+            }
+            catch (...)
+            {
+                return nullptr;
+            }
+        }
+
+        static void Destroy(void* instance)
+        {
+            delete static_cast<Instance*>(instance);
+        }
+
+        static HRESULT Unsize(void* instance)
+        {
+            return Guard([instance]() { return static_cast<Instance*>(instance)->Target->Unsize(); });
+        }
+
+        static HRESULT Resize(void* instance, const RECT* size)
+        {
+            return Guard([instance, size]() { return static_cast<Instance*>(instance)->Target->Resize(*size); });
+        }
+
+        // The features are the same block the visualizer was created with and already reads through
+        // Dependencies::Features, so Visualizer::Update doesn't take them again
+        static void Update(void* instance, double delta, const DanceFeatures* features)
+        {
+            Record(instance, Guard([instance, delta]() { static_cast<Instance*>(instance)->Target->Update(delta); return S_OK; }));
+        }
+
+        static void Render(void* instance)
+        {
+            Record(instance, Guard([instance]() { static_cast<Instance*>(instance)->Target->Render(); return S_OK; }));
+        }
+
+        // Nothing is handed off if the visualizer fails to serialize, which is how the runtime treats empty state
+        static size_t Serialize(const void* instance, uint8_t* data, size_t capacity)
+        {
+            size_t size = 0;
+            Guard([instance, data, capacity, &size]()
+            {
+                const std::vector<uint8_t> state = static_cast<const Instance*>(instance)->Target->Serialize();
+                if (state.size() <= capacity)
+                {
+                    std::copy(state.begin(), state.end(), data);
+                }
+                size = state.size();
+                return S_OK;
+            });
+            return size;
+        }
+
+        static void Restore(void* instance, const uint8_t* data, size_t size)
+        {
+            Record(instance, Guard([instance, data, size]()
+            {
+                static_cast<Instance*>(instance)->Target->Restore(std::vector<uint8_t>(data, data + size));
+                return S_OK;
+            }));
+        }
+
+        static HRESULT Failure(void* instance)
+        {
+            return std::exchange(static_cast<Instance*>(instance)->Failed, S_OK);
+        }
+
+    private:
+        // Call into the visualizer, catching anything it throws
+        template<typename F>
+        static HRESULT Guard(F&& function) noexcept
+        {
+            try
+            {
+                return function();
+            }
+            catch (const ComError& error)
+            {
+                return error.Result();
+            }
+            catch (const std::bad_alloc&)
+            {
+                return E_OUTOFMEMORY;
+            }
+            catch (...)
+            {
+                return E_FAIL;
+            }
+        }
+
+        // Keep the first failure until the runtime asks for it
+        static void Record(void* instance, HRESULT result)
+        {
+            Instance* adapted = static_cast<Instance*>(instance);
+            if (adapted->Failed == S_OK)
+            {
+                adapted->Failed = result;
+            }
+        }
     };
 
     template<typename Return, typename ...Args>
@@ -94,4 +238,32 @@ namespace Dance::API
     {
         Register(name, Visualizer::New<T>, Visualizer::Delete);
     }
+
+    // Register a visualizer through the C ABI, which gives it access to the host's shared feature block. The name
+    // should be a string literal or otherwise outlive the call.
+    template<typename T>
+    static inline bool Export(const wchar_t* name)
+    {
+        static const DanceVisualizerTable table{
+            sizeof(DanceVisualizerTable),
+            &Table<T>::Create,
+            &Table<T>::Destroy,
+            &Table<T>::Unsize,
+            &Table<T>::Resize,
+            &Table<T>::Update,
+            &Table<T>::Render,
+            &Table<T>::Serialize,
+            &Table<T>::Restore,
+            &Table<T>::Failure
+        };
+
+        const DancePlugin plugin{
+            sizeof(DancePlugin),
+            { DANCE_ABI_MAJOR, DANCE_ABI_MINOR, 0 },
+            name,
+            &table
+        };
+
+        return ::DanceRegister(&plugin) != 0;
+    }
 }